@@ -1,7 +1,8 @@
 #include "ExchangeConnectivity.h"
+#include "Logging/Logger.h"
+#include "Telemetry/Clock.h"
 
 #include <chrono>
-#include <iostream>
 #include <sstream>
 #include <stdexcept>
 #include <thread>
@@ -36,7 +37,7 @@ void ExchangeWebsocketClient::Start() {
         try {
             ioc_.run();
         } catch (const std::exception &e) {
-            std::cerr << "IO service error: " << e.what() << std::endl;
+            LOG_ERROR("IO service error: {}", e.what());
             running_.store(false);
         }
     }).detach();
@@ -56,7 +57,7 @@ void ExchangeWebsocketClient::Stop() {
 
 void ExchangeWebsocketClient::OnResolve(beast::error_code ec, tcp::resolver::results_type results) {
     if (ec) {
-        std::cerr << "DNS resolution error: " << ec.message() << std::endl;
+        LOG_ERROR("DNS resolution error: {}", ec.message());
         return;
     }
 
@@ -66,7 +67,7 @@ void ExchangeWebsocketClient::OnResolve(beast::error_code ec, tcp::resolver::res
 
 void ExchangeWebsocketClient::OnConnect(beast::error_code ec, tcp::resolver::results_type::endpoint_type ep) {
     if (ec) {
-        std::cerr << "TCP connection error: " << ec.message() << std::endl;
+        LOG_ERROR("TCP connection error: {}", ec.message());
         return;
     }
 
@@ -76,7 +77,7 @@ void ExchangeWebsocketClient::OnConnect(beast::error_code ec, tcp::resolver::res
 
 void ExchangeWebsocketClient::OnSslHandshake(beast::error_code ec) {
     if (ec) {
-        std::cerr << "SSL handshake error: " << ec.message() << std::endl;
+        LOG_ERROR("SSL handshake error: {}", ec.message());
         return;
     }
 
@@ -87,40 +88,90 @@ void ExchangeWebsocketClient::OnSslHandshake(beast::error_code ec) {
 
 void ExchangeWebsocketClient::OnHandshake(beast::error_code ec) {
     if (ec) {
-        std::cerr << "WebSocket handshake error: " << ec.message() << std::endl;
+        LOG_ERROR("WebSocket handshake error: {}", ec.message());
         return;
     }
 
-    std::cout << "WebSocket connected successfully!" << std::endl;
+    LOG_INFO("WebSocket connected successfully!");
 
     // Create subscription request (both book and trade)
     auto subscription_request = CreateSubscriptionRequest(/* book */ true, /* trade */ true);
     std::string subscription_json = subscription_request.to_string();
 
-    std::cout << "Sending subscription: " << subscription_json << std::endl;
+    LOG_INFO("Sending subscription: {}", subscription_json);
 
-    ws_->async_write(net::buffer(subscription_json), [this](beast::error_code ec, std::size_t) {
-        if (!ec) {
-            std::cout << "Subscription sent!" << std::endl;
-            ws_->async_read(buffer_, beast::bind_front_handler(&ExchangeWebsocketClient::OnRead, this));
-        } else {
-            std::cerr << "Failed to send subscription: " << ec.message() << std::endl;
+    connected_ = true;
+    QueueWrite(std::move(subscription_json));
+    ws_->async_read(buffer_, beast::bind_front_handler(&ExchangeWebsocketClient::OnRead, this));
+}
+
+void ExchangeWebsocketClient::RequestSnapshot(const std::string &instrument) {
+    net::post(ioc_, [this, instrument]() {
+        if (!connected_) {
+            // The initial subscription will deliver a snapshot anyway
+            return;
         }
+
+        LOG_INFO("Requesting book snapshot for {}", instrument);
+
+        ExchangeTypes::SubscriptionRequest unsubscribe;
+        unsubscribe.id = next_request_id_++;
+        unsubscribe.method = "unsubscribe";
+        unsubscribe.params.channels.push_back(BookChannel(instrument));
+        QueueWrite(unsubscribe.to_string());
+
+        ExchangeTypes::SubscriptionRequest subscribe;
+        subscribe.id = next_request_id_++;
+        subscribe.method = "subscribe";
+        subscribe.params.channels.push_back(BookChannel(instrument));
+        subscribe.params.book_subscription_type = "SNAPSHOT_AND_UPDATE";
+        subscribe.params.book_update_frequency = 10;
+        QueueWrite(subscribe.to_string());
     });
 }
 
+void ExchangeWebsocketClient::QueueWrite(std::string message) {
+    write_queue_.push_back(std::move(message));
+    if (write_queue_.size() == 1) {
+        DoWrite();
+    }
+}
+
+void ExchangeWebsocketClient::DoWrite() {
+    ws_->async_write(net::buffer(write_queue_.front()), beast::bind_front_handler(&ExchangeWebsocketClient::OnWrite, this));
+}
+
+void ExchangeWebsocketClient::OnWrite(beast::error_code ec, std::size_t bytes_transferred) {
+    boost::ignore_unused(bytes_transferred);
+
+    if (ec) {
+        LOG_ERROR("Failed to send request: {}", ec.message());
+        write_queue_.clear();
+        return;
+    }
+
+    write_queue_.pop_front();
+    if (!write_queue_.empty()) {
+        DoWrite();
+    }
+}
+
 void ExchangeWebsocketClient::OnRead(beast::error_code ec, std::size_t bytes_transferred) {
+    uint64_t receive_ns = Telemetry::NowNanos();
     boost::ignore_unused(bytes_transferred);
 
     if (ec) {
         if (ec != websocket::error::closed) {
-            std::cerr << "Read error: " << ec.message() << std::endl;
+            LOG_ERROR("Read error: {}", ec.message());
         }
         return;
     }
 
-    std::string msg = beast::buffers_to_string(buffer_.data());
-    std::cout << "Received: " << msg << std::endl;
+    std::string_view msg(static_cast<const char *>(buffer_.data().data()), buffer_.size());
+    LOG_DEBUG("Received: {}", msg);
+    if (message_callback_) {
+        message_callback_(msg, receive_ns);
+    }
 
     buffer_.consume(buffer_.size());
 
@@ -136,7 +187,7 @@ ExchangeTypes::SubscriptionRequest ExchangeWebsocketClient::CreateSubscriptionRe
 
     for (const auto &ticker : tickers_) {
         if (include_book) {
-            request.params.channels.push_back("book." + ticker + ".10");
+            request.params.channels.push_back(BookChannel(ticker));
         }
         if (include_trade) {
             request.params.channels.push_back("trade." + ticker);
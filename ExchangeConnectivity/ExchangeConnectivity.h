@@ -1,8 +1,11 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <boost/beast/core.hpp>
@@ -39,12 +42,32 @@ class ExchangeWebsocketClient {
     void Start();
     void Stop();
 
+    // Asks the exchange for a fresh book snapshot of one instrument by
+    // re-subscribing only its book channel; the other subscriptions are left
+    // alone. Safe to call from any thread (e.g. a FeedProcessing snapshot
+    // request callback).
+    void RequestSnapshot(const std::string &instrument);
+
+    // Invoked on the io_context thread with every received message and its
+    // receipt time (Telemetry::NowNanos()), e.g. to forward it downstream with
+    // IPCSender::SendTimestampedData. The view is only valid during the call.
+    // Set before Start().
+    using MessageCallback = std::function<void(std::string_view message, uint64_t receive_ns)>;
+    void SetMessageCallback(MessageCallback callback) { message_callback_ = std::move(callback); }
+
   private:
     static const std::string HOST;
     static const std::string PORT;
     static const std::string TARGET;
 
     ExchangeTypes::SubscriptionRequest CreateSubscriptionRequest(bool include_book, bool include_trade) const;
+    static std::string BookChannel(const std::string &ticker) { return "book." + ticker + ".10"; }
+
+    // Writes are queued and issued one at a time on the io_context thread,
+    // as a websocket stream allows only one outstanding async_write
+    void QueueWrite(std::string message);
+    void DoWrite();
+    void OnWrite(beast::error_code ec, std::size_t bytes_transferred);
 
     // Async callback handlers
     void OnResolve(beast::error_code ec, tcp::resolver::results_type results);
@@ -60,6 +83,10 @@ class ExchangeWebsocketClient {
     std::unique_ptr<websocket::stream<beast::ssl_stream<beast::tcp_stream>>> ws_;
     beast::flat_buffer buffer_;
     std::atomic<bool> running_{false};
+    bool connected_ = false;
+    std::deque<std::string> write_queue_;
+    int64_t next_request_id_ = 2;
+    MessageCallback message_callback_;
 
     // Subscription data
     std::vector<std::string> tickers_;
@@ -0,0 +1,32 @@
+#include "BboConflator.h"
+
+void BboConflator::Update(ExchangeTypes::InstrumentId id, const OrderbookTypes::BboUpdate &update, uint64_t now) {
+    if (id >= latest_.size()) {
+        latest_.resize(id + 1);
+        pending_since_.resize(id + 1, 0);
+        dirty_.resize(id + 1, false);
+    }
+
+    latest_[id] = update;
+    if (dirty_[id]) {
+        conflated_count_++;
+        return;
+    }
+
+    dirty_[id] = true;
+    pending_since_[id] = now;
+    order_.push_back(id);
+}
+
+void BboConflator::Pop() {
+    dirty_[order_[head_++]] = false;
+
+    // Reclaim the drained prefix once it dominates, keeping Pop O(1) amortized
+    if (head_ == order_.size()) {
+        order_.clear();
+        head_ = 0;
+    } else if (head_ * 2 >= order_.size()) {
+        order_.erase(order_.begin(), order_.begin() + static_cast<std::ptrdiff_t>(head_));
+        head_ = 0;
+    }
+}
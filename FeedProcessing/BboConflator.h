@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Orderbook/OrderbookTypes.h"
+#include "Types/InstrumentRegistry.h"
+
+// Latest-value-wins buffer of BBO updates with one slot per instrument. An
+// update for an instrument that is already waiting overwrites it in place, so
+// a slow consumer is sent each instrument's freshest BBO rather than the
+// backlog. Instruments drain in the order they first became dirty.
+class BboConflator {
+  public:
+    void Update(ExchangeTypes::InstrumentId id, const OrderbookTypes::BboUpdate &update, uint64_t now);
+
+    bool Empty() const { return head_ == order_.size(); }
+    size_t Size() const { return order_.size() - head_; }
+
+    // Oldest dirty instrument; only valid when not Empty()
+    ExchangeTypes::InstrumentId Front() const { return order_[head_]; }
+    const OrderbookTypes::BboUpdate &Get(ExchangeTypes::InstrumentId id) const { return latest_[id]; }
+
+    // When the instrument became dirty, in the clock passed to Update
+    uint64_t GetPendingSince(ExchangeTypes::InstrumentId id) const { return pending_since_[id]; }
+
+    void Pop();
+
+    // Updates overwritten before they were sent
+    uint64_t GetConflatedCount() const { return conflated_count_; }
+
+  private:
+    std::vector<OrderbookTypes::BboUpdate> latest_;
+    std::vector<uint64_t> pending_since_;
+    std::vector<bool> dirty_;
+
+    // FIFO of dirty instruments; each appears at most once
+    std::vector<ExchangeTypes::InstrumentId> order_;
+    size_t head_ = 0;
+
+    uint64_t conflated_count_ = 0;
+};
@@ -0,0 +1,66 @@
+#include "BboConflator.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+OrderbookTypes::BboUpdate make_update(ExchangeTypes::InstrumentId id, double bid, double ask, uint64_t sequence) {
+    OrderbookTypes::BboUpdate update;
+    update.instrument_id = id;
+    update.best_bid = ExchangeTypes::DoubleToDecimal(bid, update.price_decimals);
+    update.best_ask = ExchangeTypes::DoubleToDecimal(ask, update.price_decimals);
+    update.sequence_number = sequence;
+    update.timestamp = sequence;
+    return update;
+}
+
+} // namespace
+
+TEST(BboConflatorTest, KeepsLatestUpdatePerInstrument) {
+    BboConflator conflator;
+    EXPECT_TRUE(conflator.Empty());
+
+    conflator.Update(3, make_update(3, 2499.0, 2501.0, 1), 100);
+    conflator.Update(0, make_update(0, 49999.0, 50001.0, 2), 110);
+    conflator.Update(3, make_update(3, 2499.5, 2500.5, 3), 120);
+
+    EXPECT_EQ(conflator.Size(), 2);
+    EXPECT_EQ(conflator.GetConflatedCount(), 1);
+
+    // Instruments drain in the order they first became dirty, with their latest BBO
+    ASSERT_EQ(conflator.Front(), 3);
+    EXPECT_EQ(conflator.Get(3).sequence_number, 3);
+    EXPECT_EQ(conflator.Get(3).GetBestBid(), 2499.5);
+    EXPECT_EQ(conflator.GetPendingSince(3), 100);
+    conflator.Pop();
+
+    ASSERT_EQ(conflator.Front(), 0);
+    EXPECT_EQ(conflator.Get(0).sequence_number, 2);
+    conflator.Pop();
+    EXPECT_TRUE(conflator.Empty());
+
+    // A sent instrument is dirty again on its next update
+    conflator.Update(3, make_update(3, 2500.0, 2501.0, 4), 130);
+    EXPECT_EQ(conflator.Size(), 1);
+    EXPECT_EQ(conflator.GetPendingSince(3), 130);
+    EXPECT_EQ(conflator.GetConflatedCount(), 1);
+}
+
+TEST(BboConflatorTest, InterleavedUpdatesAndPopsKeepFifoOrder) {
+    BboConflator conflator;
+    uint64_t sequence = 0;
+
+    // Keep a backlog of three instruments while cycling through them
+    for (ExchangeTypes::InstrumentId id = 0; id < 3; ++id) {
+        sequence++;
+        conflator.Update(id, make_update(id, 1.0, 2.0, sequence), sequence);
+    }
+    for (int round = 0; round < 1000; ++round) {
+        ExchangeTypes::InstrumentId id = conflator.Front();
+        EXPECT_EQ(id, static_cast<ExchangeTypes::InstrumentId>(round % 3));
+        conflator.Pop();
+        sequence++;
+        conflator.Update(id, make_update(id, 1.0, 2.0, sequence), sequence);
+        EXPECT_EQ(conflator.Size(), 3);
+    }
+    EXPECT_EQ(conflator.GetConflatedCount(), 0);
+}
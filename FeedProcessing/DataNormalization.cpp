@@ -1,386 +1,446 @@
 #include "DataNormalization.h"
+#include "Logging/Logger.h"
+#include "PerfectHash.h"
 #include <cstring>
-#include <iostream>
-
-DataNormalization::DataNormalization() {}
-
-ExchangeTypes::MessageBuffer DataNormalization::ParseExchangeMessage(const std::string &json_str) {
-    try {
-        simdjson::dom::element doc = parser_.parse(json_str);
-
-        if (doc.type() != simdjson::dom::element_type::OBJECT) {
-            return ExchangeTypes::MessageBuffer{};
+#include <utility>
+
+namespace {
+
+// Object keys the normalized parser acts on; anything else is skipped
+enum class Field : uint8_t {
+    UNKNOWN = 0,
+    ID,
+    CODE,
+    RESULT,
+    INSTRUMENT_NAME,
+    CHANNEL,
+    DEPTH,
+    DATA,
+    ASKS,
+    BIDS,
+    UPDATE,
+    TT,
+    T,
+    U,
+    PU,
+    TRADE_ID,
+    TRADE_PRICE,
+    TRADE_QUANTITY,
+    TRADE_SIDE,
+};
+
+constexpr PerfectHash<Field, 18> kFields({{
+                                             {"id", Field::ID},
+                                             {"code", Field::CODE},
+                                             {"result", Field::RESULT},
+                                             {"instrument_name", Field::INSTRUMENT_NAME},
+                                             {"channel", Field::CHANNEL},
+                                             {"depth", Field::DEPTH},
+                                             {"data", Field::DATA},
+                                             {"asks", Field::ASKS},
+                                             {"bids", Field::BIDS},
+                                             {"update", Field::UPDATE},
+                                             {"tt", Field::TT},
+                                             {"t", Field::T},
+                                             {"u", Field::U},
+                                             {"pu", Field::PU},
+                                             {"d", Field::TRADE_ID},
+                                             {"p", Field::TRADE_PRICE},
+                                             {"q", Field::TRADE_QUANTITY},
+                                             {"s", Field::TRADE_SIDE},
+                                         }},
+                                         Field::UNKNOWN);
+
+constexpr PerfectHash<ExchangeTypes::MessageType, 3> kChannels({{
+                                                                   {"book", ExchangeTypes::MessageType::BOOK_SNAPSHOT},
+                                                                   {"book.update", ExchangeTypes::MessageType::BOOK_DELTA_UPDATE},
+                                                                   {"trade", ExchangeTypes::MessageType::TRADE},
+                                                               }},
+                                                               ExchangeTypes::MessageType::UNKNOWN);
+
+static_assert(kFields.IsValid() && kChannels.IsValid(), "No collision-free seed for the message key set");
+
+// Text of a quoted string or bare number straight from the input buffer,
+// without unescaping or copying it, so it outlives the document
+simdjson::error_code raw_text(simdjson::ondemand::value &value, std::string_view &text) {
+    std::string_view token = value.raw_json_token();
+    if (!token.empty() && token.front() == '"') {
+        token.remove_prefix(1);
+        size_t end = token.find('"');
+        if (end == std::string_view::npos) {
+            return simdjson::INCORRECT_TYPE;
         }
+        text = token.substr(0, end);
+    } else {
+        text = token.substr(0, token.find_last_not_of(" \t\r\n") + 1);
+    }
+    return simdjson::SUCCESS;
+}
 
-        simdjson::dom::object root = doc;
-        ExchangeTypes::MessageType msg_type = DetermineMessageType(root);
-
-        switch (msg_type) {
-        case ExchangeTypes::MessageType::BOOK_SNAPSHOT:
-            return ParseBookSnapshotMessage(root);
-
-        case ExchangeTypes::MessageType::BOOK_DELTA_UPDATE:
-            return ParseBookDeltaMessage(root);
-
-        case ExchangeTypes::MessageType::TRADE:
-            return ParseTradeMessage(root);
+} // namespace
 
-        default:
-            return ExchangeTypes::MessageBuffer{};
-        }
+DataNormalization::DataNormalization() {}
 
-    } catch (const std::exception &e) {
-        std::cerr << "JSON parsing error: " << e.what() << std::endl;
-        return ExchangeTypes::MessageBuffer{};
+ExchangeTypes::MessageBuffer DataNormalization::ParseExchangeMessage(const std::string &json_str) {
+    ExchangeTypes::MessageBuffer buffer;
+    if (ParseNormalizedMessage(json_str, exchange_message_)) {
+        ExchangeTypes::AppendWireMessage(exchange_message_, buffer);
     }
+    return buffer;
 }
 
-ExchangeTypes::MessageType DataNormalization::DetermineMessageType(const simdjson::dom::object &root) {
-    auto result = root["result"];
-    if (result.error() == simdjson::SUCCESS) {
-        std::string_view channel;
-        if (result["channel"].get_string().get(channel) == simdjson::SUCCESS) {
-            if (channel == "book") {
-                return ExchangeTypes::MessageType::BOOK_SNAPSHOT;
-            } else if (channel == "book.update") {
-                return ExchangeTypes::MessageType::BOOK_DELTA_UPDATE;
-            } else if (channel == "trade") {
-                return ExchangeTypes::MessageType::TRADE;
-            }
-        }
-    }
-
-    return ExchangeTypes::MessageType::UNKNOWN;
+bool DataNormalization::ParseNormalizedMessage(std::string_view json, ExchangeTypes::NormalizedMessage &out) {
+    return ParseNormalizedMessage(json.data(), json.size(), json.size(), out);
 }
 
-template <typename T> ExchangeTypes::MessageBuffer DataNormalization::SerializeMessage(const T &message, ExchangeTypes::MessageType type) {
-    ExchangeTypes::MessageBuffer buffer(sizeof(T));
+bool DataNormalization::ParseNormalizedMessage(const char *data, size_t length, size_t capacity, ExchangeTypes::NormalizedMessage &out) {
+    out.Clear();
+    data = PadInput(data, length, capacity);
 
-    // Cast the message to bytes and copy
-    T *msg_copy = reinterpret_cast<T *>(buffer.data());
-    *msg_copy = message;
+    simdjson::ondemand::document doc;
+    simdjson::ondemand::object root;
+    if (ondemand_parser_.iterate(data, length, capacity).get(doc) != simdjson::SUCCESS || doc.get_object().get(root) != simdjson::SUCCESS) {
+        return false;
+    }
 
-    // Set the header
-    msg_copy->header.type = type;
+    return ParseNormalizedRoot(root, out);
+}
 
-    return buffer;
+size_t DataNormalization::ParseNormalizedBatch(std::string_view frame, ExchangeTypes::NormalizedBatch &out) {
+    return ParseNormalizedBatch(frame.data(), frame.size(), frame.size(), out);
 }
 
-ExchangeTypes::Level DataNormalization::ParseLevel(const simdjson::dom::array &level_array) {
-    ExchangeTypes::Level level;
+size_t DataNormalization::ParseNormalizedBatch(const char *data, size_t length, size_t capacity, ExchangeTypes::NormalizedBatch &out) {
+    out.Clear();
+    data = PadInput(data, length, capacity);
 
-    if (level_array.size() >= 3) {
-        std::string_view price, size, num_orders;
+    simdjson::ondemand::document_stream stream;
+    if (ondemand_parser_.iterate_many(data, length, kBatchWindow).get(stream) != simdjson::SUCCESS) {
+        out.AddFailed();
+        return 0;
+    }
 
-        if (level_array.at(0).get_string().get(price) == simdjson::SUCCESS) {
-            level.price = std::string(price);
+    for (auto it = stream.begin(); it != stream.end(); ++it) {
+        simdjson::ondemand::document_reference doc;
+        if ((*it).get(doc) != simdjson::SUCCESS) {
+            // Structural errors end the stream; nothing after them is reliable
+            out.AddFailed();
+            return out.Size();
         }
 
-        if (level_array.at(1).get_string().get(size) == simdjson::SUCCESS) {
-            level.size = std::string(size);
+        simdjson::ondemand::object root;
+        ExchangeTypes::NormalizedMessage &msg = out.Append();
+        msg.Clear();
+        if (doc.get_object().get(root) != simdjson::SUCCESS || !ParseNormalizedRoot(root, msg)) {
+            out.PopBack();
+            out.AddFailed();
         }
+    }
 
-        if (level_array.at(2).get_string().get(num_orders) == simdjson::SUCCESS) {
-            level.num_orders = std::string(num_orders);
-        }
+    // Incomplete trailing message
+    if (stream.truncated_bytes() > 0) {
+        out.AddFailed();
     }
 
-    return level;
+    return out.Size();
 }
 
-std::vector<ExchangeTypes::Level> DataNormalization::ParseLevels(const simdjson::dom::array &levels_array) {
-    std::vector<ExchangeTypes::Level> levels;
+size_t DataNormalization::SplitFrame(std::string_view frame, std::vector<FrameMessage> &messages) {
+    messages.clear();
+    size_t capacity = frame.size();
+    const char *data = PadInput(frame.data(), frame.size(), capacity);
 
-    for (simdjson::dom::element level_elem : levels_array) {
-        if (level_elem.type() == simdjson::dom::element_type::ARRAY) {
-            levels.push_back(ParseLevel(level_elem));
-        }
+    simdjson::ondemand::document_stream stream;
+    if (ondemand_parser_.iterate_many(data, frame.size(), kBatchWindow).get(stream) != simdjson::SUCCESS) {
+        return 1;
     }
 
-    return levels;
-}
-
-ExchangeTypes::BookSnapshotData DataNormalization::ParseBookSnapshotData(const simdjson::dom::object &data_obj) {
-    ExchangeTypes::BookSnapshotData data;
+    for (auto it = stream.begin(); it != stream.end(); ++it) {
+        simdjson::ondemand::document_reference doc;
+        if ((*it).get(doc) != simdjson::SUCCESS) {
+            return 1;
+        }
 
-    // Parse asks
-    auto asks = data_obj["asks"];
-    if (asks.error() == simdjson::SUCCESS && asks.type() == simdjson::dom::element_type::ARRAY) {
-        data.asks = ParseLevels(asks);
-    }
+        // source() has to be taken before the document is walked
+        FrameMessage &message = messages.emplace_back(FrameMessage{it.source(), {}});
 
-    // Parse bids
-    auto bids = data_obj["bids"];
-    if (bids.error() == simdjson::SUCCESS && bids.type() == simdjson::dom::element_type::ARRAY) {
-        data.bids = ParseLevels(bids);
+        simdjson::ondemand::object result;
+        simdjson::ondemand::value name;
+        if (doc.find_field_unordered("result").get_object().get(result) == simdjson::SUCCESS &&
+            result.find_field_unordered("instrument_name").get(name) == simdjson::SUCCESS) {
+            raw_text(name, message.instrument_name);
+        }
     }
 
-    // Parse timestamps and sequence numbers
-    uint64_t tt, t, u;
-    if (data_obj["tt"].get_uint64().get(tt) == simdjson::SUCCESS) {
-        data.tt = tt;
-    }
+    return stream.truncated_bytes() > 0 ? 1 : 0;
+}
 
-    if (data_obj["t"].get_uint64().get(t) == simdjson::SUCCESS) {
-        data.t = t;
+const char *DataNormalization::PadInput(const char *data, size_t length, size_t &capacity) {
+    if (capacity >= length + simdjson::SIMDJSON_PADDING) {
+        return data;
     }
 
-    if (data_obj["u"].get_uint64().get(u) == simdjson::SUCCESS) {
-        data.u = u;
+    if (padded_input_.size() < length + simdjson::SIMDJSON_PADDING) {
+        padded_input_.resize(length + simdjson::SIMDJSON_PADDING);
     }
-
-    return data;
+    std::memcpy(padded_input_.data(), data, length);
+    capacity = padded_input_.size();
+    return padded_input_.data();
 }
 
-ExchangeTypes::BookDeltaData DataNormalization::ParseBookDeltaData(const simdjson::dom::object &data_obj) {
-    ExchangeTypes::BookDeltaData data;
-
-    // Parse update data
-    auto update = data_obj["update"];
-    if (update.error() == simdjson::SUCCESS && update.type() == simdjson::dom::element_type::OBJECT) {
-        simdjson::dom::object update_obj = update;
-
-        // Parse asks in update
-        auto asks = update_obj["asks"];
-        if (asks.error() == simdjson::SUCCESS && asks.type() == simdjson::dom::element_type::ARRAY) {
-            data.update.asks = ParseLevels(asks);
+bool DataNormalization::ParseNormalizedRoot(simdjson::ondemand::object &root, ExchangeTypes::NormalizedMessage &out) {
+    for (auto field_result : root) {
+        simdjson::ondemand::field field;
+        if (std::move(field_result).get(field) != simdjson::SUCCESS) {
+            return false;
         }
 
-        // Parse bids in update
-        auto bids = update_obj["bids"];
-        if (bids.error() == simdjson::SUCCESS && bids.type() == simdjson::dom::element_type::ARRAY) {
-            data.update.bids = ParseLevels(bids);
+        simdjson::ondemand::value value = field.value();
+        switch (kFields.Find(field.escaped_key())) {
+        case Field::ID:
+            if (value.get_int64().get(out.id) != simdjson::SUCCESS) {
+                return false;
+            }
+            break;
+        case Field::CODE: {
+            int64_t code;
+            if (value.get_int64().get(code) != simdjson::SUCCESS) {
+                return false;
+            }
+            out.code = static_cast<int32_t>(code);
+            break;
+        }
+        case Field::RESULT: {
+            simdjson::ondemand::object result;
+            if (value.get_object().get(result) != simdjson::SUCCESS || !ParseNormalizedResult(result, out)) {
+                return false;
+            }
+            break;
+        }
+        default:
+            break;
         }
     }
 
-    // Parse timestamps and sequence numbers
-    uint64_t tt, t, u, pu;
-    if (data_obj["tt"].get_uint64().get(tt) == simdjson::SUCCESS) {
-        data.tt = tt;
-    }
-
-    if (data_obj["t"].get_uint64().get(t) == simdjson::SUCCESS) {
-        data.t = t;
-    }
+    return out.header.type != ExchangeTypes::MessageType::UNKNOWN && ConvertNormalizedDecimals(out);
+}
 
-    if (data_obj["u"].get_uint64().get(u) == simdjson::SUCCESS) {
-        data.u = u;
+bool DataNormalization::ConvertNormalizedDecimals(ExchangeTypes::NormalizedMessage &out) {
+    if (out.instrument_id != ExchangeTypes::kInvalidInstrumentId) {
+        out.price_decimals = instrument_registry_.GetPriceDecimals(out.instrument_id);
+        out.quantity_decimals = instrument_registry_.GetQuantityDecimals(out.instrument_id);
     }
 
-    if (data_obj["pu"].get_uint64().get(pu) == simdjson::SUCCESS) {
-        data.pu = pu;
+    if (!bid_prices_.Convert(out.num_bids, out.price_decimals) || !bid_sizes_.Convert(out.num_bids, out.quantity_decimals) ||
+        !ask_prices_.Convert(out.num_asks, out.price_decimals) || !ask_sizes_.Convert(out.num_asks, out.quantity_decimals) ||
+        !trade_prices_.Convert(out.num_trades, out.price_decimals) || !trade_quantities_.Convert(out.num_trades, out.quantity_decimals)) {
+        return false;
     }
 
-    return data;
-}
-
-ExchangeTypes::MessageBuffer DataNormalization::ParseBookSnapshotMessage(const simdjson::dom::object &root) {
-    ExchangeTypes::BookSnapshotResponse response{};
-
-    // Parse base response fields
-    int64_t id;
-    if (root["id"].get_int64().get(id) == simdjson::SUCCESS) {
-        response.id = id;
+    for (uint32_t i = 0; i < out.num_bids; ++i) {
+        out.bids[i].price = bid_prices_.values[i];
+        out.bids[i].size = bid_sizes_.values[i];
     }
-
-    std::string_view method;
-    if (root["method"].get_string().get(method) == simdjson::SUCCESS) {
-        response.method = std::string(method);
+    for (uint32_t i = 0; i < out.num_asks; ++i) {
+        out.asks[i].price = ask_prices_.values[i];
+        out.asks[i].size = ask_sizes_.values[i];
     }
-
-    int64_t code;
-    if (root["code"].get_int64().get(code) == simdjson::SUCCESS) {
-        response.code = static_cast<int>(code);
+    for (uint32_t i = 0; i < out.num_trades; ++i) {
+        out.trades[i].price = trade_prices_.values[i];
+        out.trades[i].quantity = trade_quantities_.values[i];
     }
 
-    // Parse result
-    auto result_obj = root["result"];
-    if (result_obj.error() == simdjson::SUCCESS) {
-        simdjson::dom::object result = result_obj;
+    return true;
+}
 
-        std::string_view instrument_name;
-        if (result["instrument_name"].get_string().get(instrument_name) == simdjson::SUCCESS) {
-            response.result.instrument_name = std::string(instrument_name);
+bool DataNormalization::ParseNormalizedResult(simdjson::ondemand::object &result, ExchangeTypes::NormalizedMessage &out) {
+    for (auto field_result : result) {
+        simdjson::ondemand::field field;
+        if (std::move(field_result).get(field) != simdjson::SUCCESS) {
+            return false;
         }
 
-        std::string_view subscription;
-        if (result["subscription"].get_string().get(subscription) == simdjson::SUCCESS) {
-            response.result.subscription = std::string(subscription);
+        simdjson::ondemand::value value = field.value();
+        switch (kFields.Find(field.escaped_key())) {
+        case Field::INSTRUMENT_NAME: {
+            std::string_view instrument_name;
+            if (value.get_string().get(instrument_name) != simdjson::SUCCESS) {
+                return false;
+            }
+            out.instrument_id = instrument_registry_.Intern(instrument_name);
+            break;
         }
-
-        std::string_view channel;
-        if (result["channel"].get_string().get(channel) == simdjson::SUCCESS) {
-            response.result.channel = std::string(channel);
+        case Field::CHANNEL: {
+            std::string_view channel;
+            if (value.get_string().get(channel) != simdjson::SUCCESS) {
+                return false;
+            }
+            out.header.type = kChannels.Find(channel);
+            break;
         }
-
-        int64_t depth;
-        if (result["depth"].get_int64().get(depth) == simdjson::SUCCESS) {
-            response.result.depth = static_cast<int>(depth);
+        case Field::DEPTH: {
+            uint64_t depth;
+            if (value.get_uint64().get(depth) != simdjson::SUCCESS) {
+                return false;
+            }
+            out.depth = static_cast<uint32_t>(depth);
+            break;
         }
-
-        // Parse data array
-        auto data_array = result["data"];
-        if (data_array.error() == simdjson::SUCCESS) {
-            for (simdjson::dom::element data_item : data_array) {
-                if (data_item.type() == simdjson::dom::element_type::OBJECT) {
-                    response.result.data.push_back(ParseBookSnapshotData(data_item));
+        case Field::DATA: {
+            simdjson::ondemand::array data_array;
+            if (value.get_array().get(data_array) != simdjson::SUCCESS) {
+                return false;
+            }
+            for (auto item_result : data_array) {
+                simdjson::ondemand::object data_obj;
+                if (item_result.get_object().get(data_obj) != simdjson::SUCCESS || !ParseNormalizedData(data_obj, out)) {
+                    return false;
                 }
+                out.num_data++;
             }
+            break;
+        }
+        default:
+            break;
         }
     }
 
-    return SerializeMessage(response, ExchangeTypes::MessageType::BOOK_SNAPSHOT);
+    return true;
 }
 
-ExchangeTypes::MessageBuffer DataNormalization::ParseBookDeltaMessage(const simdjson::dom::object &root) {
-    ExchangeTypes::BookDeltaResponse response{};
-
-    // Parse base response fields
-    int64_t id;
-    if (root["id"].get_int64().get(id) == simdjson::SUCCESS) {
-        response.id = id;
-    }
-
-    std::string_view method;
-    if (root["method"].get_string().get(method) == simdjson::SUCCESS) {
-        response.method = std::string(method);
-    }
-
-    int64_t code;
-    if (root["code"].get_int64().get(code) == simdjson::SUCCESS) {
-        response.code = static_cast<int>(code);
-    }
-
-    // Parse result
-    auto result_obj = root["result"];
-    if (result_obj.error() == simdjson::SUCCESS) {
-        simdjson::dom::object result = result_obj;
+bool DataNormalization::ParseNormalizedData(simdjson::ondemand::object &data_obj, ExchangeTypes::NormalizedMessage &out) {
+    ExchangeTypes::NormalizedTrade trade{};
+    std::string_view trade_price;
+    std::string_view trade_quantity;
+    bool is_trade = false;
 
-        std::string_view instrument_name;
-        if (result["instrument_name"].get_string().get(instrument_name) == simdjson::SUCCESS) {
-            response.result.instrument_name = std::string(instrument_name);
+    for (auto field_result : data_obj) {
+        simdjson::ondemand::field field;
+        if (std::move(field_result).get(field) != simdjson::SUCCESS) {
+            return false;
         }
 
-        std::string_view subscription;
-        if (result["subscription"].get_string().get(subscription) == simdjson::SUCCESS) {
-            response.result.subscription = std::string(subscription);
+        simdjson::ondemand::value value = field.value();
+        simdjson::error_code error = simdjson::SUCCESS;
+        Field key = kFields.Find(field.escaped_key());
+
+        switch (key) {
+        case Field::ASKS:
+        case Field::BIDS: {
+            bool is_ask = key == Field::ASKS;
+            simdjson::ondemand::array levels_array;
+            bool parsed = value.get_array().get(levels_array) == simdjson::SUCCESS &&
+                          (is_ask ? ParseNormalizedLevels(levels_array, out.asks, ask_prices_, ask_sizes_, out.num_asks, out.truncated)
+                                  : ParseNormalizedLevels(levels_array, out.bids, bid_prices_, bid_sizes_, out.num_bids, out.truncated));
+            if (!parsed) {
+                return false;
+            }
+            break;
         }
-
-        std::string_view channel;
-        if (result["channel"].get_string().get(channel) == simdjson::SUCCESS) {
-            response.result.channel = std::string(channel);
+        case Field::UPDATE: {
+            // Deltas nest their levels one object deeper
+            simdjson::ondemand::object update_obj;
+            if (value.get_object().get(update_obj) != simdjson::SUCCESS || !ParseNormalizedData(update_obj, out)) {
+                return false;
+            }
+            break;
         }
-
-        int64_t depth;
-        if (result["depth"].get_int64().get(depth) == simdjson::SUCCESS) {
-            response.result.depth = static_cast<int>(depth);
+        case Field::TT:
+            error = value.get_uint64().get(out.tt);
+            break;
+        case Field::T:
+            error = value.get_uint64().get(out.t);
+            trade.t = out.t;
+            break;
+        case Field::U:
+            error = value.get_uint64().get(out.u);
+            break;
+        case Field::PU:
+            error = value.get_uint64().get(out.pu);
+            break;
+        case Field::TRADE_ID:
+            error = value.get_uint64_in_string().get(trade.trade_id);
+            is_trade = true;
+            break;
+        case Field::TRADE_PRICE:
+            error = raw_text(value, trade_price);
+            is_trade = true;
+            break;
+        case Field::TRADE_QUANTITY:
+            error = raw_text(value, trade_quantity);
+            is_trade = true;
+            break;
+        case Field::TRADE_SIDE: {
+            std::string_view side;
+            error = value.get_string().get(side);
+            trade.side = side == "BUY" ? ExchangeTypes::TradeSide::BUY : side == "SELL" ? ExchangeTypes::TradeSide::SELL : ExchangeTypes::TradeSide::UNKNOWN;
+            is_trade = true;
+            break;
         }
-
-        // Parse data array
-        auto data_array = result["data"];
-        if (data_array.error() == simdjson::SUCCESS) {
-            for (simdjson::dom::element data_item : data_array) {
-                if (data_item.type() == simdjson::dom::element_type::OBJECT) {
-                    response.result.data.push_back(ParseBookDeltaData(data_item));
-                }
-            }
+        default:
+            break;
         }
-    }
 
-    return SerializeMessage(response, ExchangeTypes::MessageType::BOOK_DELTA_UPDATE);
-}
-
-ExchangeTypes::MessageBuffer DataNormalization::ParseTradeMessage(const simdjson::dom::object &root) {
-    ExchangeTypes::TradeResponse response{};
-
-    // Parse base response fields
-    int64_t id;
-    if (root["id"].get_int64().get(id) == simdjson::SUCCESS) {
-        response.id = id;
-    }
-
-    std::string_view method;
-    if (root["method"].get_string().get(method) == simdjson::SUCCESS) {
-        response.method = std::string(method);
+        if (error != simdjson::SUCCESS) {
+            return false;
+        }
     }
 
-    int64_t code;
-    if (root["code"].get_int64().get(code) == simdjson::SUCCESS) {
-        response.code = static_cast<int>(code);
+    if (is_trade) {
+        if (out.num_trades < out.trades.size()) {
+            trade_prices_.texts[out.num_trades] = trade_price;
+            trade_quantities_.texts[out.num_trades] = trade_quantity;
+            out.trades[out.num_trades++] = trade;
+        } else {
+            out.truncated = true;
+        }
     }
 
-    // Parse result
-    auto result_obj = root["result"];
-    if (result_obj.error() == simdjson::SUCCESS) {
-        simdjson::dom::object result = result_obj;
-
-        std::string_view instrument_name;
-        if (result["instrument_name"].get_string().get(instrument_name) == simdjson::SUCCESS) {
-            response.result.instrument_name = std::string(instrument_name);
-        }
+    return true;
+}
 
-        std::string_view subscription;
-        if (result["subscription"].get_string().get(subscription) == simdjson::SUCCESS) {
-            response.result.subscription = std::string(subscription);
+bool DataNormalization::ParseNormalizedLevels(simdjson::ondemand::array &levels_array, std::span<ExchangeTypes::NormalizedLevel> levels,
+                                              DecimalColumn &prices, DecimalColumn &sizes, uint32_t &count, bool &truncated) {
+    for (auto level_result : levels_array) {
+        simdjson::ondemand::array level_array;
+        if (level_result.get_array().get(level_array) != simdjson::SUCCESS) {
+            return false;
         }
 
-        std::string_view channel;
-        if (result["channel"].get_string().get(channel) == simdjson::SUCCESS) {
-            response.result.channel = std::string(channel);
+        if (count == levels.size()) {
+            truncated = true;
+            continue;
         }
 
-        // Parse data array
-        auto data_array = result["data"];
-        if (data_array.error() == simdjson::SUCCESS) {
-            for (simdjson::dom::element data_item : data_array) {
-                if (data_item.type() == simdjson::dom::element_type::OBJECT) {
-                    response.result.data.push_back(ParseTradeData(data_item));
+        // [price, size, num_orders], all as strings
+        ExchangeTypes::NormalizedLevel &level = levels[count];
+        level = {};
+        size_t index = 0;
+        for (auto element : level_array) {
+            simdjson::ondemand::value value;
+            simdjson::error_code error = std::move(element).get(value);
+            if (error == simdjson::SUCCESS) {
+                if (index == 0) {
+                    error = raw_text(value, prices.texts[count]);
+                } else if (index == 1) {
+                    error = raw_text(value, sizes.texts[count]);
+                } else if (index == 2) {
+                    uint64_t num_orders = 0;
+                    error = value.get_uint64_in_string().get(num_orders);
+                    level.num_orders = static_cast<uint32_t>(num_orders);
                 }
             }
+            if (error != simdjson::SUCCESS) {
+                return false;
+            }
+            index++;
         }
-    }
-
-    return SerializeMessage(response, ExchangeTypes::MessageType::TRADE);
-}
 
-ExchangeTypes::TradeData DataNormalization::ParseTradeData(const simdjson::dom::object &data_obj) {
-    ExchangeTypes::TradeData data;
-
-    // Parse trade ID (d)
-    std::string_view d;
-    if (data_obj["d"].get_string().get(d) == simdjson::SUCCESS) {
-        data.d = std::string(d);
-    }
-
-    // Parse trade timestamp in milliseconds (t)
-    uint64_t t;
-    if (data_obj["t"].get_uint64().get(t) == simdjson::SUCCESS) {
-        data.t = t;
-    }
-
-    // Parse trade quantity (q)
-    std::string_view q;
-    if (data_obj["q"].get_string().get(q) == simdjson::SUCCESS) {
-        data.q = std::string(q);
-    }
-
-    // Parse trade price (p)
-    std::string_view p;
-    if (data_obj["p"].get_string().get(p) == simdjson::SUCCESS) {
-        data.p = std::string(p);
-    }
-
-    // Parse side (s) - BUY or SELL
-    std::string_view s;
-    if (data_obj["s"].get_string().get(s) == simdjson::SUCCESS) {
-        data.s = std::string(s);
-    }
-
-    // Parse instrument name (i)
-    std::string_view i;
-    if (data_obj["i"].get_string().get(i) == simdjson::SUCCESS) {
-        data.i = std::string(i);
+        if (index < 2) {
+            return false;
+        }
+        count++;
     }
 
-    return data;
+    return true;
 }
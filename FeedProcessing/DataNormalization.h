@@ -1,12 +1,17 @@
 #pragma once
 
+#include <array>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
-#include "Types/ExchangeBookTypes.h"
+#include "Types/DecimalParser.h"
+#include "Types/InstrumentRegistry.h"
+#include "Types/NormalizedMessage.h"
 #include "Types/SharedTypes.h"
-#include "Types/TradeTypes.h"
+#include "Types/WireFormat.h"
 #include "simdjson.h"
 
 class DataNormalization {
@@ -14,26 +19,79 @@ class DataNormalization {
     DataNormalization();
     ~DataNormalization() = default;
 
+    // Parses one message into an ExchangeTypes::WireMarketMessage record (see
+    // Types/WireFormat.h); empty for malformed JSON and unknown channels. The
+    // record names its instrument only by this normalizer's id: a caller
+    // forwarding it elsewhere must first send a WireInstrument for the id
+    // (name from GetInstrumentRegistry()).
     ExchangeTypes::MessageBuffer ParseExchangeMessage(const std::string &json_str);
 
+    // Single-pass On-Demand parse into a flat record, with no heap allocation
+    // once the parser has grown to the message size. Returns false for
+    // malformed JSON and unknown channels. Input without SIMDJSON_PADDING
+    // spare bytes after length is first copied into a reused padded buffer.
+    bool ParseNormalizedMessage(std::string_view json, ExchangeTypes::NormalizedMessage &out);
+    bool ParseNormalizedMessage(const char *data, size_t length, size_t capacity, ExchangeTypes::NormalizedMessage &out);
+
+    // Parses a frame of whitespace-separated JSON messages (e.g. one per line)
+    // with iterate_many into a reused batch and returns the number of
+    // messages parsed. Messages that fail to normalize are counted in
+    // out.GetFailedCount() and skipped; a structural error ends the frame.
+    size_t ParseNormalizedBatch(std::string_view frame, ExchangeTypes::NormalizedBatch &out);
+    size_t ParseNormalizedBatch(const char *data, size_t length, size_t capacity, ExchangeTypes::NormalizedBatch &out);
+
+    // Splits a frame into its messages without normalizing them, for routing
+    // by instrument. Each entry is the raw message text and its
+    // result.instrument_name (empty if absent); both are views into the frame
+    // or its padded copy and stay valid until the next call. Returns the
+    // number of messages that could not be split off (structural errors and
+    // incomplete trailing bytes), which are left out of messages.
+    struct FrameMessage {
+        std::string_view json;
+        std::string_view instrument_name;
+    };
+    size_t SplitFrame(std::string_view frame, std::vector<FrameMessage> &messages);
+
+    // Instrument names are interned here while parsing; results carry the id
+    ExchangeTypes::InstrumentRegistry &GetInstrumentRegistry() { return instrument_registry_; }
+    const ExchangeTypes::InstrumentRegistry &GetInstrumentRegistry() const { return instrument_registry_; }
+
   private:
-    // Helper methods for parsing different message components
-    ExchangeTypes::MessageType DetermineMessageType(const simdjson::dom::object &root);
-    ExchangeTypes::Level ParseLevel(const simdjson::dom::array &level_array);
-    std::vector<ExchangeTypes::Level> ParseLevels(const simdjson::dom::array &levels_array);
-    ExchangeTypes::BookSnapshotData ParseBookSnapshotData(const simdjson::dom::object &data_obj);
-    ExchangeTypes::BookDeltaData ParseBookDeltaData(const simdjson::dom::object &data_obj);
+    // Largest single message accepted in a batched frame
+    static constexpr size_t kBatchWindow = 1 << 20;
+
+    // On-Demand helpers for ParseNormalizedMessage/ParseNormalizedBatch/SplitFrame.
+    // PadInput returns data itself if it is already padded, otherwise a copy
+    // in padded_input_, and updates capacity to match.
+    const char *PadInput(const char *data, size_t length, size_t &capacity);
+    bool ParseNormalizedRoot(simdjson::ondemand::object &root, ExchangeTypes::NormalizedMessage &out);
+    bool ParseNormalizedResult(simdjson::ondemand::object &result, ExchangeTypes::NormalizedMessage &out);
+    bool ParseNormalizedData(simdjson::ondemand::object &data_obj, ExchangeTypes::NormalizedMessage &out);
+
+    // Decimal strings of one column (e.g. bid prices), collected during the
+    // walk as views into the input and converted to fixed-point in one batch
+    // once the instrument, and with it the precision, is known
+    struct DecimalColumn {
+        std::array<std::string_view, ExchangeTypes::kMaxNormalizedTrades> texts;
+        std::array<int64_t, ExchangeTypes::kMaxNormalizedTrades> values;
 
-    // Helper methods for parsing different message types
-    ExchangeTypes::MessageBuffer ParseBookSnapshotMessage(const simdjson::dom::object &root);
-    ExchangeTypes::MessageBuffer ParseBookDeltaMessage(const simdjson::dom::object &root);
-    ExchangeTypes::MessageBuffer ParseTradeMessage(const simdjson::dom::object &root);
+        bool Convert(uint32_t count, uint8_t decimals) { return ExchangeTypes::ParseDecimals(std::span(texts).first(count), decimals, values); }
+    };
 
-    // Trade parsing helpers
-    ExchangeTypes::TradeData ParseTradeData(const simdjson::dom::object &data_obj);
+    static_assert(ExchangeTypes::kMaxNormalizedTrades >= ExchangeTypes::kMaxNormalizedLevels, "DecimalColumn must hold a full side");
 
-    // Buffer serialization helpers
-    template <typename T> ExchangeTypes::MessageBuffer SerializeMessage(const T &message, ExchangeTypes::MessageType type);
+    bool ParseNormalizedLevels(simdjson::ondemand::array &levels_array, std::span<ExchangeTypes::NormalizedLevel> levels, DecimalColumn &prices,
+                               DecimalColumn &sizes, uint32_t &count, bool &truncated);
+    bool ConvertNormalizedDecimals(ExchangeTypes::NormalizedMessage &out);
 
-    simdjson::dom::parser parser_;
+    simdjson::ondemand::parser ondemand_parser_;
+    std::vector<char> padded_input_;
+    DecimalColumn bid_prices_;
+    DecimalColumn bid_sizes_;
+    DecimalColumn ask_prices_;
+    DecimalColumn ask_sizes_;
+    DecimalColumn trade_prices_;
+    DecimalColumn trade_quantities_;
+    ExchangeTypes::InstrumentRegistry instrument_registry_;
+    ExchangeTypes::NormalizedMessage exchange_message_; // for ParseExchangeMessage
 };
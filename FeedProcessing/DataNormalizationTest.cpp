@@ -1,4 +1,5 @@
 #include "DataNormalization.h"
+#include "PerfectHash.h"
 #include <gtest/gtest.h>
 
 TEST(DataNormalizationTest, ParseBookDeltaMessage) {
@@ -35,20 +36,23 @@ TEST(DataNormalizationTest, ParseBookDeltaMessage) {
 
     auto result = normalizer.ParseExchangeMessage(json_str);
 
-    EXPECT_EQ(ExchangeTypes::GetMessageType(result), ExchangeTypes::MessageType::BOOK_DELTA_UPDATE);
+    EXPECT_EQ(ExchangeTypes::GetWireType(result), ExchangeTypes::WireType::BOOK_DELTA_UPDATE);
 
-    auto delta = ExchangeTypes::CastToMessage<ExchangeTypes::BookDeltaResponse>(result);
-    EXPECT_EQ(delta->result.instrument_name, "BTCUSD-PERP");
-    EXPECT_EQ(delta->result.depth, 10);
-    EXPECT_EQ(delta->result.channel, "book.update");
+    auto delta = ExchangeTypes::ViewWire<ExchangeTypes::WireMarketMessage>(result);
+    ASSERT_NE(delta, nullptr);
+    EXPECT_EQ(delta->header.size, result.size());
+    EXPECT_EQ(normalizer.GetInstrumentRegistry().GetName(delta->instrument_id), "BTCUSD-PERP");
+    EXPECT_EQ(delta->depth, 10);
 
-    auto &data = delta->result.data[0];
-    EXPECT_EQ(data.update.asks.size(), 2);
-    EXPECT_EQ(data.update.bids.size(), 1);
-    EXPECT_EQ(data.tt, 1647917463003);
-    EXPECT_EQ(data.t, 1647917463003);
-    EXPECT_EQ(data.u, 7845460002);
-    EXPECT_EQ(data.pu, 7845460001);
+    ASSERT_EQ(delta->Asks().size(), 2);
+    ASSERT_EQ(delta->Bids().size(), 1);
+    EXPECT_EQ(delta->Asks()[1].price, 5018000000000);
+    EXPECT_EQ(delta->Asks()[1].num_orders, 10);
+    EXPECT_DOUBLE_EQ(delta->ToQuantity(delta->Bids()[0].size), 0.252);
+    EXPECT_EQ(delta->tt, 1647917463003);
+    EXPECT_EQ(delta->t, 1647917463003);
+    EXPECT_EQ(delta->u, 7845460002);
+    EXPECT_EQ(delta->pu, 7845460001);
 }
 
 TEST(DataNormalizationTest, ParseBookSnapshotMessage) {
@@ -99,17 +103,20 @@ TEST(DataNormalizationTest, ParseBookSnapshotMessage) {
 
     auto result = normalizer.ParseExchangeMessage(json_str);
 
-    EXPECT_EQ(ExchangeTypes::GetMessageType(result), ExchangeTypes::MessageType::BOOK_SNAPSHOT);
+    EXPECT_EQ(ExchangeTypes::GetWireType(result), ExchangeTypes::WireType::BOOK_SNAPSHOT);
 
-    auto snapshot = ExchangeTypes::CastToMessage<ExchangeTypes::BookSnapshotResponse>(result);
-    EXPECT_EQ(snapshot->result.instrument_name, "BTCUSD-PERP");
-    EXPECT_EQ(snapshot->result.depth, 10);
-    EXPECT_EQ(snapshot->result.channel, "book");
+    auto snapshot = ExchangeTypes::ViewWire<ExchangeTypes::WireMarketMessage>(result);
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(normalizer.GetInstrumentRegistry().GetName(snapshot->instrument_id), "BTCUSD-PERP");
+    EXPECT_EQ(snapshot->depth, 10);
+    EXPECT_EQ(snapshot->Asks().size(), 10);
+    EXPECT_EQ(snapshot->Bids().size(), 10);
+    EXPECT_DOUBLE_EQ(snapshot->ToPrice(snapshot->Bids()[0].price), 50113.5);
+    EXPECT_EQ(snapshot->Bids()[9].num_orders, 3);
 
-    auto &data = snapshot->result.data[0];
-    EXPECT_EQ(data.tt, 1647917462799);
-    EXPECT_EQ(data.t, 1647917463000);
-    EXPECT_EQ(data.u, 7845460001);
+    EXPECT_EQ(snapshot->tt, 1647917462799);
+    EXPECT_EQ(snapshot->t, 1647917463000);
+    EXPECT_EQ(snapshot->u, 7845460001);
 }
 
 TEST(DataNormalizationTest, ParseTradeMessage) {
@@ -138,20 +145,20 @@ TEST(DataNormalizationTest, ParseTradeMessage) {
 
     auto result = normalizer.ParseExchangeMessage(json_str);
 
-    EXPECT_EQ(ExchangeTypes::GetMessageType(result), ExchangeTypes::MessageType::TRADE);
+    EXPECT_EQ(ExchangeTypes::GetWireType(result), ExchangeTypes::WireType::TRADE);
 
-    auto trade = ExchangeTypes::CastToMessage<ExchangeTypes::TradeResponse>(result);
-    EXPECT_EQ(trade->result.instrument_name, "BTCUSD-PERP");
-    EXPECT_EQ(trade->result.subscription, "trade.BTCUSD-PERP");
-    EXPECT_EQ(trade->result.channel, "trade");
+    auto trade = ExchangeTypes::ViewWire<ExchangeTypes::WireMarketMessage>(result);
+    ASSERT_NE(trade, nullptr);
+    EXPECT_EQ(normalizer.GetInstrumentRegistry().GetName(trade->instrument_id), "BTCUSD-PERP");
+    EXPECT_EQ(trade->id, 1);
 
-    auto &data = trade->result.data[0];
-    EXPECT_EQ(data.d, "2030407068");
+    ASSERT_EQ(trade->Trades().size(), 1);
+    const auto &data = trade->Trades()[0];
+    EXPECT_EQ(data.trade_id, 2030407068);
     EXPECT_EQ(data.t, 1613581138462);
-    EXPECT_EQ(data.p, "51327.500000");
-    EXPECT_EQ(data.q, "0.000100");
-    EXPECT_EQ(data.s, "SELL");
-    EXPECT_EQ(data.i, "BTCUSD-PERP");
+    EXPECT_EQ(data.price, 5132750000000);
+    EXPECT_EQ(data.quantity, 10000);
+    EXPECT_EQ(data.side, ExchangeTypes::TradeSide::SELL);
 }
 
 TEST(DataNormalizationTest, ParseInvalidMessage) {
@@ -160,5 +167,206 @@ TEST(DataNormalizationTest, ParseInvalidMessage) {
 
     auto result = normalizer.ParseExchangeMessage(json_str);
 
-    EXPECT_EQ(ExchangeTypes::GetMessageType(result), ExchangeTypes::MessageType::UNKNOWN);
+    EXPECT_TRUE(result.empty());
+    EXPECT_EQ(ExchangeTypes::GetWireType(result), ExchangeTypes::WireType::UNKNOWN);
+}
+
+TEST(DataNormalizationTest, InternsInstrumentIds) {
+    DataNormalization normalizer;
+    auto make_trade = [](const std::string &instrument) {
+        return R"({"id": 1, "method": "subscribe", "code": 0, "result": {"instrument_name": ")" + instrument +
+               R"(", "subscription": "trade", "channel": "trade", "data": []}})";
+    };
+
+    auto btc = normalizer.ParseExchangeMessage(make_trade("BTCUSD-PERP"));
+    auto eth = normalizer.ParseExchangeMessage(make_trade("ETHUSD-PERP"));
+    auto btc_again = normalizer.ParseExchangeMessage(make_trade("BTCUSD-PERP"));
+
+    auto btc_id = ExchangeTypes::ViewWire<ExchangeTypes::WireMarketMessage>(btc)->instrument_id;
+    auto eth_id = ExchangeTypes::ViewWire<ExchangeTypes::WireMarketMessage>(eth)->instrument_id;
+
+    EXPECT_EQ(btc_id, 0);
+    EXPECT_EQ(eth_id, 1);
+    EXPECT_EQ(ExchangeTypes::ViewWire<ExchangeTypes::WireMarketMessage>(btc_again)->instrument_id, btc_id);
+
+    const auto &registry = normalizer.GetInstrumentRegistry();
+    EXPECT_EQ(registry.Size(), 2);
+    EXPECT_EQ(registry.GetName(eth_id), "ETHUSD-PERP");
+    EXPECT_EQ(registry.Find("ETHUSD-PERP"), eth_id);
+    EXPECT_EQ(registry.Find("SOLUSD-PERP"), ExchangeTypes::kInvalidInstrumentId);
+}
+
+TEST(DataNormalizationTest, NormalizedBookDelta) {
+    DataNormalization normalizer;
+    std::string json_str =
+        R"({"id": -1, "method": "subscribe", "code": 0, "result": {"instrument_name": "BTCUSD-PERP", "subscription": "book.BTCUSD-PERP.10",
+            "channel": "book.update", "depth": 10, "data": [{"update": {"asks": [["50126.000000", "0", "0"], ["50180.000000", "3.279000", "10"]],
+            "bids": [["50097.000000", "0.252000", "1"]]}, "tt": 1647917463003, "t": 1647917463003, "u": 7845460002, "pu": 7845460001}]}})";
+
+    ExchangeTypes::NormalizedMessage msg;
+    ASSERT_TRUE(normalizer.ParseNormalizedMessage(json_str, msg));
+
+    EXPECT_EQ(msg.header.type, ExchangeTypes::MessageType::BOOK_DELTA_UPDATE);
+    EXPECT_EQ(msg.instrument_id, normalizer.GetInstrumentRegistry().Find("BTCUSD-PERP"));
+    EXPECT_EQ(msg.id, -1);
+    EXPECT_EQ(msg.depth, 10);
+    EXPECT_EQ(msg.num_data, 1);
+    EXPECT_EQ(msg.tt, 1647917463003);
+    EXPECT_EQ(msg.u, 7845460002);
+    EXPECT_EQ(msg.pu, 7845460001);
+    EXPECT_FALSE(msg.truncated);
+
+    ASSERT_EQ(msg.Asks().size(), 2);
+    ASSERT_EQ(msg.Bids().size(), 1);
+    EXPECT_EQ(msg.price_decimals, ExchangeTypes::kDefaultDecimals);
+    EXPECT_EQ(msg.Asks()[0].price, 5012600000000);
+    EXPECT_EQ(msg.Asks()[0].size, 0);
+    EXPECT_EQ(msg.Asks()[1].size, 327900000);
+    EXPECT_EQ(msg.ToQuantity(msg.Asks()[1].size), 3.279);
+    EXPECT_EQ(msg.Asks()[1].num_orders, 10);
+    EXPECT_EQ(msg.ToPrice(msg.Bids()[0].price), 50097.0);
+}
+
+TEST(DataNormalizationTest, NormalizedSnapshotAndTrades) {
+    DataNormalization normalizer;
+    std::string snapshot =
+        R"({"id": -1, "method": "subscribe", "code": 0, "result": {"instrument_name": "ETHUSD-PERP", "subscription": "book.ETHUSD-PERP.10",
+            "channel": "book", "depth": 10, "data": [{"asks": [["2500.00", "1.0", "1"], ["2501.00", "2.0", "2"]], "bids": [["2499.00", "1.5", "1"]],
+            "tt": 1647917462799, "t": 1647917463000, "u": 7845460001}]}})";
+    std::string trades =
+        R"({"id": 1, "method": "subscribe", "code": 0, "result": {"instrument_name": "ETHUSD-PERP", "subscription": "trade.ETHUSD-PERP",
+            "channel": "trade", "data": [{"d": "2030407068", "t": 1613581138462, "p": "2500.50", "q": "0.25", "s": "SELL", "i": "ETHUSD-PERP"},
+            {"d": "2030407069", "t": 1613581138463, "p": "2500.75", "q": "1.5", "s": "BUY", "i": "ETHUSD-PERP"}]}})";
+
+    auto &registry = normalizer.GetInstrumentRegistry();
+    registry.SetDecimals(registry.Intern("ETHUSD-PERP"), 2, 4);
+
+    ExchangeTypes::NormalizedMessage msg;
+    ASSERT_TRUE(normalizer.ParseNormalizedMessage(snapshot, msg));
+    EXPECT_EQ(msg.header.type, ExchangeTypes::MessageType::BOOK_SNAPSHOT);
+    EXPECT_EQ(msg.t, 1647917463000);
+    EXPECT_EQ(msg.u, 7845460001);
+    EXPECT_EQ(msg.price_decimals, 2);
+    EXPECT_EQ(msg.quantity_decimals, 4);
+    EXPECT_EQ(msg.Asks().size(), 2);
+    EXPECT_EQ(msg.Asks()[1].price, 250100);
+    EXPECT_EQ(msg.Bids()[0].size, 15000);
+    EXPECT_EQ(msg.Trades().size(), 0);
+
+    // The same record is reused; counts from the snapshot must not leak
+    ASSERT_TRUE(normalizer.ParseNormalizedMessage(trades, msg));
+    EXPECT_EQ(msg.header.type, ExchangeTypes::MessageType::TRADE);
+    EXPECT_EQ(msg.num_data, 2);
+    EXPECT_EQ(msg.Asks().size(), 0);
+    ASSERT_EQ(msg.Trades().size(), 2);
+    EXPECT_EQ(msg.Trades()[0].trade_id, 2030407068);
+    EXPECT_EQ(msg.Trades()[0].t, 1613581138462);
+    EXPECT_EQ(msg.Trades()[0].price, 250050);
+    EXPECT_EQ(msg.Trades()[0].quantity, 2500);
+    EXPECT_EQ(msg.Trades()[1].price, 250075);
+    EXPECT_EQ(msg.Trades()[0].side, ExchangeTypes::TradeSide::SELL);
+    EXPECT_EQ(msg.Trades()[1].side, ExchangeTypes::TradeSide::BUY);
+}
+
+TEST(DataNormalizationTest, NormalizedRejectsInvalidAndTruncatesDeepBooks) {
+    DataNormalization normalizer;
+    ExchangeTypes::NormalizedMessage msg;
+
+    EXPECT_FALSE(normalizer.ParseNormalizedMessage("invalid json", msg));
+    EXPECT_FALSE(normalizer.ParseNormalizedMessage(R"({"result": {"channel": "ticker", "data": []}})", msg));
+    EXPECT_FALSE(normalizer.ParseNormalizedMessage(R"({"result": {"channel": "book", "data": [{"bids": [[1, 2, 3]]}]}})", msg));
+
+    std::string bids;
+    for (size_t i = 0; i < ExchangeTypes::kMaxNormalizedLevels + 5; ++i) {
+        bids += (i ? "," : "") + std::string(R"([")") + std::to_string(1000 - i) + R"(", "1", "1"])";
+    }
+    std::string deep = R"({"result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": [{"bids": [)" + bids + R"(], "u": 5}]}})";
+
+    ASSERT_TRUE(normalizer.ParseNormalizedMessage(deep, msg));
+    EXPECT_TRUE(msg.truncated);
+    EXPECT_EQ(msg.Bids().size(), ExchangeTypes::kMaxNormalizedLevels);
+    EXPECT_EQ(msg.ToPrice(msg.Bids().back().price), 1000.0 - (ExchangeTypes::kMaxNormalizedLevels - 1));
+    EXPECT_EQ(msg.u, 5);
+
+    // More precision than configured is rejected rather than rounded
+    auto &registry = normalizer.GetInstrumentRegistry();
+    registry.SetDecimals(registry.Intern("BTCUSD-PERP"), 1, 8);
+    EXPECT_FALSE(normalizer.ParseNormalizedMessage(R"({"result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": [{"bids": [["100.25", "1", "1"]]}]}})", msg));
+    EXPECT_TRUE(normalizer.ParseNormalizedMessage(R"({"result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": [{"bids": [["100.50", "1", "1"]]}]}})", msg));
+    EXPECT_EQ(msg.Bids()[0].price, 1005);
+
+    // Beyond the powers of ten a value can be scaled by: refused, decimals kept
+    EXPECT_FALSE(registry.SetDecimals(registry.Intern("BTCUSD-PERP"), ExchangeTypes::kMaxDecimalDigits + 1, 8));
+    EXPECT_EQ(registry.GetPriceDecimals(registry.Intern("BTCUSD-PERP")), 1);
+
+    // 18 digits in all: at 8 decimals, 10 integer digits fit and 11 do not
+    ASSERT_TRUE(registry.SetDecimals(registry.Intern("BTCUSD-PERP"), 8, 8));
+    EXPECT_TRUE(normalizer.ParseNormalizedMessage(R"({"result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": [{"bids": [["9999999999.5", "1", "1"]]}]}})", msg));
+    EXPECT_FALSE(normalizer.ParseNormalizedMessage(R"({"result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": [{"bids": [["10000000000", "1", "1"]]}]}})", msg));
+}
+
+TEST(DataNormalizationTest, PerfectHashLookup) {
+    enum class Color : uint8_t { NONE, RED, GREEN, BLUE };
+    constexpr PerfectHash<Color, 3> kColors({{{"red", Color::RED}, {"green", Color::GREEN}, {"blue", Color::BLUE}}}, Color::NONE);
+    static_assert(kColors.IsValid());
+    static_assert(kColors.Find("green") == Color::GREEN);
+
+    EXPECT_EQ(kColors.Find("red"), Color::RED);
+    EXPECT_EQ(kColors.Find("blue"), Color::BLUE);
+    EXPECT_EQ(kColors.Find("bleu"), Color::NONE);
+    EXPECT_EQ(kColors.Find(""), Color::NONE);
+}
+
+TEST(DataNormalizationTest, NormalizedBatchFromOneFrame) {
+    DataNormalization normalizer;
+    std::string frame =
+        R"({"result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": [{"bids": [["100.5", "1", "1"]], "asks": [["101", "2", "1"]], "u": 10}]}}
+{"result": {"instrument_name": "BTCUSD-PERP", "channel": "book.update", "data": [{"update": {"bids": [["100.5", "0", "0"]]}, "u": 11, "pu": 10}]}}
+{"result": {"instrument_name": "BTCUSD-PERP", "channel": "ticker", "data": []}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "trade", "data": [{"d": "1", "t": 5, "p": "2500", "q": "0.5", "s": "BUY"}]}}
+)";
+
+    ExchangeTypes::NormalizedBatch batch;
+    ASSERT_EQ(normalizer.ParseNormalizedBatch(frame, batch), 3);
+    EXPECT_EQ(batch.GetFailedCount(), 1);
+
+    EXPECT_EQ(batch[0].header.type, ExchangeTypes::MessageType::BOOK_SNAPSHOT);
+    EXPECT_EQ(batch[0].u, 10);
+    EXPECT_EQ(batch[0].ToPrice(batch[0].Bids()[0].price), 100.5);
+    EXPECT_EQ(batch[1].header.type, ExchangeTypes::MessageType::BOOK_DELTA_UPDATE);
+    EXPECT_EQ(batch[1].pu, 10);
+    EXPECT_EQ(batch[1].Bids()[0].size, 0);
+    EXPECT_EQ(batch[2].header.type, ExchangeTypes::MessageType::TRADE);
+    EXPECT_EQ(batch[2].instrument_id, normalizer.GetInstrumentRegistry().Find("ETHUSD-PERP"));
+    EXPECT_EQ(batch[2].Trades()[0].side, ExchangeTypes::TradeSide::BUY);
+
+    // Reusing the batch resets it; a single message is a batch of one
+    ASSERT_EQ(normalizer.ParseNormalizedBatch(R"({"result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": [{"u": 12}]}})", batch), 1);
+    EXPECT_EQ(batch.GetFailedCount(), 0);
+    EXPECT_EQ(batch[0].u, 12);
+    EXPECT_EQ(batch[0].Bids().size(), 0);
+
+    EXPECT_EQ(normalizer.ParseNormalizedBatch("invalid json", batch), 0);
+    EXPECT_GT(batch.GetFailedCount(), 0);
+}
+
+TEST(DataNormalizationTest, SplitFrameExtractsInstrumentNames) {
+    DataNormalization normalizer;
+    std::string frame = R"({"id": 1, "result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": []}}
+  {"method": "public/heartbeat", "id": 2}
+{"result": {"channel": "trade", "instrument_name": "ETHUSD-PERP"}}
+{"result": {"instrument_name": )";
+
+    std::vector<DataNormalization::FrameMessage> messages;
+    EXPECT_EQ(normalizer.SplitFrame(frame, messages), 1);
+    ASSERT_EQ(messages.size(), 3);
+
+    EXPECT_EQ(messages[0].json, R"({"id": 1, "result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": []}})");
+    EXPECT_EQ(messages[0].instrument_name, "BTCUSD-PERP");
+    EXPECT_EQ(messages[1].json, R"({"method": "public/heartbeat", "id": 2})");
+    EXPECT_TRUE(messages[1].instrument_name.empty());
+    EXPECT_EQ(messages[2].instrument_name, "ETHUSD-PERP");
+
+    // Splitting does not intern instruments
+    EXPECT_EQ(normalizer.GetInstrumentRegistry().Size(), 0);
 }
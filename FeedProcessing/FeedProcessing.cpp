@@ -1,197 +1,814 @@
 #include "FeedProcessing.h"
+#include "Logging/Logger.h"
+#include "Telemetry/Clock.h"
+#include <algorithm>
 #include <chrono>
-#include <iostream>
+#include <cstring>
 #include <sstream>
 
+namespace {
+
+// How long Run() waits for input before retrying conflated BBOs the output
+// socket did not take
+constexpr int kConflationRetryMs = 1;
+
+// Reconnects to a missing output consumer back off from the first to the
+// second, doubling per failed attempt
+constexpr uint64_t kMinReconnectBackoffUs = 1000;
+constexpr uint64_t kMaxReconnectBackoffUs = 1000000;
+
+uint64_t now_micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 FeedProcessing::FeedProcessing(const std::string &input_socket_path, const std::string &bbo_output_socket_path)
-    : bbo_output_socket_path_(bbo_output_socket_path) {
+    : bbo_output_socket_path_(bbo_output_socket_path),
+      inputs_(event_loop_, [this](std::span<const uint8_t> frame, const IPC::FrameTimestamps &timestamps) {
+          run_message_count_ += ProcessFrame(std::string_view(reinterpret_cast<const char *>(frame.data()), frame.size()), timestamps);
+      }) {
 
-    ipc_receiver_ = std::make_unique<IPC::IPCReceiver>(input_socket_path);
+    // A frame's BBOs are written together once the frame is published
     ipc_sender_ = std::make_unique<IPC::IPCSender>();
+    ipc_sender_->EnableBatching();
+    if (!input_socket_path.empty()) {
+        AddInput(input_socket_path);
+    }
+}
 
-    if (!ipc_receiver_->Initialize()) {
-        std::cerr << "Failed to initialize IPC receiver for socket: " << input_socket_path << std::endl;
+bool FeedProcessing::AddInput(const std::string &input_socket_path) {
+    if (!inputs_.AddInput(input_socket_path)) {
+        LOG_ERROR("Failed to initialize IPC receiver for socket: {}", input_socket_path);
+        return false;
     }
+    return true;
 }
 
 void FeedProcessing::Run(std::optional<size_t> max_messages) {
-    if (!ipc_receiver_->IsInitialized()) {
-        std::cerr << "IPC receiver not initialized, cannot run" << std::endl;
+    if (inputs_.GetInputCount() == 0) {
+        LOG_ERROR("IPC receiver not initialized, cannot run");
         return;
     }
 
-    size_t message_count = 0;
-    while (true) {
-        auto data = ipc_receiver_->ReadData();
-
-        if (data.empty()) {
-            continue;
+    run_message_count_ = 0;
+    while (!stop_requested_.load(std::memory_order_relaxed)) {
+        // Blocks until an input has a frame or connection, except while
+        // conflated BBOs wait for the output socket
+        bool bbos_waiting = HasUnsentBbos();
+        int retry_ms = kConflationRetryMs;
+        if (bbos_waiting && !ipc_sender_->IsConnected()) {
+            // Sleep until the next reconnect attempt is due instead
+            uint64_t now = now_micros();
+            retry_ms = std::max<int>(retry_ms, static_cast<int>((std::max(next_reconnect_us_, now) - now + 999) / 1000));
         }
+        int handled = event_loop_.Poll(bbos_waiting ? retry_ms : -1);
 
-        std::string message(data.begin(), data.end());
-        ProcessMessage(message);
+        if (handled == 0 && bbos_waiting) {
+            FlushConflatedBbos();
+        }
 
-        message_count++;
-        if (max_messages.has_value() && message_count >= max_messages.value()) {
+        if (max_messages.has_value() && run_message_count_ >= max_messages.value()) {
             break;
         }
     }
+    stop_requested_.store(false, std::memory_order_relaxed);
+
+    if (capture_ && !capture_->Flush()) {
+        LOG_ERROR("Failed to write capture file");
+    }
 }
 
-void FeedProcessing::ProcessMessage(const std::string &message) {
-    auto buffer = data_normalizer_.ParseExchangeMessage(message);
+void FeedProcessing::Stop() {
+    stop_requested_.store(true, std::memory_order_relaxed);
+    event_loop_.Wakeup();
+}
 
-    if (buffer.empty()) {
-        std::cout << "Failed to parse message" << std::endl;
-        return;
+size_t FeedProcessing::ProcessFrame(std::string_view frame, const IPC::FrameTimestamps &timestamps) {
+    if (capture_) {
+        capture_->Write(frame.data(), frame.size(), timestamps.origin_ns);
     }
 
-    ExchangeTypes::MessageType msg_type = ExchangeTypes::GetMessageType(buffer);
-
-    switch (msg_type) {
-    case ExchangeTypes::MessageType::BOOK_SNAPSHOT: {
-        const auto *msg = ExchangeTypes::CastToMessage<ExchangeTypes::BookSnapshotResponse>(buffer);
-        if (msg) {
-            ProcessBookSnapshot(msg);
-            book_snapshot_count_++;
+    if (latency_recorder_) {
+        frame_timestamps_ = timestamps;
+        if (frame_timestamps_.receive_ns == 0) {
+            frame_timestamps_.receive_ns = Telemetry::NowNanos();
         }
-        break;
     }
-    case ExchangeTypes::MessageType::BOOK_DELTA_UPDATE: {
-        const auto *msg = ExchangeTypes::CastToMessage<ExchangeTypes::BookDeltaResponse>(buffer);
-        if (msg) {
-            ProcessBookDelta(msg);
-            book_delta_count_++;
-        }
-        break;
+
+    data_normalizer_.ParseNormalizedBatch(frame, normalized_batch_);
+
+    for (size_t i = 0; i < normalized_batch_.GetFailedCount(); ++i) {
+        LOG_WARN("Failed to parse message");
+    }
+
+    if (latency_recorder_) {
+        frame_parsed_ns_ = Telemetry::NowNanos();
     }
-    case ExchangeTypes::MessageType::TRADE: {
-        const auto *msg = ExchangeTypes::CastToMessage<ExchangeTypes::TradeResponse>(buffer);
-        if (msg) {
-            trade_count_++;
+
+    for (const auto &msg : normalized_batch_.Messages()) {
+        ProcessMessage(msg);
+        if (latency_recorder_) {
+            RecordMessageLatency(msg);
         }
-        break;
     }
+
+    // Books are updated message by message, but views and BBOs go out once
+    // per instrument per frame, at the instrument's latest sequence
+    PublishPendingInstruments();
+    if (bbo_conflator_) {
+        FlushConflatedBbos();
+    }
+
+    return normalized_batch_.Size() + normalized_batch_.GetFailedCount();
+}
+
+void FeedProcessing::ProcessMessage(const ExchangeTypes::NormalizedMessage &msg) {
+    if (msg.truncated) {
+        DropTruncatedMessage(msg);
+        return;
+    }
+
+    switch (msg.header.type) {
+    case ExchangeTypes::MessageType::BOOK_SNAPSHOT:
+        ProcessBookSnapshot(msg);
+        book_snapshot_count_++;
+        break;
+    case ExchangeTypes::MessageType::BOOK_DELTA_UPDATE:
+        ProcessBookDelta(msg);
+        book_delta_count_++;
+        break;
+    case ExchangeTypes::MessageType::TRADE:
+        ProcessTrades(msg);
+        trade_count_++;
+        break;
     default:
-        std::cout << "Unknown message type" << std::endl;
+        LOG_WARN("Unknown message type");
         break;
     }
 }
 
-void FeedProcessing::ProcessBookSnapshot(const ExchangeTypes::BookSnapshotResponse *msg) {
-    if (!msg || msg->result.data.empty()) {
-        std::cout << "Empty or invalid book snapshot message" << std::endl;
+void FeedProcessing::DropTruncatedMessage(const ExchangeTypes::NormalizedMessage &msg) {
+    truncated_message_count_++;
+    ExchangeTypes::InstrumentId id = msg.instrument_id;
+    std::string_view instrument = id != ExchangeTypes::kInvalidInstrumentId ? std::string_view(data_normalizer_.GetInstrumentRegistry().GetName(id)) : "";
+    LOG_ERROR("Dropping message for {} with more than {} levels per side or {} trades, sequence {}", instrument, ExchangeTypes::kMaxNormalizedLevels,
+              ExchangeTypes::kMaxNormalizedTrades, msg.u);
+
+    // The book can no longer be trusted: hold its deltas until a snapshot
+    // that fits replaces it
+    bool is_book = msg.header.type == ExchangeTypes::MessageType::BOOK_SNAPSHOT || msg.header.type == ExchangeTypes::MessageType::BOOK_DELTA_UPDATE;
+    if (is_book && EnsureInstrument(id) && !instruments_.recovering[id]) {
+        instruments_.recovering[id] = true;
+        RequestSnapshot(id);
+    }
+}
+
+void FeedProcessing::InstrumentTable::Resize(size_t size) {
+    orderbooks.resize(size);
+    last_sequence_numbers.resize(size, 0);
+    last_bbo.resize(size);
+    orderbook_configs.resize(size);
+    message_counts.resize(size, 0);
+    book_views.resize(size);
+    depth_histories.resize(size);
+    last_timestamps.resize(size, 0);
+    trade_flows.resize(size);
+    pending_publish.resize(size, false);
+    book_changed.resize(size, false);
+    trade_flow_changed.resize(size, false);
+    applied_ns.resize(size, 0);
+    recovering.resize(size, false);
+    buffered_deltas.resize(size);
+    announced.resize(size, false);
+    broadcast_announced.resize(size, false);
+}
+
+bool FeedProcessing::EnsureInstrument(ExchangeTypes::InstrumentId id) {
+    if (id == ExchangeTypes::kInvalidInstrumentId) {
+        return false;
+    }
+
+    if (id >= instruments_.Size()) {
+        instruments_.Resize(data_normalizer_.GetInstrumentRegistry().Size());
+    }
+    return true;
+}
+
+bool FeedProcessing::SetDefaultOrderbookConfig(const OrderbookConfig &config) {
+    if (!config.IsValid()) {
+        LOG_ERROR("Invalid default orderbook config: tick size {} for a tick ladder", config.tick_size);
+        return false;
+    }
+    default_orderbook_config_ = config;
+    return true;
+}
+
+bool FeedProcessing::SetOrderbookConfig(const std::string &instrument, const OrderbookConfig &config) {
+    if (!config.IsValid()) {
+        LOG_ERROR("Invalid orderbook config for {}: tick size {} for a tick ladder", instrument, config.tick_size);
+        return false;
+    }
+    ExchangeTypes::InstrumentId id = data_normalizer_.GetInstrumentRegistry().Intern(instrument);
+    EnsureInstrument(id);
+    instruments_.orderbook_configs[id] = config;
+    return true;
+}
+
+bool FeedProcessing::SetInstrumentDecimals(const std::string &instrument, uint8_t price_decimals, uint8_t quantity_decimals) {
+    auto &registry = data_normalizer_.GetInstrumentRegistry();
+    if (!registry.SetDecimals(registry.Intern(instrument), price_decimals, quantity_decimals)) {
+        LOG_ERROR("Decimals for {} must be at most {}, got {} and {}", instrument, ExchangeTypes::kMaxDecimalDigits, price_decimals,
+                  quantity_decimals);
+        return false;
+    }
+    return true;
+}
+
+const BookView *FeedProcessing::EnableBookView(const std::string &instrument) {
+    ExchangeTypes::InstrumentId id = data_normalizer_.GetInstrumentRegistry().Intern(instrument);
+    EnsureInstrument(id);
+
+    auto &view = instruments_.book_views[id];
+    if (!view) {
+        view = std::make_unique<BookView>();
+    }
+    return view.get();
+}
+
+const DepthHistory *FeedProcessing::EnableDepthHistory(const std::string &instrument, const DepthHistory::Config &config) {
+    ExchangeTypes::InstrumentId id = data_normalizer_.GetInstrumentRegistry().Intern(instrument);
+    EnsureInstrument(id);
+
+    auto &history = instruments_.depth_histories[id];
+    if (!history) {
+        history = std::make_unique<DepthHistory>(config);
+    }
+    return history.get();
+}
+
+void FeedProcessing::EnableTradeFlow(const std::string &instrument, const TradeFlowAggregator::Config &config) {
+    ExchangeTypes::InstrumentId id = data_normalizer_.GetInstrumentRegistry().Intern(instrument);
+    EnsureInstrument(id);
+
+    auto &trade_flow = instruments_.trade_flows[id];
+    if (!trade_flow) {
+        trade_flow = std::make_unique<TradeFlowAggregator>(config);
+    }
+}
+
+const ExchangeTypes::TradeFlowStats *FeedProcessing::GetTradeFlowStats(ExchangeTypes::InstrumentId id) const {
+    if (id >= instruments_.Size() || !instruments_.trade_flows[id]) {
+        return nullptr;
+    }
+    return &instruments_.trade_flows[id]->GetStats();
+}
+
+ExchangeTypes::InstrumentId FeedProcessing::GetInstrumentId(const std::string &instrument) const {
+    return data_normalizer_.GetInstrumentRegistry().Find(instrument);
+}
+
+uint64_t FeedProcessing::GetInstrumentMessageCount(ExchangeTypes::InstrumentId id) const {
+    return id < instruments_.Size() ? instruments_.message_counts[id] : 0;
+}
+
+bool FeedProcessing::IsRecovering(ExchangeTypes::InstrumentId id) const { return id < instruments_.Size() && instruments_.recovering[id]; }
+
+void FeedProcessing::ProcessTrades(const ExchangeTypes::NormalizedMessage &msg) {
+    ExchangeTypes::InstrumentId id = msg.instrument_id;
+    if (!EnsureInstrument(id)) {
+        return;
+    }
+
+    instruments_.message_counts[id]++;
+
+    auto &trade_flow = instruments_.trade_flows[id];
+    if (!trade_flow || msg.num_trades == 0) {
+        return;
+    }
+
+    for (const auto &trade : msg.Trades()) {
+        trade_flow->AddTrade(trade.t, msg.ToPrice(trade.price), msg.ToQuantity(trade.quantity), trade.side);
+    }
+    MarkTradeFlowChanged(id);
+}
+
+void FeedProcessing::ProcessBookSnapshot(const ExchangeTypes::NormalizedMessage &msg) {
+    if (msg.num_data == 0) {
+        LOG_WARN("Empty or invalid book snapshot message");
         return;
     }
 
-    const std::string &instrument = msg->result.instrument_name;
-    const auto &snapshot_data = msg->result.data[0]; // Assuming single data element
+    ExchangeTypes::InstrumentId id = msg.instrument_id;
+    if (!EnsureInstrument(id)) {
+        LOG_WARN("Book snapshot without instrument");
+        return;
+    }
 
-    if (orderbooks_.find(instrument) == orderbooks_.end()) {
-        orderbooks_[instrument] = std::make_unique<Orderbook>();
+    const std::string &instrument = data_normalizer_.GetInstrumentRegistry().GetName(id);
+
+    auto &orderbook = instruments_.orderbooks[id];
+    if (!orderbook) {
+        const auto &config = instruments_.orderbook_configs[id];
+        orderbook.emplace(config ? *config : default_orderbook_config_);
+    } else if (!instruments_.recovering[id] && msg.u <= instruments_.last_sequence_numbers[id]) {
+        // e.g. from a redundant feed that lags behind: loading it would roll
+        // the book back and make the next delta look like a gap
+        instruments_.message_counts[id]++;
+        LOG_DEBUG("Ignoring stale snapshot for {} with sequence {} (book at {})", instrument, msg.u, instruments_.last_sequence_numbers[id]);
+        return;
     }
 
-    auto &orderbook = orderbooks_[instrument];
+    instruments_.last_sequence_numbers[id] = msg.u;
+    instruments_.last_timestamps[id] = msg.t;
+    instruments_.message_counts[id]++;
 
-    last_sequence_numbers_[instrument] = snapshot_data.u;
+    LOG_DEBUG("Processing book snapshot for {} with sequence {}", instrument, msg.u);
 
-    std::cout << "Processing book snapshot for " << instrument << " with sequence " << snapshot_data.u << std::endl;
+    snapshot_bids_.clear();
+    for (const auto &bid : msg.Bids()) {
+        snapshot_bids_.push_back({msg.ToPrice(bid.price), msg.ToQuantity(bid.size)});
+    }
 
-    for (const auto &bid : snapshot_data.bids) {
-        double price = std::stod(bid.price);
-        double volume = std::stod(bid.size);
-        orderbook->UpdateBid(price, volume);
+    snapshot_asks_.clear();
+    for (const auto &ask : msg.Asks()) {
+        snapshot_asks_.push_back({msg.ToPrice(ask.price), msg.ToQuantity(ask.size)});
     }
 
-    for (const auto &ask : snapshot_data.asks) {
-        double price = std::stod(ask.price);
-        double volume = std::stod(ask.size);
-        orderbook->UpdateAsk(price, volume);
+    orderbook->LoadSnapshot(snapshot_bids_, snapshot_asks_);
+
+    auto &history = instruments_.depth_histories[id];
+    if (history) {
+        history->RecordKeyframe(*orderbook, msg.u, msg.t);
+        auto bbo = orderbook->ReturnBbo();
+        history->RecordBbo(bbo.first, bbo.second, msg.u, msg.t);
     }
 
-    SendBboUpdate(instrument, snapshot_data.u);
+    MarkPendingPublish(id);
+
+    if (instruments_.recovering[id]) {
+        ReplayBufferedDeltas(id);
+    }
 }
 
-void FeedProcessing::ProcessBookDelta(const ExchangeTypes::BookDeltaResponse *msg) {
-    if (!msg || msg->result.data.empty()) {
-        std::cout << "Empty or invalid book delta message" << std::endl;
+void FeedProcessing::ProcessBookDelta(const ExchangeTypes::NormalizedMessage &msg) {
+    if (msg.num_data == 0) {
+        LOG_WARN("Empty or invalid book delta message");
         return;
     }
 
-    const std::string &instrument = msg->result.instrument_name;
-    const auto &delta_data = msg->result.data[0]; // Assuming single data element
+    ExchangeTypes::InstrumentId id = msg.instrument_id;
 
-    if (orderbooks_.find(instrument) == orderbooks_.end()) {
-        std::cout << "ERROR: Received delta update for " << instrument << " but no orderbook exists. Sequence: " << delta_data.u << std::endl;
+    if (!EnsureInstrument(id) || !instruments_.orderbooks[id]) {
+        std::string_view instrument = id != ExchangeTypes::kInvalidInstrumentId ? std::string_view(data_normalizer_.GetInstrumentRegistry().GetName(id)) : "";
+        LOG_ERROR("Received delta update for {} but no orderbook exists. Sequence: {}", instrument, msg.u);
         return;
     }
 
-    auto seq_it = last_sequence_numbers_.find(instrument);
-    if (seq_it != last_sequence_numbers_.end()) {
-        uint64_t expected_pu = seq_it->second;
-        if (delta_data.pu != expected_pu) {
-            std::cout << "ERROR: Sequence mismatch for " << instrument << ". Expected pu=" << expected_pu << ", received pu=" << delta_data.pu
-                      << ", current u=" << delta_data.u << std::endl;
+    const std::string &instrument = data_normalizer_.GetInstrumentRegistry().GetName(id);
+    instruments_.message_counts[id]++;
+
+    if (instruments_.recovering[id]) {
+        BufferDelta(id, msg);
+        return;
+    }
+
+    uint64_t expected_pu = instruments_.last_sequence_numbers[id];
+    if (msg.pu != expected_pu) {
+        if (msg.u <= expected_pu) {
+            LOG_DEBUG("Ignoring stale delta for {} with sequence {} (book at {})", instrument, msg.u, expected_pu);
             return;
         }
+
+        LOG_ERROR("Sequence mismatch for {}. Expected pu={}, received pu={}, current u={}. Buffering deltas until the next snapshot", instrument,
+                  expected_pu, msg.pu, msg.u);
+        sequence_gap_count_++;
+        instruments_.recovering[id] = true;
+        BufferDelta(id, msg);
+        RequestSnapshot(id);
+        return;
+    }
+
+    ApplyBookDelta(id, msg);
+}
+
+template <typename Msg> void FeedProcessing::ApplyBookDelta(ExchangeTypes::InstrumentId id, const Msg &msg) {
+    const std::string &instrument = data_normalizer_.GetInstrumentRegistry().GetName(id);
+    auto &orderbook = *instruments_.orderbooks[id];
+    auto &history = instruments_.depth_histories[id];
+
+    if (history && history->NeedsKeyframe(msg.u, msg.t)) {
+        history->RecordKeyframe(orderbook, instruments_.last_sequence_numbers[id], instruments_.last_timestamps[id]);
+    }
+
+    instruments_.last_sequence_numbers[id] = msg.u;
+    instruments_.last_timestamps[id] = msg.t;
+
+    LOG_DEBUG("Processing book delta for {} with sequence {} (previous: {})", instrument, msg.u, msg.pu);
+
+    for (const auto &bid : msg.Bids()) {
+        double price = msg.ToPrice(bid.price);
+        double volume = msg.ToQuantity(bid.size);
+        orderbook.UpdateBid(price, volume);
+        if (history) {
+            history->RecordChange(Side::BID, price, volume, msg.u, msg.t);
+        }
+    }
+
+    for (const auto &ask : msg.Asks()) {
+        double price = msg.ToPrice(ask.price);
+        double volume = msg.ToQuantity(ask.size);
+        orderbook.UpdateAsk(price, volume);
+        if (history) {
+            history->RecordChange(Side::ASK, price, volume, msg.u, msg.t);
+        }
+    }
+
+    if (history) {
+        auto bbo = orderbook.ReturnBbo();
+        history->RecordBbo(bbo.first, bbo.second, msg.u, msg.t);
+    }
+
+    MarkPendingPublish(id);
+}
+
+void FeedProcessing::BufferDelta(ExchangeTypes::InstrumentId id, const ExchangeTypes::NormalizedMessage &msg) {
+    auto &buffered = instruments_.buffered_deltas[id];
+    if (buffered.count >= kMaxBufferedDeltas) {
+        LOG_ERROR("Delta buffer full for {}, dropping {} buffered deltas", data_normalizer_.GetInstrumentRegistry().GetName(id), buffered.count);
+        buffered.records.clear();
+        buffered.count = 0;
+        RequestSnapshot(id);
+    }
+    ExchangeTypes::AppendWireMessage(msg, buffered.records);
+    buffered.count++;
+}
+
+void FeedProcessing::ReplayBufferedDeltas(ExchangeTypes::InstrumentId id) {
+    const std::string &instrument = data_normalizer_.GetInstrumentRegistry().GetName(id);
+    auto &buffered = instruments_.buffered_deltas[id];
+
+    std::span<const uint8_t> records = buffered.records;
+    size_t offset = 0;
+    size_t next = 0;
+    for (; next < buffered.count; ++next) {
+        const auto &delta = *ExchangeTypes::ViewWire<ExchangeTypes::WireMarketMessage>(records.subspan(offset));
+        uint64_t last_sequence = instruments_.last_sequence_numbers[id];
+        if (delta.u > last_sequence) { // else already contained in the snapshot
+            if (delta.pu != last_sequence) {
+                break;
+            }
+            ApplyBookDelta(id, delta);
+        }
+        offset += delta.header.size;
+    }
+
+    if (next == buffered.count) {
+        LOG_INFO("Recovered {} at sequence {}", instrument, instruments_.last_sequence_numbers[id]);
+        buffered.records.clear();
+        buffered.count = 0;
+        instruments_.recovering[id] = false;
+        return;
+    }
+
+    // The buffered deltas do not connect to this snapshot either; keep the
+    // unapplied ones and wait for a newer snapshot
+    LOG_ERROR("Buffered deltas for {} do not connect to snapshot, next pu={}, book at {}", instrument,
+              ExchangeTypes::ViewWire<ExchangeTypes::WireMarketMessage>(records.subspan(offset))->pu, instruments_.last_sequence_numbers[id]);
+    buffered.records.erase(buffered.records.begin(), buffered.records.begin() + static_cast<std::ptrdiff_t>(offset));
+    buffered.count -= next;
+    RequestSnapshot(id);
+}
+
+void FeedProcessing::RequestSnapshot(ExchangeTypes::InstrumentId id) {
+    const std::string &instrument = data_normalizer_.GetInstrumentRegistry().GetName(id);
+    if (!snapshot_request_callback_) {
+        LOG_WARN("No snapshot request callback, waiting for the next snapshot of {}", instrument);
+        return;
     }
+    snapshot_request_callback_(instrument);
+}
+
+void FeedProcessing::MarkPendingPublish(ExchangeTypes::InstrumentId id) {
+    instruments_.book_changed[id] = true;
+    EnqueuePublish(id);
+}
+
+void FeedProcessing::MarkTradeFlowChanged(ExchangeTypes::InstrumentId id) {
+    instruments_.trade_flow_changed[id] = true;
+    EnqueuePublish(id);
+}
 
-    auto &orderbook = orderbooks_[instrument];
+void FeedProcessing::EnqueuePublish(ExchangeTypes::InstrumentId id) {
+    if (!instruments_.pending_publish[id]) {
+        instruments_.pending_publish[id] = true;
+        pending_instruments_.push_back(id);
+    }
+}
 
-    last_sequence_numbers_[instrument] = delta_data.u;
+void FeedProcessing::PublishPendingInstruments() {
+    for (ExchangeTypes::InstrumentId id : pending_instruments_) {
+        instruments_.pending_publish[id] = false;
+        if (instruments_.book_changed[id]) {
+            instruments_.book_changed[id] = false;
+            PublishBookView(id, instruments_.last_sequence_numbers[id], instruments_.last_timestamps[id]);
+        }
 
-    std::cout << "Processing book delta for " << instrument << " with sequence " << delta_data.u << " (previous: " << delta_data.pu << ")" << std::endl;
+        bool trade_flow_changed = instruments_.trade_flow_changed[id];
+        instruments_.trade_flow_changed[id] = false;
+        SendBboUpdate(id, instruments_.last_sequence_numbers[id], trade_flow_changed);
+    }
+    pending_instruments_.clear();
 
-    for (const auto &bid : delta_data.update.bids) {
-        double price = std::stod(bid.price);
-        double volume = std::stod(bid.size);
-        orderbook->UpdateBid(price, volume);
+    if (!bbo_conflator_ && ipc_sender_->HasPendingData() && !ipc_sender_->Flush()) {
+        LOG_ERROR("Failed to send BBO updates to: {}", bbo_output_socket_path_);
     }
+}
 
-    for (const auto &ask : delta_data.update.asks) {
-        double price = std::stod(ask.price);
-        double volume = std::stod(ask.size);
-        orderbook->UpdateAsk(price, volume);
+void FeedProcessing::PublishBookView(ExchangeTypes::InstrumentId id, uint64_t sequence_number, uint64_t timestamp) {
+    auto &view = instruments_.book_views[id];
+    if (!view) {
+        return;
     }
 
-    SendBboUpdate(instrument, delta_data.u);
+    FillDepthSnapshot(*instruments_.orderbooks[id], sequence_number, timestamp, book_view_scratch_);
+    view->Store(book_view_scratch_);
 }
 
-void FeedProcessing::SendBboUpdate(const std::string &instrument, uint64_t sequence_number) {
-    auto it = orderbooks_.find(instrument);
-    if (it == orderbooks_.end()) {
+void FeedProcessing::SendBboUpdate(ExchangeTypes::InstrumentId id, uint64_t sequence_number, bool trade_flow_changed) {
+    // Without a book yet (e.g. only the trade channel is subscribed) trade
+    // flow still goes out, with both sides empty
+    auto &orderbook = instruments_.orderbooks[id];
+    if (!orderbook && !trade_flow_changed) {
+        return;
+    }
+
+    std::pair<Price, Price> current_bbo = orderbook ? orderbook->ReturnBbo() : std::pair<Price, Price>{0, 0};
+
+    auto &last_bbo = instruments_.last_bbo[id];
+    if (last_bbo && last_bbo->first == current_bbo.first && last_bbo->second == current_bbo.second && !trade_flow_changed) {
         return;
     }
 
-    auto current_bbo = it->second->ReturnBbo();
+    last_bbo = current_bbo;
+
+    const auto &registry = data_normalizer_.GetInstrumentRegistry();
+    const std::string &instrument = registry.GetName(id);
+
+    OrderbookTypes::BboUpdate bbo_update;
+    bbo_update.instrument_id = id;
+    bbo_update.price_decimals = registry.GetPriceDecimals(id);
+    bbo_update.best_bid = ExchangeTypes::DoubleToDecimal(current_bbo.first, bbo_update.price_decimals);
+    bbo_update.best_ask = ExchangeTypes::DoubleToDecimal(current_bbo.second, bbo_update.price_decimals);
+    bbo_update.sequence_number = sequence_number;
+    bbo_update.timestamp = now_micros();
+
+    if (const auto &trade_flow = instruments_.trade_flows[id]) {
+        bbo_update.trade_flow = ExchangeTypes::ToWire(trade_flow->GetStats());
+    }
+
+    if (latency_recorder_) {
+        uint64_t now = Telemetry::NowNanos();
+        uint64_t origin = frame_timestamps_.origin_ns ? frame_timestamps_.origin_ns : frame_timestamps_.receive_ns;
+        RecordLatency(id, Telemetry::LatencySpan::PUBLISH, instruments_.applied_ns[id], now);
+        RecordLatency(id, Telemetry::LatencySpan::END_TO_END, origin, now);
+    }
 
-    auto last_bbo_it = last_bbo_.find(instrument);
-    if (last_bbo_it != last_bbo_.end()) {
-        if (last_bbo_it->second.first == current_bbo.first && last_bbo_it->second.second == current_bbo.second) {
+    if (bbo_broadcast_) {
+        BroadcastBboUpdate(id, bbo_update);
+        if (bbo_output_socket_path_.empty()) {
             return;
         }
     }
 
-    last_bbo_[instrument] = current_bbo;
+    if (bbo_conflator_) {
+        bbo_conflator_->Update(id, bbo_update, bbo_update.timestamp);
+        return;
+    }
 
-    OrderbookTypes::BboUpdate bbo_update(
-        instrument,
-        current_bbo.first,  // best_bid
-        current_bbo.second, // best_ask
-        sequence_number, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count());
+    if (!EnsureBboSenderConnected()) {
+        return;
+    }
 
-    // Connect to BBO output socket if not already connected
-    if (!ipc_sender_->IsConnected()) {
-        if (!ipc_sender_->Connect(bbo_output_socket_path_)) {
-            std::cerr << "Failed to connect BBO sender to: " << bbo_output_socket_path_ << std::endl;
-            return;
+    if (AnnounceInstrument(id, true) == IPC::IPCSender::SendResult::SENT && ipc_sender_->SendData(&bbo_update, sizeof(bbo_update))) {
+        LOG_DEBUG("BBO UPDATE SENT: {} bid={} ask={} seq={}", instrument, current_bbo.first, current_bbo.second, sequence_number);
+    } else if (!ipc_sender_->IsConnected()) {
+        // Reconnected (with backoff) on the next BBO
+        LOG_ERROR("BBO consumer at {} disconnected", bbo_output_socket_path_);
+    } else {
+        LOG_ERROR("Failed to send BBO update for {}", instrument);
+    }
+}
+
+bool FeedProcessing::EnsureBboSenderConnected() {
+    if (ipc_sender_->IsConnected()) {
+        return true;
+    }
+
+    uint64_t now = now_micros();
+    if (now < next_reconnect_us_) {
+        return false;
+    }
+    if (!ipc_sender_->Connect(bbo_output_socket_path_)) {
+        // Once per outage, not once per attempt
+        if (reconnect_backoff_us_ == 0) {
+            LOG_ERROR("Failed to connect BBO sender to: {}: {}, retrying with backoff", bbo_output_socket_path_, strerror(errno));
         }
+        output_connect_failure_count_++;
+        reconnect_backoff_us_ = std::clamp(reconnect_backoff_us_ * 2, kMinReconnectBackoffUs, kMaxReconnectBackoffUs);
+        next_reconnect_us_ = now + reconnect_backoff_us_;
+        return false;
+    }
+    if (reconnect_backoff_us_ != 0) {
+        LOG_INFO("Reconnected BBO sender to: {}", bbo_output_socket_path_);
+    }
+    reconnect_backoff_us_ = 0;
+    next_reconnect_us_ = 0;
+
+    // Instrument ids mean nothing to the new consumer until announced again
+    std::fill(instruments_.announced.begin(), instruments_.announced.end(), false);
+    return true;
+}
+
+IPC::IPCSender::SendResult FeedProcessing::AnnounceInstrument(ExchangeTypes::InstrumentId id, bool blocking) {
+    if (instruments_.announced[id]) {
+        return IPC::IPCSender::SendResult::SENT;
+    }
+
+    ExchangeTypes::WireInstrument record;
+    if (!MakeInstrumentRecord(id, record)) {
+        return IPC::IPCSender::SendResult::FAILED;
     }
 
-    if (ipc_sender_->SendData(&bbo_update, sizeof(bbo_update))) {
-        std::cout << "BBO UPDATE SENT: " << instrument << " bid=" << current_bbo.first << " ask=" << current_bbo.second << " seq=" << sequence_number
-                  << std::endl;
+    IPC::IPCSender::SendResult result;
+    if (blocking) {
+        result = ipc_sender_->SendData(&record, sizeof(record)) ? IPC::IPCSender::SendResult::SENT : IPC::IPCSender::SendResult::FAILED;
     } else {
-        std::cerr << "Failed to send BBO update for " << instrument << std::endl;
+        result = ipc_sender_->TrySendData(&record, sizeof(record));
     }
-}
\ No newline at end of file
+    instruments_.announced[id] = result == IPC::IPCSender::SendResult::SENT;
+    return result;
+}
+
+bool FeedProcessing::MakeInstrumentRecord(ExchangeTypes::InstrumentId id, ExchangeTypes::WireInstrument &record) const {
+    const auto &registry = data_normalizer_.GetInstrumentRegistry();
+    record.instrument_id = id;
+    record.price_decimals = registry.GetPriceDecimals(id);
+    record.quantity_decimals = registry.GetQuantityDecimals(id);
+    if (!record.SetName(registry.GetName(id))) {
+        LOG_ERROR("Instrument name too long to publish: {}", registry.GetName(id));
+        return false;
+    }
+    return true;
+}
+
+bool FeedProcessing::EnableBboBroadcast(const std::string &ring_path, const IPC::BroadcastSender::Config &config) {
+    auto broadcast = std::make_unique<IPC::BroadcastSender>(ring_path, config);
+    if (!broadcast->Initialize()) {
+        LOG_ERROR("Failed to create BBO broadcast ring: {}", ring_path);
+        return false;
+    }
+    bbo_broadcast_ = std::move(broadcast);
+    broadcast_reader_generation_ = 0;
+    std::fill(instruments_.broadcast_announced.begin(), instruments_.broadcast_announced.end(), false);
+    return true;
+}
+
+bool FeedProcessing::EnableCapture(const std::string &path, const IPC::CaptureWriter::Config &config) {
+    auto capture = std::make_unique<IPC::CaptureWriter>(config);
+    if (!capture->Open(path)) {
+        LOG_ERROR("Failed to open capture file: {}", path);
+        return false;
+    }
+    capture_ = std::move(capture);
+    return true;
+}
+
+void FeedProcessing::BroadcastBboUpdate(ExchangeTypes::InstrumentId id, const OrderbookTypes::BboUpdate &update) {
+    // Receivers that attached or were lapped since the last BBO may have
+    // missed every announcement; everything sent from here on lands past
+    // their cursor
+    uint32_t generation = bbo_broadcast_->GetReaderGeneration();
+    if (generation != broadcast_reader_generation_) {
+        broadcast_reader_generation_ = generation;
+        std::fill(instruments_.broadcast_announced.begin(), instruments_.broadcast_announced.end(), false);
+    }
+
+    if (!instruments_.broadcast_announced[id]) {
+        ExchangeTypes::WireInstrument record;
+        if (!MakeInstrumentRecord(id, record) || !bbo_broadcast_->SendData(&record, sizeof(record))) {
+            return;
+        }
+        instruments_.broadcast_announced[id] = true;
+    }
+
+    if (!bbo_broadcast_->SendData(&update, sizeof(update))) {
+        LOG_ERROR("Failed to broadcast BBO update for {}", data_normalizer_.GetInstrumentRegistry().GetName(id));
+    }
+}
+
+void FeedProcessing::EnableBboConflation(uint64_t max_latency_us) {
+    if (!bbo_conflator_) {
+        bbo_conflator_ = std::make_unique<BboConflator>();
+    }
+    conflation_max_latency_us_ = max_latency_us;
+}
+
+bool FeedProcessing::HasUnsentBbos() const { return bbo_conflator_ && (!bbo_conflator_->Empty() || ipc_sender_->HasPendingData()); }
+
+bool FeedProcessing::FlushConflatedBbos() {
+    if (!HasUnsentBbos()) {
+        return false;
+    }
+    if (!EnsureBboSenderConnected()) {
+        return true;
+    }
+
+    uint64_t now = now_micros();
+    while (!bbo_conflator_->Empty()) {
+        ExchangeTypes::InstrumentId id = bbo_conflator_->Front();
+        const OrderbookTypes::BboUpdate &update = bbo_conflator_->Get(id);
+
+        auto result = AnnounceInstrument(id, false);
+        if (result == IPC::IPCSender::SendResult::SENT) {
+            result = ipc_sender_->TrySendData(&update, sizeof(update));
+        }
+        if (result == IPC::IPCSender::SendResult::WOULD_BLOCK) {
+            bool overdue = conflation_max_latency_us_ > 0 && now - bbo_conflator_->GetPendingSince(id) >= conflation_max_latency_us_;
+            if (!overdue) {
+                return true;
+            }
+            result = AnnounceInstrument(id, true) == IPC::IPCSender::SendResult::SENT && ipc_sender_->SendData(&update, sizeof(update)) &&
+                             ipc_sender_->Flush()
+                         ? IPC::IPCSender::SendResult::SENT
+                         : IPC::IPCSender::SendResult::FAILED;
+        }
+
+        // The consumer went away: the BBO waits for the reconnect, which
+        // announces the instruments again
+        if (result == IPC::IPCSender::SendResult::FAILED && !ipc_sender_->IsConnected()) {
+            LOG_ERROR("BBO consumer at {} disconnected", bbo_output_socket_path_);
+            return true;
+        }
+
+        const std::string &instrument = data_normalizer_.GetInstrumentRegistry().GetName(id);
+        if (result == IPC::IPCSender::SendResult::SENT) {
+            LOG_DEBUG("BBO UPDATE SENT: {} bid={} ask={} seq={}", instrument, update.GetBestBid(), update.GetBestAsk(), update.sequence_number);
+        } else {
+            LOG_ERROR("Failed to send BBO update for {}", instrument);
+        }
+        bbo_conflator_->Pop();
+    }
+
+    // The BBOs taken above are batched; whatever the socket does not accept
+    // now stays buffered for the next call
+    return ipc_sender_->TryFlush() == IPC::IPCSender::SendResult::WOULD_BLOCK;
+}
+
+const Telemetry::LatencyRecorder *FeedProcessing::EnableLatencyTracking(const Telemetry::LatencyRecorder::Config &config) {
+    if (!latency_recorder_) {
+        latency_recorder_ = std::make_unique<Telemetry::LatencyRecorder>(config);
+    }
+    return latency_recorder_.get();
+}
+
+void FeedProcessing::RecordMessageLatency(const ExchangeTypes::NormalizedMessage &msg) {
+    ExchangeTypes::InstrumentId id = msg.instrument_id;
+    if (!EnsureInstrument(id)) {
+        return;
+    }
+    if (!latency_recorder_->HasInstrument(id)) {
+        latency_recorder_->AddInstrument(id, data_normalizer_.GetInstrumentRegistry().GetName(id));
+    }
+
+    uint64_t now = Telemetry::NowNanos();
+    const IPC::FrameTimestamps &frame = frame_timestamps_;
+    uint64_t origin = frame.origin_ns ? frame.origin_ns : frame.receive_ns;
+
+    // Exchange t is in milliseconds; trade messages carry it per trade
+    uint64_t exchange_ms = msg.t;
+    if (msg.header.type == ExchangeTypes::MessageType::TRADE && msg.num_trades > 0) {
+        exchange_ms = msg.Trades().back().t;
+    }
+    if (exchange_ms > 0) {
+        RecordLatency(id, Telemetry::LatencySpan::EXCHANGE_TO_RECEIVE, exchange_ms * 1000000, origin);
+    }
+
+    if (frame.origin_ns && frame.send_ns) {
+        RecordLatency(id, Telemetry::LatencySpan::RECEIVE_TO_SEND, frame.origin_ns, frame.send_ns);
+    }
+    if (frame.send_ns) {
+        RecordLatency(id, Telemetry::LatencySpan::IPC_TRANSIT, frame.send_ns, frame.receive_ns);
+    }
+    RecordLatency(id, Telemetry::LatencySpan::PARSE, frame.receive_ns, frame_parsed_ns_);
+    RecordLatency(id, Telemetry::LatencySpan::BOOK_APPLY, frame_parsed_ns_, now);
+    instruments_.applied_ns[id] = now;
+}
+
+void FeedProcessing::RecordLatency(ExchangeTypes::InstrumentId id, Telemetry::LatencySpan span, uint64_t start_ns, uint64_t end_ns) {
+    // Stamps from different processes can be slightly out of order
+    if (start_ns == 0 || end_ns < start_ns) {
+        return;
+    }
+    latency_recorder_->Record(id, span, end_ns - start_ns);
+}
@@ -1,46 +1,269 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
+#include "BboConflator.h"
 #include "DataNormalization.h"
-#include "IPCConnection/IPCReceiver.h"
+#include "TradeFlowAggregator.h"
+#include "IPCConnection/BroadcastSender.h"
+#include "IPCConnection/CaptureWriter.h"
+#include "IPCConnection/EventLoop.h"
 #include "IPCConnection/IPCSender.h"
+#include "IPCConnection/ReceiverGroup.h"
+#include "Orderbook/AnyOrderbook.h"
+#include "Orderbook/BookView.h"
+#include "Orderbook/DepthHistory.h"
 #include "Orderbook/Orderbook.h"
 #include "Orderbook/OrderbookTypes.h"
+#include "Telemetry/LatencyRecorder.h"
 #include "Types/ExchangeBookTypes.h"
+#include "Types/NormalizedMessage.h"
 #include "Types/SharedTypes.h"
+#include "Types/TradeFlowTypes.h"
+#include "Types/WireFormat.h"
 
 class FeedProcessing {
   public:
+    using SnapshotRequestCallback = std::function<void(const std::string &instrument)>;
+
+    // An empty data_input_socket_path creates no receiver; frames are then
+    // fed in through ProcessFrame (as ShardedFeedProcessing's workers do)
     explicit FeedProcessing(const std::string &data_input_socket_path, const std::string &bbo_output_socket_path = "/tmp/default_bbo_output.sock");
     ~FeedProcessing() = default;
 
+    // Listens on another input socket, so several connectivity processes can
+    // feed the same books. Frames of all inputs are processed on the Run()
+    // thread as they arrive; with redundant feeds of one instrument, deltas
+    // and snapshots no newer than the book are ignored as stale. Call before Run().
+    bool AddInput(const std::string &data_input_socket_path);
+
+    // Receiver settings for inputs added from now on, e.g. io_backend =
+    // IO_URING to read every upstream connection through one io_uring.
+    // Construct with an empty input path to apply them to all inputs.
+    void SetInputConfig(const IPC::IPCReceiver::Config &config) { inputs_.SetReceiverConfig(config); }
+
+    // Spin on the inputs instead of sleeping in epoll_wait while idle: lower
+    // latency at the cost of a busy core. Call before Run().
+    void SetBusyPoll(bool busy_poll) { event_loop_.SetBusyPoll(busy_poll); }
+
+    // Serves the inputs until max_messages have been processed or Stop() is
+    // called. Upstreams may connect, drop and reconnect at any time.
     void Run(std::optional<size_t> max_messages = std::nullopt);
 
+    // Thread-safe: makes Run() return after the frames it is handling
+    void Stop();
+
+    // Parses and applies every message in a frame, then publishes; returns
+    // the number of messages in the frame (parsed or failed). timestamps are
+    // the frame's pipeline stamps for latency tracking; a zero receive_ns
+    // means the frame was received now.
+    size_t ProcessFrame(std::string_view frame, const IPC::FrameTimestamps &timestamps = {});
+
     uint64_t GetBookSnapshotCount() const { return book_snapshot_count_; }
     uint64_t GetBookDeltaCount() const { return book_delta_count_; }
     uint64_t GetTradeCount() const { return trade_count_; }
 
+    // Book engine used for instruments without an explicit config. Takes
+    // effect for books created after the call (i.e. on the next snapshot).
+    // An invalid config (a tick ladder without a positive tick size) is
+    // refused and the previous one kept.
+    bool SetDefaultOrderbookConfig(const OrderbookConfig &config);
+    bool SetOrderbookConfig(const std::string &instrument, const OrderbookConfig &config);
+
+    // Fixed-point precision used when parsing the instrument's prices and
+    // sizes (default ExchangeTypes::kDefaultDecimals), at most
+    // ExchangeTypes::kMaxDecimalDigits. Messages with non-zero digits beyond
+    // this precision are rejected rather than rounded, as are messages with
+    // a value of more than kMaxDecimalDigits - decimals integer digits.
+    bool SetInstrumentDecimals(const std::string &instrument, uint8_t price_decimals, uint8_t quantity_decimals);
+
+    // Publishes a seqlock-protected top-N view of the instrument's book after
+    // every applied update. Call before Run(); the returned view stays valid
+    // for the lifetime of this object and may be read from any thread.
+    const BookView *EnableBookView(const std::string &instrument);
+
+    // Keeps a bounded, queryable history of the instrument's book changes and
+    // BBOs. Same threading contract as EnableBookView.
+    const DepthHistory *EnableDepthHistory(const std::string &instrument, const DepthHistory::Config &config = {});
+
+    // Aggregates the instrument's trades (rolling VWAP, signed volume and
+    // imbalance, trade-count bars, realized variance) and attaches the stats
+    // to its BboUpdates, which are then also sent when only the trade flow
+    // changed. Call before Run().
+    void EnableTradeFlow(const std::string &instrument, const TradeFlowAggregator::Config &config = {});
+
+    // Latest trade-flow stats, or nullptr if not enabled. Not synchronized:
+    // read from the processing thread or after Run() returns.
+    const ExchangeTypes::TradeFlowStats *GetTradeFlowStats(ExchangeTypes::InstrumentId id) const;
+
+    // Called with the instrument name when a delta does not continue the
+    // instrument's pu chain (e.g. bound to ExchangeWebsocketClient::RequestSnapshot).
+    // Until the next snapshot arrives the instrument's deltas are buffered;
+    // the snapshot is then loaded and the buffered deltas that connect to it
+    // are replayed. Without a callback the book waits for the feed's next
+    // snapshot the same way.
+    void SetSnapshotRequestCallback(SnapshotRequestCallback callback) { snapshot_request_callback_ = std::move(callback); }
+
+    // Conflates BBO publication: changed BBOs go into a per-instrument
+    // latest-value slot and are sent with non-blocking writes as the output
+    // socket accepts them, so a slow consumer gets the freshest BBOs and never
+    // blocks the feed. With max_latency_us > 0, a BBO that has waited that long
+    // is sent with a blocking write instead (bounding staleness at the cost of
+    // stalling while the consumer catches up). Call before Run().
+    void EnableBboConflation(uint64_t max_latency_us = 0);
+
+    // Sends the conflated BBOs the output socket accepts now; returns true if
+    // any are still waiting. Run() calls this itself; callers driving
+    // ProcessFrame directly should call it while their input is idle.
+    bool FlushConflatedBbos();
+
+    uint64_t GetConflatedBboCount() const { return bbo_conflator_ ? bbo_conflator_->GetConflatedCount() : 0; }
+
+    // Failed attempts to (re)connect to the BBO output socket. While it is
+    // missing, attempts back off exponentially from 1 ms to 1 s.
+    uint64_t GetOutputConnectFailureCount() const { return output_connect_failure_count_; }
+
+    // Also publishes every BBO, as soon as it changes, on a shared-memory
+    // broadcast ring at ring_path that any number of IPC::BroadcastReceivers
+    // (pricer, risk, recorder...) read independently. Publishing costs the
+    // same however many attach and never waits: a receiver a whole ring
+    // behind loses the oldest records and sees the overrun. Instruments are
+    // announced again after every attach or overrun, so every receiver can
+    // resolve the ids of the BBOs that follow. With an empty
+    // bbo_output_socket_path the ring is the only output. Call before Run().
+    bool EnableBboBroadcast(const std::string &ring_path, const IPC::BroadcastSender::Config &config = {});
+
+    // Records every input frame, with its origin time, to a capture file at
+    // path for IPC::CaptureReader to replay. Frames are written out a buffer
+    // at a time (asynchronously with io_backend = IO_URING) and flushed when
+    // Run() returns. Call before Run().
+    bool EnableCapture(const std::string &path, const IPC::CaptureWriter::Config &config = {});
+
+    // Records every Telemetry::LatencySpan per instrument, from the frames'
+    // IPC timestamps through parse, book apply and BBO send. Frame-level
+    // spans are recorded once per message in the frame. Call before Run();
+    // the recorder may be read (or handed to a Telemetry::LatencyReporter)
+    // from any thread.
+    const Telemetry::LatencyRecorder *EnableLatencyTracking(const Telemetry::LatencyRecorder::Config &config = {});
+
+    ExchangeTypes::InstrumentId GetInstrumentId(const std::string &instrument) const;
+    uint64_t GetInstrumentMessageCount(ExchangeTypes::InstrumentId id) const;
+    bool IsRecovering(ExchangeTypes::InstrumentId id) const;
+    uint64_t GetSequenceGapCount() const { return sequence_gap_count_; }
+
+    // Messages dropped for exceeding ExchangeTypes::kMaxNormalizedLevels
+    // levels per side or kMaxNormalizedTrades trades. A dropped book message
+    // puts the instrument into recovery, as a sequence gap does.
+    uint64_t GetTruncatedMessageCount() const { return truncated_message_count_; }
+
   private:
-    void ProcessMessage(const std::string &message);
-    void ProcessBookSnapshot(const ExchangeTypes::BookSnapshotResponse *msg);
-    void ProcessBookDelta(const ExchangeTypes::BookDeltaResponse *msg);
-    void SendBboUpdate(const std::string &instrument, uint64_t sequence_number);
+    // Deltas held during recovery as consecutive WireMarketMessage records,
+    // so each costs its used levels rather than a full NormalizedMessage; the
+    // bytes are reused across recoveries
+    struct BufferedDeltas {
+        ExchangeTypes::MessageBuffer records;
+        size_t count = 0;
+    };
+
+    // Per-instrument state as parallel arrays indexed by InstrumentId, so the
+    // processing path does array lookups instead of hashing instrument names.
+    struct InstrumentTable {
+        std::vector<std::optional<AnyOrderbook>> orderbooks;
+        std::vector<uint64_t> last_sequence_numbers;
+        std::vector<std::optional<std::pair<Price, Price>>> last_bbo;
+        std::vector<std::optional<OrderbookConfig>> orderbook_configs;
+        std::vector<uint64_t> message_counts;
+        std::vector<std::unique_ptr<BookView>> book_views;
+        std::vector<std::unique_ptr<DepthHistory>> depth_histories;
+        std::vector<uint64_t> last_timestamps;
+        std::vector<std::unique_ptr<TradeFlowAggregator>> trade_flows;
+        std::vector<bool> pending_publish;
+        std::vector<bool> book_changed;
+        std::vector<bool> trade_flow_changed;
+        std::vector<uint64_t> applied_ns; // latency tracking: when the last message was applied
+        std::vector<bool> recovering;
+        std::vector<BufferedDeltas> buffered_deltas;
+        std::vector<bool> announced;           // WireInstrument sent on the current output connection
+        std::vector<bool> broadcast_announced; // ...and on the broadcast ring since a receiver last attached or was lapped
+
+        size_t Size() const { return orderbooks.size(); }
+        void Resize(size_t size);
+    };
+
+    void ProcessMessage(const ExchangeTypes::NormalizedMessage &msg);
+    void DropTruncatedMessage(const ExchangeTypes::NormalizedMessage &msg);
+    void ProcessBookSnapshot(const ExchangeTypes::NormalizedMessage &msg);
+    void ProcessBookDelta(const ExchangeTypes::NormalizedMessage &msg);
+    // Msg is a NormalizedMessage or a buffered WireMarketMessage
+    template <typename Msg> void ApplyBookDelta(ExchangeTypes::InstrumentId id, const Msg &msg);
+
+    // Gap recovery: deltas are held while waiting for a snapshot, bounded by
+    // kMaxBufferedDeltas (on overflow the buffer is dropped and a newer
+    // snapshot requested)
+    static constexpr size_t kMaxBufferedDeltas = 256;
+    void BufferDelta(ExchangeTypes::InstrumentId id, const ExchangeTypes::NormalizedMessage &msg);
+    void ReplayBufferedDeltas(ExchangeTypes::InstrumentId id);
+    void RequestSnapshot(ExchangeTypes::InstrumentId id);
+    void ProcessTrades(const ExchangeTypes::NormalizedMessage &msg);
+    void SendBboUpdate(ExchangeTypes::InstrumentId id, uint64_t sequence_number, bool trade_flow_changed);
+    bool EnsureBboSenderConnected();
+    IPC::IPCSender::SendResult AnnounceInstrument(ExchangeTypes::InstrumentId id, bool blocking);
+    bool MakeInstrumentRecord(ExchangeTypes::InstrumentId id, ExchangeTypes::WireInstrument &record) const;
+    void BroadcastBboUpdate(ExchangeTypes::InstrumentId id, const OrderbookTypes::BboUpdate &update);
+    bool HasUnsentBbos() const;
+    void RecordMessageLatency(const ExchangeTypes::NormalizedMessage &msg);
+    void RecordLatency(ExchangeTypes::InstrumentId id, Telemetry::LatencySpan span, uint64_t start_ns, uint64_t end_ns);
+    void PublishBookView(ExchangeTypes::InstrumentId id, uint64_t sequence_number, uint64_t timestamp);
+    void MarkPendingPublish(ExchangeTypes::InstrumentId id);
+    void MarkTradeFlowChanged(ExchangeTypes::InstrumentId id);
+    void EnqueuePublish(ExchangeTypes::InstrumentId id);
+    void PublishPendingInstruments();
+
+    // Grows the instrument table to cover id; returns false for invalid ids
+    bool EnsureInstrument(ExchangeTypes::InstrumentId id);
 
-    std::unique_ptr<IPC::IPCReceiver> ipc_receiver_;
-    std::unique_ptr<IPC::IPCSender> ipc_sender_;
     std::string bbo_output_socket_path_;
+    IPC::EventLoop event_loop_;
+    IPC::ReceiverGroup inputs_;
+    std::unique_ptr<IPC::IPCSender> ipc_sender_;
+    std::unique_ptr<IPC::BroadcastSender> bbo_broadcast_;
+    std::unique_ptr<IPC::CaptureWriter> capture_;
+    uint32_t broadcast_reader_generation_ = 0;
+    std::atomic<bool> stop_requested_{false};
+    size_t run_message_count_ = 0;
     DataNormalization data_normalizer_;
 
-    std::unordered_map<std::string, std::unique_ptr<Orderbook>> orderbooks_;
-    std::unordered_map<std::string, uint64_t> last_sequence_numbers_;
-    std::unordered_map<std::string, std::pair<Price, Price>> last_bbo_;
+    InstrumentTable instruments_;
+    OrderbookConfig default_orderbook_config_;
+    SnapshotRequestCallback snapshot_request_callback_;
+
+    std::unique_ptr<BboConflator> bbo_conflator_;
+    uint64_t conflation_max_latency_us_ = 0;
+
+    uint64_t reconnect_backoff_us_ = 0; // 0 while the output is connected or not yet tried
+    uint64_t next_reconnect_us_ = 0;
+    uint64_t output_connect_failure_count_ = 0;
+
+    std::unique_ptr<Telemetry::LatencyRecorder> latency_recorder_;
+    IPC::FrameTimestamps frame_timestamps_; // of the frame being processed
+    uint64_t frame_parsed_ns_ = 0;
+
+    // Scratch buffers reused across messages to avoid per-message allocation
+    ExchangeTypes::NormalizedBatch normalized_batch_;
+    std::vector<ExchangeTypes::InstrumentId> pending_instruments_;
+    std::vector<BookUpdate> snapshot_bids_;
+    std::vector<BookUpdate> snapshot_asks_;
+    BookViewSnapshot book_view_scratch_;
 
     uint64_t book_snapshot_count_ = 0;
     uint64_t book_delta_count_ = 0;
     uint64_t trade_count_ = 0;
+    uint64_t sequence_gap_count_ = 0;
+    uint64_t truncated_message_count_ = 0;
 };
@@ -1,8 +1,14 @@
 #include "FeedProcessing.h"
+#include "IPCConnection/BroadcastReceiver.h"
+#include "IPCConnection/CaptureReader.h"
+#include "IPCConnection/IPCReceiver.h"
 #include "IPCConnection/IPCSender.h"
+#include "Telemetry/Clock.h"
 #include <chrono>
+#include <cstring>
 #include <gtest/gtest.h>
 #include <thread>
+#include <unistd.h>
 
 TEST(FeedProcessingTest, ParseValidOrderBookUpdate) {
     const std::string input_socket_path = "/tmp/market_data_input.sock";
@@ -232,4 +238,741 @@ TEST(FeedProcessingTest, ParseMixedMessages) {
     EXPECT_EQ(fp.GetBookSnapshotCount(), 1);
     EXPECT_EQ(fp.GetBookDeltaCount(), 1);
     EXPECT_EQ(fp.GetTradeCount(), 1);
-}
\ No newline at end of file
+}
+TEST(FeedProcessingTest, PublishesBookView) {
+    const std::string input_socket_path = "/tmp/view_market_data.sock";
+    const std::string bbo_socket_path = "/tmp/view_bbo_output.sock";
+
+    FeedProcessing fp(input_socket_path, bbo_socket_path);
+    const BookView *view = fp.EnableBookView("ETHUSD-PERP");
+    ASSERT_NE(view, nullptr);
+    EXPECT_EQ(view->GetVersion(), 0);
+
+    std::thread fp_thread([&fp]() { fp.Run(2); });
+
+    // Initial Delay
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    IPC::IPCSender sender;
+    EXPECT_TRUE(sender.Connect(input_socket_path));
+
+    std::string snapshot = R"({
+        "id": -1, "method": "subscribe", "code": 0,
+        "result": {
+            "instrument_name": "ETHUSD-PERP", "subscription": "book.ETHUSD-PERP.10", "channel": "book", "depth": 10,
+            "data": [{
+                "asks": [["2500.00", "1.0", "1"], ["2501.00", "2.0", "2"]],
+                "bids": [["2499.00", "1.5", "1"], ["2498.00", "0.5", "1"]],
+                "tt": 1647917462799, "t": 1647917463000, "u": 100
+            }]
+        }
+    })";
+
+    std::string delta = R"({
+        "id": -1, "method": "subscribe", "code": 0,
+        "result": {
+            "instrument_name": "ETHUSD-PERP", "subscription": "book.ETHUSD-PERP.10", "channel": "book.update", "depth": 10,
+            "data": [{
+                "update": {"asks": [["2500.00", "0", "0"]], "bids": [["2499.50", "3.0", "1"]]},
+                "tt": 1647917463003, "t": 1647917463003, "u": 101, "pu": 100
+            }]
+        }
+    })";
+
+    EXPECT_TRUE(sender.SendData(snapshot.c_str(), snapshot.size()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(sender.SendData(delta.c_str(), delta.size()));
+
+    fp_thread.join();
+
+    auto book = view->Load();
+    EXPECT_EQ(view->GetVersion(), 2);
+    EXPECT_EQ(book.sequence_number, 101);
+    EXPECT_EQ(book.num_bids, 3);
+    EXPECT_EQ(book.num_asks, 1);
+    EXPECT_EQ(book.BestBid(), 2499.50);
+    EXPECT_EQ(book.bids[0].volume, 3.0);
+    EXPECT_EQ(book.BestAsk(), 2501.00);
+}
+
+TEST(FeedProcessingTest, AppliesBatchedFrameAndPublishesOncePerInstrument) {
+    const std::string input_socket_path = "/tmp/batch_market_data.sock";
+    const std::string bbo_socket_path = "/tmp/batch_bbo_output.sock";
+
+    FeedProcessing fp(input_socket_path, bbo_socket_path);
+    const BookView *eth = fp.EnableBookView("ETHUSD-PERP");
+    const BookView *btc = fp.EnableBookView("BTCUSD-PERP");
+
+    std::thread fp_thread([&fp]() { fp.Run(5); });
+
+    // Initial Delay
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    IPC::IPCSender sender;
+    EXPECT_TRUE(sender.Connect(input_socket_path));
+
+    // One frame, one message per line
+    std::string frame =
+        R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["2501.00", "2.0", "2"]], "bids": [["2499.00", "1.5", "1"]], "t": 1, "u": 100}]}}
+{"result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": [{"asks": [["50001.00", "1.0", "1"]], "bids": [["49999.00", "1.0", "1"]], "t": 1, "u": 7}]}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"bids": [["2499.50", "3.0", "1"]]}, "t": 2, "u": 101, "pu": 100}]}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"asks": [["2500.50", "1.0", "1"]]}, "t": 3, "u": 102, "pu": 101}]}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "trade", "data": [{"d": "1", "t": 3, "p": "2500.00", "q": "0.1", "s": "SELL"}]}}
+)";
+
+    EXPECT_TRUE(sender.SendData(frame.c_str(), frame.size()));
+
+    fp_thread.join();
+
+    EXPECT_EQ(fp.GetBookSnapshotCount(), 2);
+    EXPECT_EQ(fp.GetBookDeltaCount(), 2);
+    EXPECT_EQ(fp.GetTradeCount(), 1);
+
+    EXPECT_EQ(eth->GetVersion(), 1);
+    EXPECT_EQ(btc->GetVersion(), 1);
+
+    auto book = eth->Load();
+    EXPECT_EQ(book.sequence_number, 102);
+    EXPECT_EQ(book.timestamp, 3);
+    EXPECT_EQ(book.BestBid(), 2499.50);
+    EXPECT_EQ(book.BestAsk(), 2500.50);
+    EXPECT_EQ(btc->Load().BestBid(), 49999.00);
+}
+
+TEST(FeedProcessingTest, RecoversFromSequenceGapWithBufferedDeltas) {
+    const std::string input_socket_path = "/tmp/gap_market_data.sock";
+    const std::string bbo_socket_path = "/tmp/gap_bbo_output.sock";
+
+    FeedProcessing fp(input_socket_path, bbo_socket_path);
+    const BookView *view = fp.EnableBookView("ETHUSD-PERP");
+
+    std::vector<std::string> requests;
+    fp.SetSnapshotRequestCallback([&requests](const std::string &instrument) { requests.push_back(instrument); });
+
+    std::thread fp_thread([&fp]() { fp.Run(7); });
+
+    // Initial Delay
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    IPC::IPCSender sender;
+    EXPECT_TRUE(sender.Connect(input_socket_path));
+
+    // u=102 is lost: 103 opens the gap and is buffered with 104 until the
+    // snapshot at 102 arrives, after which both are replayed. The stale 101
+    // re-sent after recovery is ignored.
+    std::string frame =
+        R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["2501.00", "2.0", "2"]], "bids": [["2499.00", "1.5", "1"]], "t": 1, "u": 100}]}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"bids": [["2499.25", "1.0", "1"]]}, "t": 2, "u": 101, "pu": 100}]}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"bids": [["2499.75", "1.0", "1"]]}, "t": 4, "u": 103, "pu": 102}]}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"asks": [["2500.50", "1.0", "1"]]}, "t": 5, "u": 104, "pu": 103}]}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["2501.00", "2.0", "2"]], "bids": [["2499.50", "1.0", "1"]], "t": 3, "u": 102}]}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"bids": [["2499.25", "1.0", "1"]]}, "t": 2, "u": 101, "pu": 100}]}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"bids": [["2499.00", "4.0", "1"]]}, "t": 6, "u": 105, "pu": 104}]}}
+)";
+
+    EXPECT_TRUE(sender.SendData(frame.c_str(), frame.size()));
+
+    fp_thread.join();
+
+    ASSERT_EQ(requests.size(), 1);
+    EXPECT_EQ(requests[0], "ETHUSD-PERP");
+    EXPECT_EQ(fp.GetSequenceGapCount(), 1);
+    EXPECT_FALSE(fp.IsRecovering(fp.GetInstrumentId("ETHUSD-PERP")));
+
+    auto book = view->Load();
+    EXPECT_EQ(book.sequence_number, 105);
+    EXPECT_EQ(book.BestBid(), 2499.75);
+    EXPECT_EQ(book.BestAsk(), 2500.50);
+    EXPECT_EQ(book.num_bids, 3);
+    EXPECT_EQ(book.bids[2].volume, 4.0);
+}
+
+TEST(FeedProcessingTest, DropsTruncatedBookMessagesAndRecovers) {
+    FeedProcessing fp("", "");
+    const BookView *view = fp.EnableBookView("ETHUSD-PERP");
+    std::vector<std::string> requests;
+    fp.SetSnapshotRequestCallback([&requests](const std::string &instrument) { requests.push_back(instrument); });
+
+    auto levels = [](int count, int base) {
+        std::string out;
+        for (int i = 0; i < count; ++i) {
+            out += (i ? ", " : "") + std::string(R"([")") + std::to_string(base + i) + R"(.00", "1.0", "1"])";
+        }
+        return out;
+    };
+    auto snapshot = [&levels](int num_bids, uint64_t sequence) {
+        return R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [)" + levels(1, 3000) + R"(], "bids": [)" +
+               levels(num_bids, 2000) + R"(], "t": 1, "u": )" + std::to_string(sequence) + "}]}}";
+    };
+    auto delta = [&levels](int num_bids, uint64_t sequence) {
+        return R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"bids": [)" + levels(num_bids, 1000) +
+               R"(]}, "t": 2, "u": )" + std::to_string(sequence) + R"(, "pu": )" + std::to_string(sequence - 1) + "}]}}";
+    };
+    ExchangeTypes::InstrumentId id = fp.GetInstrumentId("ETHUSD-PERP");
+
+    // A snapshot deeper than a message holds is not loaded as if complete
+    fp.ProcessFrame(snapshot(ExchangeTypes::kMaxNormalizedLevels + 1, 100));
+    EXPECT_EQ(fp.GetTruncatedMessageCount(), 1u);
+    EXPECT_TRUE(fp.IsRecovering(id));
+    EXPECT_EQ(view->Load().sequence_number, 0u);
+    ASSERT_EQ(requests.size(), 1u);
+
+    fp.ProcessFrame(snapshot(ExchangeTypes::kMaxNormalizedLevels, 101));
+    EXPECT_FALSE(fp.IsRecovering(id));
+    EXPECT_EQ(view->Load().sequence_number, 101u);
+    EXPECT_EQ(view->Load().BestBid(), 2049.00);
+
+    // Neither is a delta: the deltas chained to it are held until a new snapshot
+    fp.ProcessFrame(delta(ExchangeTypes::kMaxNormalizedLevels + 1, 102));
+    fp.ProcessFrame(delta(1, 103));
+    EXPECT_EQ(fp.GetTruncatedMessageCount(), 2u);
+    EXPECT_TRUE(fp.IsRecovering(id));
+    EXPECT_EQ(requests.size(), 2u);
+    EXPECT_EQ(view->Load().sequence_number, 101u);
+
+    fp.ProcessFrame(snapshot(1, 102));
+    EXPECT_FALSE(fp.IsRecovering(id));
+    EXPECT_EQ(view->Load().sequence_number, 103u);
+}
+
+TEST(FeedProcessingTest, KeepsBufferedDeltasPastSnapshotThatDoesNotConnect) {
+    FeedProcessing fp("", "");
+    const BookView *view = fp.EnableBookView("ETHUSD-PERP");
+    size_t requests = 0;
+    fp.SetSnapshotRequestCallback([&requests](const std::string &) { requests++; });
+
+    auto snapshot = [](uint64_t sequence) {
+        return R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["3000.00", "1.0", "1"]], "bids": [["2000.00", "1.0", "1"]], "t": 1, "u": )" +
+               std::to_string(sequence) + "}]}}";
+    };
+    auto delta = [](uint64_t sequence, const std::string &bids) {
+        return R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"bids": [)" + bids + R"(]}, "t": 2, "u": )" +
+               std::to_string(sequence) + R"(, "pu": )" + std::to_string(sequence - 1) + "}]}}";
+    };
+    ExchangeTypes::InstrumentId id = fp.GetInstrumentId("ETHUSD-PERP");
+
+    fp.ProcessFrame(snapshot(100));
+    fp.ProcessFrame(delta(102, R"(["2001.00", "1.0", "1"], ["1999.00", "1.0", "1"])"));
+    fp.ProcessFrame(delta(103, R"(["2002.00", "1.0", "1"])"));
+    fp.ProcessFrame(delta(105, R"(["2004.00", "1.0", "1"], ["1998.00", "1.0", "1"], ["1997.00", "1.0", "1"])"));
+    fp.ProcessFrame(delta(106, R"(["2005.00", "1.0", "1"])"));
+    EXPECT_TRUE(fp.IsRecovering(id));
+    EXPECT_EQ(requests, 1u);
+
+    // 102 and 103 continue this snapshot; 105 does not, so it and 106 wait
+    fp.ProcessFrame(snapshot(101));
+    EXPECT_TRUE(fp.IsRecovering(id));
+    EXPECT_EQ(requests, 2u);
+    EXPECT_EQ(view->Load().sequence_number, 103u);
+    EXPECT_EQ(view->Load().BestBid(), 2002.00);
+
+    fp.ProcessFrame(snapshot(104));
+    EXPECT_FALSE(fp.IsRecovering(id));
+    auto book = view->Load();
+    EXPECT_EQ(book.sequence_number, 106u);
+    EXPECT_EQ(book.BestBid(), 2005.00);
+    EXPECT_EQ(book.num_bids, 5);
+    EXPECT_EQ(book.bids[4].price, 1997.00);
+}
+
+TEST(FeedProcessingTest, AggregatesTradeFlowAndPublishesWithBbo) {
+    const std::string input_socket_path = "/tmp/trade_flow_market_data.sock";
+    const std::string bbo_socket_path = "/tmp/trade_flow_bbo_output.sock";
+
+    IPC::IPCReceiver bbo_receiver(bbo_socket_path);
+    ASSERT_TRUE(bbo_receiver.Initialize());
+
+    FeedProcessing fp(input_socket_path, bbo_socket_path);
+    TradeFlowAggregator::Config config;
+    config.bar_trades = 2;
+    fp.EnableTradeFlow("ETHUSD-PERP", config);
+
+    std::thread fp_thread([&fp]() { fp.Run(4); });
+
+    // Initial Delay
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    IPC::IPCSender sender;
+    EXPECT_TRUE(sender.Connect(input_socket_path));
+
+    std::string frame =
+        R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["2501.00", "2.0", "2"]], "bids": [["2499.00", "1.5", "1"]], "t": 1, "u": 100}]}}
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "trade", "data": [{"d": "1", "t": 10, "p": "2500.00", "q": "1.0", "s": "BUY"}, {"d": "2", "t": 11, "p": "2501.00", "q": "3.0", "s": "BUY"}]}}
+{"result": {"instrument_name": "BTCUSD-PERP", "channel": "trade", "data": [{"d": "3", "t": 11, "p": "50000.00", "q": "1.0", "s": "SELL"}]}}
+)";
+    std::string trades_only =
+        R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "trade", "data": [{"d": "4", "t": 12, "p": "2499.00", "q": "2.0", "s": "SELL"}]}})";
+
+    EXPECT_TRUE(sender.SendData(frame.c_str(), frame.size()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(sender.SendData(trades_only.c_str(), trades_only.size()));
+
+    fp_thread.join();
+
+    // The instrument is announced ahead of its first BBO
+    auto data = bbo_receiver.ReadData();
+    const auto *instrument = ExchangeTypes::ViewWire<ExchangeTypes::WireInstrument>(data);
+    ASSERT_NE(instrument, nullptr);
+    EXPECT_EQ(instrument->GetName(), "ETHUSD-PERP");
+    ExchangeTypes::InstrumentId eth = instrument->instrument_id;
+    EXPECT_EQ(eth, fp.GetInstrumentId("ETHUSD-PERP"));
+
+    // One BBO per frame: the second carries unchanged prices but new trade flow
+    data = bbo_receiver.ReadData();
+    const auto *bbo = ExchangeTypes::ViewWire<ExchangeTypes::WireBboUpdate>(data);
+    ASSERT_NE(bbo, nullptr);
+    EXPECT_EQ(bbo->instrument_id, eth);
+    EXPECT_DOUBLE_EQ(bbo->GetBestBid(), 2499.0);
+    EXPECT_DOUBLE_EQ(bbo->GetBestAsk(), 2501.0);
+    EXPECT_EQ(bbo->trade_flow.trade_count, 2);
+
+    data = bbo_receiver.ReadData();
+    bbo = ExchangeTypes::ViewWire<ExchangeTypes::WireBboUpdate>(data);
+    ASSERT_NE(bbo, nullptr);
+    EXPECT_EQ(bbo->best_bid, 249900000000);
+    EXPECT_EQ(bbo->trade_flow.trade_count, 3);
+
+    EXPECT_EQ(fp.GetTradeFlowStats(fp.GetInstrumentId("BTCUSD-PERP")), nullptr);
+    const auto *stats = fp.GetTradeFlowStats(fp.GetInstrumentId("ETHUSD-PERP"));
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->trade_count, 3);
+    EXPECT_EQ(stats->timestamp, 12);
+    EXPECT_DOUBLE_EQ(stats->window_volume, 6.0);
+    EXPECT_DOUBLE_EQ(stats->vwap, (2500.0 + 3 * 2501.0 + 2 * 2499.0) / 6.0);
+    EXPECT_DOUBLE_EQ(stats->signed_volume, 2.0);
+    EXPECT_EQ(stats->num_bars, 1);
+}
+
+TEST(FeedProcessingTest, PublishesTradeFlowBeforeAnyBook) {
+    const std::string input_socket_path = "/tmp/trade_only_market_data.sock";
+    const std::string bbo_socket_path = "/tmp/trade_only_bbo_output.sock";
+
+    IPC::IPCReceiver bbo_receiver(bbo_socket_path);
+    ASSERT_TRUE(bbo_receiver.Initialize());
+
+    FeedProcessing fp(input_socket_path, bbo_socket_path);
+    fp.EnableTradeFlow("ETHUSD-PERP");
+
+    std::thread fp_thread([&fp]() { fp.Run(1); });
+
+    // Initial Delay
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    IPC::IPCSender sender;
+    EXPECT_TRUE(sender.Connect(input_socket_path));
+
+    std::string trades =
+        R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "trade", "data": [{"d": "1", "t": 10, "p": "2500.00", "q": "1.0", "s": "BUY"}]}})";
+    EXPECT_TRUE(sender.SendData(trades.c_str(), trades.size()));
+
+    fp_thread.join();
+
+    auto data = bbo_receiver.ReadData();
+    ASSERT_NE(ExchangeTypes::ViewWire<ExchangeTypes::WireInstrument>(data), nullptr);
+
+    // Only the trade channel so far: both sides empty
+    data = bbo_receiver.ReadData();
+    const auto *bbo = ExchangeTypes::ViewWire<ExchangeTypes::WireBboUpdate>(data);
+    ASSERT_NE(bbo, nullptr);
+    EXPECT_EQ(bbo->instrument_id, fp.GetInstrumentId("ETHUSD-PERP"));
+    EXPECT_EQ(bbo->best_bid, 0);
+    EXPECT_EQ(bbo->best_ask, 0);
+    EXPECT_EQ(bbo->trade_flow.trade_count, 1);
+}
+
+TEST(FeedProcessingTest, ConflatesBbosWhileConsumerIsBehind) {
+    const std::string bbo_socket_path = "/tmp/conflation_bbo_output.sock";
+    constexpr uint64_t kBtcSequenceBase = 1000000;
+
+    IPC::IPCReceiver bbo_receiver(bbo_socket_path);
+    ASSERT_TRUE(bbo_receiver.Initialize());
+
+    FeedProcessing fp("", bbo_socket_path);
+    fp.EnableBboConflation();
+
+    auto snapshot = [](const std::string &instrument, uint64_t sequence) {
+        std::string bid = std::to_string(1000 + sequence % 500) + ".00";
+        std::string ask = std::to_string(2000 + sequence % 500) + ".00";
+        return R"({"result": {"instrument_name": ")" + instrument + R"(", "channel": "book", "data": [{"asks": [[")" + ask +
+               R"(", "1.0", "1"]], "bids": [[")" + bid + R"(", "1.0", "1"]], "t": 1, "u": )" + std::to_string(sequence) + "}]}}";
+    };
+
+    // Nobody reads, so the output socket eventually stops taking BBOs; the feed keeps going
+    uint64_t eth_sequence = 0;
+    while (!fp.FlushConflatedBbos() && eth_sequence < 1000000) {
+        fp.ProcessFrame(snapshot("ETHUSD-PERP", ++eth_sequence));
+    }
+    ASSERT_TRUE(fp.FlushConflatedBbos());
+
+    uint64_t btc_sequence = kBtcSequenceBase;
+    for (int i = 0; i < 1000; ++i) {
+        fp.ProcessFrame(snapshot("ETHUSD-PERP", ++eth_sequence));
+        fp.ProcessFrame(snapshot("BTCUSD-PERP", ++btc_sequence));
+    }
+    EXPECT_GE(fp.GetConflatedBboCount(), 1990);
+
+    // The consumer catches up and ends on each instrument's latest BBO
+    size_t received = 0;
+    uint64_t last_eth = 0;
+    uint64_t last_btc = 0;
+    std::thread reader([&]() {
+        while (last_eth != eth_sequence || last_btc != btc_sequence) {
+            auto data = bbo_receiver.ReadData();
+            if (ExchangeTypes::GetWireType(data) == ExchangeTypes::WireType::INSTRUMENT) {
+                continue;
+            }
+
+            const auto *bbo = ExchangeTypes::ViewWire<ExchangeTypes::WireBboUpdate>(data);
+            ASSERT_NE(bbo, nullptr);
+            uint64_t sequence = bbo->sequence_number;
+
+            uint64_t &last = sequence >= kBtcSequenceBase ? last_btc : last_eth;
+            EXPECT_GT(sequence, last);
+            last = sequence;
+            received++;
+        }
+    });
+
+    while (fp.FlushConflatedBbos()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    reader.join();
+
+    EXPECT_EQ(last_eth, eth_sequence);
+    EXPECT_EQ(last_btc, btc_sequence);
+    EXPECT_LT(received, eth_sequence + btc_sequence - kBtcSequenceBase);
+}
+
+TEST(FeedProcessingTest, BacksOffReconnectsWhileConsumerIsMissing) {
+    const std::string bbo_socket_path = "/tmp/backoff_bbo_output.sock";
+    unlink(bbo_socket_path.c_str());
+
+    FeedProcessing fp("", bbo_socket_path);
+    fp.EnableBboConflation();
+
+    std::string snapshot =
+        R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["2501.00", "2.0", "2"]], "bids": [["2499.00", "1.5", "1"]], "t": 1, "u": 100}]}})";
+    fp.ProcessFrame(snapshot);
+
+    // Retried continuously for 100 ms: doubling from 1 ms, that is a handful of attempts
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while (std::chrono::steady_clock::now() < deadline) {
+        EXPECT_TRUE(fp.FlushConflatedBbos());
+    }
+    EXPECT_GE(fp.GetOutputConnectFailureCount(), 2u);
+    EXPECT_LE(fp.GetOutputConnectFailureCount(), 10u);
+
+    // The consumer appears: picked up by a later attempt, the BBO still waiting
+    IPC::IPCReceiver bbo_receiver(bbo_socket_path);
+    ASSERT_TRUE(bbo_receiver.Initialize());
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (fp.FlushConflatedBbos() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_FALSE(fp.FlushConflatedBbos());
+
+    auto data = bbo_receiver.ReadData();
+    EXPECT_EQ(ExchangeTypes::GetWireType(data), ExchangeTypes::WireType::INSTRUMENT);
+    data = bbo_receiver.ReadData();
+    const auto *bbo = ExchangeTypes::ViewWire<ExchangeTypes::WireBboUpdate>(data);
+    ASSERT_NE(bbo, nullptr);
+    EXPECT_EQ(bbo->sequence_number, 100u);
+}
+
+TEST(FeedProcessingTest, ReconnectsToRestartedConsumer) {
+    const std::string bbo_socket_path = "/tmp/restart_bbo_output.sock";
+
+    auto snapshot = [](uint64_t sequence) {
+        return R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [[")" + std::to_string(2500 + sequence) +
+               R"(.00", "1.0", "1"]], "bids": [["2499.00", "1.0", "1"]], "t": 1, "u": )" + std::to_string(sequence) + "}]}}";
+    };
+    auto expect_announced_bbo = [](IPC::IPCReceiver &receiver, uint64_t sequence) {
+        auto data = receiver.ReadData();
+        EXPECT_EQ(ExchangeTypes::GetWireType(data), ExchangeTypes::WireType::INSTRUMENT);
+        data = receiver.ReadData();
+        const auto *bbo = ExchangeTypes::ViewWire<ExchangeTypes::WireBboUpdate>(data);
+        ASSERT_NE(bbo, nullptr);
+        EXPECT_EQ(bbo->sequence_number, sequence);
+    };
+
+    for (bool conflation : {false, true}) {
+        FeedProcessing fp("", bbo_socket_path);
+        if (conflation) {
+            fp.EnableBboConflation();
+        }
+        auto process = [&fp, &snapshot](uint64_t sequence) {
+            fp.ProcessFrame(snapshot(sequence));
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (fp.FlushConflatedBbos() && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        };
+
+        {
+            IPC::IPCReceiver first(bbo_socket_path);
+            ASSERT_TRUE(first.Initialize());
+            process(100);
+            expect_announced_bbo(first, 100);
+        }
+
+        // The consumer is gone: this BBO finds out, and the next one goes to
+        // the restarted consumer together with the announcement it needs
+        process(101);
+        IPC::IPCReceiver second(bbo_socket_path);
+        ASSERT_TRUE(second.Initialize());
+        process(102);
+        expect_announced_bbo(second, 102);
+    }
+}
+
+TEST(FeedProcessingTest, BroadcastsBbosToEveryReceiver) {
+    FeedProcessing fp("", "");
+    ASSERT_TRUE(fp.EnableBboBroadcast("/dev/shm/test_feed_bbo_broadcast"));
+
+    IPC::BroadcastReceiver pricer;
+    IPC::BroadcastReceiver recorder;
+    ASSERT_TRUE(pricer.Connect("/dev/shm/test_feed_bbo_broadcast"));
+    ASSERT_TRUE(recorder.Connect("/dev/shm/test_feed_bbo_broadcast"));
+
+    auto snapshot = [](const std::string &bid, uint64_t sequence) {
+        return R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["2501.00", "2.0", "2"]], "bids": [[")" + bid +
+               R"(", "1.5", "1"]], "t": 1, "u": )" + std::to_string(sequence) + "}]}}";
+    };
+    fp.ProcessFrame(snapshot("2499.00", 100));
+
+    // Each receiver gets the announcement and then the BBO
+    for (IPC::BroadcastReceiver *receiver : {&pricer, &recorder}) {
+        std::vector<uint8_t> data;
+        ASSERT_TRUE(receiver->TryReadData(data));
+        const auto *instrument = ExchangeTypes::ViewWire<ExchangeTypes::WireInstrument>(data);
+        ASSERT_NE(instrument, nullptr);
+        EXPECT_EQ(instrument->GetName(), "ETHUSD-PERP");
+
+        ASSERT_TRUE(receiver->TryReadData(data));
+        const auto *bbo = ExchangeTypes::ViewWire<ExchangeTypes::WireBboUpdate>(data);
+        ASSERT_NE(bbo, nullptr);
+        EXPECT_EQ(bbo->sequence_number, 100);
+        EXPECT_DOUBLE_EQ(bbo->GetBestBid(), 2499.0);
+        EXPECT_FALSE(receiver->TryReadData(data));
+    }
+
+    // A receiver joining later gets the instrument announced again before its next BBO
+    IPC::BroadcastReceiver hedger;
+    ASSERT_TRUE(hedger.Connect("/dev/shm/test_feed_bbo_broadcast"));
+    fp.ProcessFrame(snapshot("2499.50", 101));
+
+    std::vector<uint8_t> data;
+    ASSERT_TRUE(hedger.TryReadData(data));
+    EXPECT_EQ(ExchangeTypes::GetWireType(data), ExchangeTypes::WireType::INSTRUMENT);
+    ASSERT_TRUE(hedger.TryReadData(data));
+    const auto *bbo = ExchangeTypes::ViewWire<ExchangeTypes::WireBboUpdate>(data);
+    ASSERT_NE(bbo, nullptr);
+    EXPECT_EQ(bbo->sequence_number, 101);
+    EXPECT_DOUBLE_EQ(bbo->GetBestBid(), 2499.5);
+
+    ASSERT_TRUE(pricer.TryReadData(data));
+    EXPECT_EQ(ExchangeTypes::GetWireType(data), ExchangeTypes::WireType::INSTRUMENT);
+    ASSERT_TRUE(pricer.TryReadData(data));
+    EXPECT_EQ(ExchangeTypes::GetWireType(data), ExchangeTypes::WireType::BBO_UPDATE);
+}
+
+TEST(FeedProcessingTest, LappedBroadcastReceiverGetsInstrumentsAgain) {
+    FeedProcessing fp("", "");
+    ASSERT_TRUE(fp.EnableBboBroadcast("/dev/shm/test_feed_bbo_lapped", IPC::BroadcastSender::Config{.capacity = 4096}));
+
+    IPC::BroadcastReceiver slow;
+    ASSERT_TRUE(slow.Connect("/dev/shm/test_feed_bbo_lapped"));
+
+    auto snapshot = [](const std::string &instrument, uint64_t sequence) {
+        return R"({"result": {"instrument_name": ")" + instrument + R"(", "channel": "book", "data": [{"asks": [["2501.00", "2.0", "2"]], "bids": [[")" +
+               std::to_string(2000 + sequence) + R"(.00", "1.5", "1"]], "t": 1, "u": )" + std::to_string(sequence) + "}]}}";
+    };
+
+    // The announcements scroll out of the ring while the receiver is not reading
+    for (uint64_t sequence = 1; sequence <= 200; ++sequence) {
+        fp.ProcessFrame(snapshot(sequence % 2 ? "ETHUSD-PERP" : "BTCUSD-PERP", sequence));
+    }
+    std::vector<uint8_t> data;
+    EXPECT_FALSE(slow.TryReadData(data));
+    EXPECT_EQ(slow.GetOverrunCount(), 1u);
+
+    fp.ProcessFrame(snapshot("BTCUSD-PERP", 202));
+    ASSERT_TRUE(slow.TryReadData(data));
+    const auto *instrument = ExchangeTypes::ViewWire<ExchangeTypes::WireInstrument>(data);
+    ASSERT_NE(instrument, nullptr);
+    EXPECT_EQ(instrument->GetName(), "BTCUSD-PERP");
+    ExchangeTypes::InstrumentId id = instrument->instrument_id;
+
+    ASSERT_TRUE(slow.TryReadData(data));
+    const auto *bbo = ExchangeTypes::ViewWire<ExchangeTypes::WireBboUpdate>(data);
+    ASSERT_NE(bbo, nullptr);
+    EXPECT_EQ(bbo->instrument_id, id);
+    EXPECT_EQ(bbo->sequence_number, 202u);
+}
+
+TEST(FeedProcessingTest, CapturesInputsReadThroughIoUring) {
+    const std::string input_socket_path = "/tmp/uring_market_data.sock";
+    const std::string capture_path = "/tmp/test_feed_capture.bin";
+
+    FeedProcessing fp("", "");
+    fp.SetInputConfig(IPC::IPCReceiver::Config{.io_backend = IPC::IoBackend::IO_URING});
+    ASSERT_TRUE(fp.AddInput(input_socket_path));
+    ASSERT_TRUE(fp.EnableCapture(capture_path, IPC::CaptureWriter::Config{.io_backend = IPC::IoBackend::IO_URING}));
+    const BookView *view = fp.EnableBookView("ETHUSD-PERP");
+
+    auto snapshot = [](uint64_t sequence) {
+        return R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["2501.00", "2.0", "2"]], "bids": [["2499.00", "1.5", "1"]], "t": 1, "u": )" +
+               std::to_string(sequence) + "}]}}";
+    };
+
+    std::thread fp_thread([&fp]() { fp.Run(20); });
+    {
+        IPC::IPCSender sender;
+        ASSERT_TRUE(sender.Connect(input_socket_path));
+        for (uint64_t sequence = 1; sequence <= 20; ++sequence) {
+            std::string frame = snapshot(sequence);
+            ASSERT_TRUE(sender.SendTimestampedData(frame.data(), frame.size(), 1000 + sequence));
+        }
+    }
+    fp_thread.join();
+    EXPECT_EQ(view->Load().sequence_number, 20u);
+
+    // Replaying the capture rebuilds the same book
+    FeedProcessing replay("", "");
+    const BookView *replayed = replay.EnableBookView("ETHUSD-PERP");
+
+    IPC::CaptureReader reader;
+    ASSERT_TRUE(reader.Open(capture_path));
+    std::span<const uint8_t> frame;
+    IPC::FrameTimestamps timestamps;
+    uint64_t frames = 0;
+    while (reader.NextFrame(frame, timestamps)) {
+        frames++;
+        EXPECT_EQ(timestamps.origin_ns, 1000 + frames);
+        EXPECT_EQ(std::string(frame.begin(), frame.end()), snapshot(frames));
+        replay.ProcessFrame(std::string_view(reinterpret_cast<const char *>(frame.data()), frame.size()), timestamps);
+    }
+    EXPECT_EQ(frames, 20u);
+    EXPECT_EQ(replayed->Load().sequence_number, 20u);
+    EXPECT_EQ(replayed->Load().BestBid(), 2499.00);
+}
+
+TEST(FeedProcessingTest, MergesRedundantInputsAcrossReconnects) {
+    const std::string primary_socket_path = "/tmp/primary_market_data.sock";
+    const std::string backup_socket_path = "/tmp/backup_market_data.sock";
+    const std::string bbo_socket_path = "/tmp/merged_bbo_output.sock";
+
+    FeedProcessing fp(primary_socket_path, bbo_socket_path);
+    ASSERT_TRUE(fp.AddInput(backup_socket_path));
+    const BookView *view = fp.EnableBookView("ETHUSD-PERP");
+
+    std::thread fp_thread([&fp]() { fp.Run(); });
+
+    auto wait_for_sequence = [view](uint64_t sequence) {
+        for (int i = 0; i < 200 && view->Load().sequence_number != sequence; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return view->Load().sequence_number == sequence;
+    };
+    auto delta = [](uint64_t sequence, const std::string &bid) {
+        return R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"bids": [[")" + bid +
+               R"(", "1.0", "1"]]}, "t": )" + std::to_string(sequence) + R"(, "u": )" + std::to_string(sequence) + R"(, "pu": )" +
+               std::to_string(sequence - 1) + "}]}}";
+    };
+
+    {
+        IPC::IPCSender primary;
+        ASSERT_TRUE(primary.Connect(primary_socket_path));
+        std::string frame =
+            R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["2501.00", "2.0", "2"]], "bids": [["2499.00", "1.5", "1"]], "t": 1, "u": 100}]}}
+)" + delta(101, "2499.10");
+        EXPECT_TRUE(primary.SendData(frame.c_str(), frame.size()));
+        ASSERT_TRUE(wait_for_sequence(101));
+    }
+
+    // The primary is gone; the backup repeats 101 (ignored as stale) and
+    // carries on, then delivers a snapshot older than the book (ignored too)
+    IPC::IPCSender backup;
+    ASSERT_TRUE(backup.Connect(backup_socket_path));
+    std::string frame = delta(101, "2499.10") + "\n" + delta(102, "2499.20") +
+                        R"(
+{"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["2600.00", "2.0", "2"]], "bids": [["2400.00", "1.5", "1"]], "t": 1, "u": 101}]}})";
+    EXPECT_TRUE(backup.SendData(frame.c_str(), frame.size()));
+    ASSERT_TRUE(wait_for_sequence(102));
+
+    // The primary comes back on the same socket
+    IPC::IPCSender primary;
+    ASSERT_TRUE(primary.Connect(primary_socket_path));
+    frame = delta(103, "2499.30");
+    EXPECT_TRUE(primary.SendData(frame.c_str(), frame.size()));
+    ASSERT_TRUE(wait_for_sequence(103));
+
+    fp.Stop();
+    fp_thread.join();
+
+    EXPECT_EQ(fp.GetBookSnapshotCount(), 2);
+    EXPECT_EQ(fp.GetSequenceGapCount(), 0);
+    EXPECT_EQ(view->Load().BestBid(), 2499.30);
+    EXPECT_EQ(view->Load().BestAsk(), 2501.00);
+}
+
+TEST(FeedProcessingTest, TracksPipelineLatency) {
+    const std::string input_socket_path = "/tmp/latency_market_data.sock";
+    const std::string bbo_socket_path = "/tmp/latency_bbo_output.sock";
+
+    IPC::IPCReceiver bbo_receiver(bbo_socket_path);
+    ASSERT_TRUE(bbo_receiver.Initialize());
+
+    FeedProcessing fp(input_socket_path, bbo_socket_path);
+    const Telemetry::LatencyRecorder *recorder = fp.EnableLatencyTracking();
+
+    std::thread fp_thread([&fp]() { fp.Run(3); });
+
+    // Initial Delay
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    IPC::IPCSender sender;
+    EXPECT_TRUE(sender.Connect(input_socket_path));
+
+    // Exchange t one second before the websocket receipt
+    uint64_t origin_ns = Telemetry::NowNanos();
+    uint64_t exchange_ms = origin_ns / 1000000 - 1000;
+    std::string snapshot = R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book", "data": [{"asks": [["2501.00", "2.0", "2"]], "bids": [["2499.00", "1.5", "1"]], "t": )" +
+                           std::to_string(exchange_ms) + R"(, "u": 100}]}})";
+    std::string delta =
+        R"({"result": {"instrument_name": "ETHUSD-PERP", "channel": "book.update", "data": [{"update": {"bids": [["2499.50", "3.0", "1"]]}, "t": )" +
+        std::to_string(exchange_ms) + R"(, "u": 101, "pu": 100}]}}
+{"result": {"instrument_name": "BTCUSD-PERP", "channel": "book", "data": [{"asks": [["50001.00", "1.0", "1"]], "bids": [["49999.00", "1.0", "1"]], "t": 0, "u": 7}]}})";
+
+    EXPECT_TRUE(sender.SendTimestampedData(snapshot.c_str(), snapshot.size(), origin_ns));
+    // Without stamps the feed still measures from its own receipt
+    EXPECT_TRUE(sender.SendData(delta.c_str(), delta.size()));
+
+    fp_thread.join();
+
+    ExchangeTypes::InstrumentId eth = fp.GetInstrumentId("ETHUSD-PERP");
+    ExchangeTypes::InstrumentId btc = fp.GetInstrumentId("BTCUSD-PERP");
+
+    auto count = [&](ExchangeTypes::InstrumentId id, Telemetry::LatencySpan span) {
+        const auto *histogram = recorder->GetHistogram(id, span);
+        return histogram ? histogram->GetCount() : 0;
+    };
+
+    EXPECT_EQ(count(eth, Telemetry::LatencySpan::EXCHANGE_TO_RECEIVE), 2);
+    EXPECT_EQ(count(eth, Telemetry::LatencySpan::RECEIVE_TO_SEND), 1);
+    EXPECT_EQ(count(eth, Telemetry::LatencySpan::IPC_TRANSIT), 1);
+    EXPECT_EQ(count(eth, Telemetry::LatencySpan::PARSE), 2);
+    EXPECT_EQ(count(eth, Telemetry::LatencySpan::BOOK_APPLY), 2);
+    EXPECT_EQ(count(eth, Telemetry::LatencySpan::PUBLISH), 2);
+    EXPECT_EQ(count(eth, Telemetry::LatencySpan::END_TO_END), 2);
+
+    // No exchange t on the BTC snapshot
+    EXPECT_EQ(count(btc, Telemetry::LatencySpan::EXCHANGE_TO_RECEIVE), 0);
+    EXPECT_EQ(count(btc, Telemetry::LatencySpan::END_TO_END), 1);
+
+    // The snapshot's exchange t was a second before its origin stamp
+    const auto *exchange = recorder->GetHistogram(eth, Telemetry::LatencySpan::EXCHANGE_TO_RECEIVE);
+    EXPECT_GE(exchange->GetMax(), 990000000);
+    EXPECT_EQ(recorder->GetTotalHistogram(Telemetry::LatencySpan::PARSE).GetCount(), 3);
+    EXPECT_NE(recorder->Dump().find("ETHUSD-PERP"), std::string::npos);
+}
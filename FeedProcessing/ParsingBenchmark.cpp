@@ -0,0 +1,234 @@
+#include "DataNormalization.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// Parser throughput over a recorded-shape crypto.com corpus (one message per
+// line in testdata/crypto_com_messages.jsonl: depth-10/50 snapshots, deltas of
+// 1-20 levels and trade batches).
+//
+//   bazel run -c opt //FeedProcessing:ParsingBenchmark
+//   bazel run -c opt //FeedProcessing:ParsingBenchmark -- --corpus=/path/to/messages.jsonl
+//
+// Each benchmark reports msgs/s (items_per_second), bytes_per_second,
+// allocs_per_msg from a global operator new hook, and p50_ns/p99_ns from
+// individually timed parses after the main loop.
+
+namespace {
+
+size_t allocation_count = 0;
+
+} // namespace
+
+// Kept out of line so GCC does not pair the inlined malloc/free across
+// new/delete and warn about a mismatch
+[[gnu::noinline]] void *operator new(size_t size) {
+    allocation_count++;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void *ptr) noexcept { std::free(ptr); }
+[[gnu::noinline]] void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+constexpr size_t kLatencySamples = 1 << 14;
+constexpr size_t kFrameSize = 64; // messages per frame for the batch benchmark
+
+enum Subset : int64_t { ALL = 0, SNAPSHOTS = 1, DELTAS = 2, TRADES = 3 };
+
+std::string corpus_path = "FeedProcessing/testdata/crypto_com_messages.jsonl";
+
+struct Corpus {
+    std::vector<std::string> messages;
+};
+
+const std::vector<std::string> &load_corpus() {
+    static const std::vector<std::string> messages = [] {
+        std::vector<std::string> lines;
+        std::ifstream file(corpus_path);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty()) {
+                lines.push_back(line);
+            }
+        }
+        if (lines.empty()) {
+            std::cerr << "Failed to load corpus from " << corpus_path << std::endl;
+            std::exit(1);
+        }
+        return lines;
+    }();
+    return messages;
+}
+
+Corpus select(Subset subset) {
+    static constexpr const char *kChannels[] = {"", R"("channel":"book",)", R"("channel":"book.update",)", R"("channel":"trade",)"};
+
+    Corpus corpus;
+    for (const auto &message : load_corpus()) {
+        if (subset == ALL || message.find(kChannels[subset]) != std::string::npos) {
+            corpus.messages.push_back(message);
+        }
+    }
+    return corpus;
+}
+
+const char *subset_name(Subset subset) {
+    switch (subset) {
+    case SNAPSHOTS:
+        return "book";
+    case DELTAS:
+        return "book.update";
+    case TRADES:
+        return "trade";
+    case ALL:
+    default:
+        return "all";
+    }
+}
+
+using Clock = std::chrono::steady_clock;
+
+int64_t elapsed_ns(Clock::time_point start, Clock::time_point end) { return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); }
+
+int64_t timer_overhead_ns() {
+    static const int64_t overhead = [] {
+        std::vector<int64_t> samples(kLatencySamples);
+        for (auto &sample : samples) {
+            auto start = Clock::now();
+            auto end = Clock::now();
+            sample = elapsed_ns(start, end);
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }();
+    return overhead;
+}
+
+// Runs one parse per iteration over the corpus in order, then reports
+// throughput, allocations and latency percentiles for a parse of one message
+template <typename Fn> void run_parses(benchmark::State &state, const Corpus &corpus, Fn &&parse) {
+    size_t index = 0;
+    size_t bytes = 0;
+
+    // Warm the parser so capacity growth is not counted as steady state
+    for (const auto &message : corpus.messages) {
+        parse(message);
+    }
+
+    size_t allocations_before = allocation_count;
+    for (auto _ : state) {
+        const std::string &message = corpus.messages[index];
+        parse(message);
+        bytes += message.size();
+        index = index + 1 == corpus.messages.size() ? 0 : index + 1;
+    }
+    size_t allocations = allocation_count - allocations_before;
+
+    std::vector<int64_t> latencies(kLatencySamples);
+    int64_t overhead = timer_overhead_ns();
+    for (size_t i = 0; i < latencies.size(); ++i) {
+        const std::string &message = corpus.messages[i % corpus.messages.size()];
+        auto start = Clock::now();
+        parse(message);
+        auto end = Clock::now();
+        latencies[i] = std::max<int64_t>(elapsed_ns(start, end) - overhead, 0);
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.counters["allocs_per_msg"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+    state.counters["p50_ns"] = static_cast<double>(latencies[latencies.size() / 2]);
+    state.counters["p99_ns"] = static_cast<double>(latencies[latencies.size() * 99 / 100]);
+}
+
+// On-Demand parse serialized into a WireMarketMessage record
+void BM_ParseExchangeMessage(benchmark::State &state) {
+    Subset subset = static_cast<Subset>(state.range(0));
+    Corpus corpus = select(subset);
+    DataNormalization normalizer;
+
+    run_parses(state, corpus, [&](const std::string &message) { benchmark::DoNotOptimize(normalizer.ParseExchangeMessage(message)); });
+    state.SetLabel(subset_name(subset));
+}
+
+// On-Demand parse into a reused NormalizedMessage
+void BM_ParseNormalizedMessage(benchmark::State &state) {
+    Subset subset = static_cast<Subset>(state.range(0));
+    Corpus corpus = select(subset);
+    DataNormalization normalizer;
+    auto msg = std::make_unique<ExchangeTypes::NormalizedMessage>();
+
+    run_parses(state, corpus, [&](const std::string &message) {
+        benchmark::DoNotOptimize(normalizer.ParseNormalizedMessage(message, *msg));
+        benchmark::ClobberMemory();
+    });
+    state.SetLabel(subset_name(subset));
+}
+
+// iterate_many over frames of kFrameSize newline-separated messages; one
+// iteration is one frame, items are messages
+void BM_ParseNormalizedBatch(benchmark::State &state) {
+    Corpus corpus = select(ALL);
+    std::vector<std::string> frames;
+    for (size_t i = 0; i < corpus.messages.size(); i += kFrameSize) {
+        std::string frame;
+        for (size_t j = i; j < std::min(i + kFrameSize, corpus.messages.size()); ++j) {
+            frame += corpus.messages[j];
+            frame += '\n';
+        }
+        frames.push_back(std::move(frame));
+    }
+
+    DataNormalization normalizer;
+    ExchangeTypes::NormalizedBatch batch;
+    size_t messages = 0;
+
+    Corpus frame_corpus{std::move(frames)};
+    run_parses(state, frame_corpus, [&](const std::string &frame) { messages += normalizer.ParseNormalizedBatch(frame, batch); });
+
+    // Report per message rather than per frame
+    double messages_per_frame = static_cast<double>(corpus.messages.size()) / static_cast<double>(frame_corpus.messages.size());
+    state.SetItemsProcessed(static_cast<int64_t>(static_cast<double>(state.iterations()) * messages_per_frame));
+    state.counters["allocs_per_msg"].value /= messages_per_frame;
+    state.SetLabel("p50/p99 per frame of " + std::to_string(kFrameSize));
+    benchmark::DoNotOptimize(messages);
+}
+
+} // namespace
+
+BENCHMARK(BM_ParseExchangeMessage)->Arg(ALL)->Arg(SNAPSHOTS)->Arg(DELTAS)->Arg(TRADES);
+BENCHMARK(BM_ParseNormalizedMessage)->Arg(ALL)->Arg(SNAPSHOTS)->Arg(DELTAS)->Arg(TRADES);
+BENCHMARK(BM_ParseNormalizedBatch);
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--corpus=", 0) == 0) {
+            corpus_path = arg.substr(9);
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
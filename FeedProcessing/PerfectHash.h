@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+// Compile-time perfect hash over a fixed set of string keys. The constructor
+// searches for a seed under which every key lands in its own slot, so a
+// lookup is one hash of (length, first, middle, last byte) plus a single
+// comparison against the slot's key to reject strings outside the set.
+//
+//   constexpr PerfectHash<Field, 3> kFields({{{"asks", Field::ASKS}, ...}}, Field::UNKNOWN);
+//   static_assert(kFields.IsValid());
+template <typename Value, size_t N> class PerfectHash {
+  public:
+    static constexpr size_t kSlots = std::bit_ceil(N * 2);
+
+    constexpr PerfectHash(const std::array<std::pair<std::string_view, Value>, N> &entries, Value missing) : missing_(missing) {
+        for (uint32_t seed = 1; seed < kMaxSeed; ++seed) {
+            if (try_seed(entries, seed)) {
+                seed_ = seed;
+                return;
+            }
+        }
+    }
+
+    constexpr bool IsValid() const { return seed_ != 0; }
+
+    constexpr Value Find(std::string_view key) const {
+        const Slot &slot = slots_[hash(key, seed_) & (kSlots - 1)];
+        return slot.used && slot.key == key ? slot.value : missing_;
+    }
+
+  private:
+    static constexpr uint32_t kMaxSeed = 1 << 16;
+
+    struct Slot {
+        std::string_view key;
+        Value value{};
+        bool used = false;
+    };
+
+    static constexpr uint32_t mix(uint32_t h, uint32_t byte) { return (h ^ byte) * 0x01000193u; }
+
+    static constexpr uint32_t hash(std::string_view key, uint32_t seed) {
+        uint32_t h = mix(seed * 0x9e3779b9u, static_cast<uint32_t>(key.size()));
+        if (!key.empty()) {
+            h = mix(h, static_cast<uint8_t>(key.front()));
+            h = mix(h, static_cast<uint8_t>(key[key.size() / 2]));
+            h = mix(h, static_cast<uint8_t>(key.back()));
+        }
+        return h ^ (h >> 16);
+    }
+
+    constexpr bool try_seed(const std::array<std::pair<std::string_view, Value>, N> &entries, uint32_t seed) {
+        slots_ = {};
+        for (const auto &[key, value] : entries) {
+            Slot &slot = slots_[hash(key, seed) & (kSlots - 1)];
+            if (slot.used) {
+                return false;
+            }
+            slot = {key, value, true};
+        }
+        return true;
+    }
+
+    std::array<Slot, kSlots> slots_{};
+    uint32_t seed_ = 0;
+    Value missing_;
+};
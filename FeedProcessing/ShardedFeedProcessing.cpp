@@ -0,0 +1,233 @@
+#include "ShardedFeedProcessing.h"
+#include "Logging/Logger.h"
+#include <algorithm>
+#include <functional>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+ShardedFeedProcessing::ShardedFeedProcessing(const std::string &input_socket_path, const std::string &bbo_output_socket_path,
+                                             const ShardedFeedConfig &config)
+    : bbo_output_socket_path_(bbo_output_socket_path), config_(config),
+      inputs_(event_loop_, [this](std::span<const uint8_t> frame, const IPC::FrameTimestamps &timestamps) {
+          run_message_count_ += DispatchFrame(std::string_view(reinterpret_cast<const char *>(frame.data()), frame.size()), timestamps);
+      }) {
+
+    config_.num_shards = std::max<size_t>(config_.num_shards, 1);
+    for (size_t shard = 0; shard < config_.num_shards; ++shard) {
+        shards_.push_back(std::make_unique<Shard>(GetShardOutputPath(shard), config_.queue_capacity));
+    }
+
+    AddInput(input_socket_path);
+}
+
+ShardedFeedProcessing::~ShardedFeedProcessing() { StopWorkers(); }
+
+bool ShardedFeedProcessing::AddInput(const std::string &input_socket_path) {
+    if (!inputs_.AddInput(input_socket_path)) {
+        LOG_ERROR("Failed to initialize IPC receiver for socket: {}", input_socket_path);
+        return false;
+    }
+    return true;
+}
+
+void ShardedFeedProcessing::Run(std::optional<size_t> max_messages) {
+    if (inputs_.GetInputCount() == 0) {
+        LOG_ERROR("IPC receiver not initialized, cannot run");
+        return;
+    }
+
+    StartWorkers();
+
+    run_message_count_ = 0;
+    while (!stop_requested_.load(std::memory_order_relaxed)) {
+        event_loop_.Poll(-1);
+        if (max_messages.has_value() && run_message_count_ >= max_messages.value()) {
+            break;
+        }
+    }
+    stop_requested_.store(false, std::memory_order_relaxed);
+
+    StopWorkers();
+}
+
+void ShardedFeedProcessing::Stop() {
+    stop_requested_.store(true, std::memory_order_relaxed);
+    event_loop_.Wakeup();
+}
+
+size_t ShardedFeedProcessing::GetShard(std::string_view instrument) const {
+    return instrument.empty() ? 0 : std::hash<std::string_view>{}(instrument) % shards_.size();
+}
+
+std::string ShardedFeedProcessing::GetShardPath(const std::string &path, size_t shard) const {
+    return config_.num_shards == 1 || path.empty() ? path : path + "." + std::to_string(shard);
+}
+
+bool ShardedFeedProcessing::SetDefaultOrderbookConfig(const OrderbookConfig &config) {
+    bool applied = true;
+    for (auto &shard : shards_) {
+        applied = shard->processor->SetDefaultOrderbookConfig(config) && applied;
+    }
+    return applied;
+}
+
+void ShardedFeedProcessing::SetSnapshotRequestCallback(const FeedProcessing::SnapshotRequestCallback &callback) {
+    for (auto &shard : shards_) {
+        shard->processor->SetSnapshotRequestCallback(callback);
+    }
+}
+
+void ShardedFeedProcessing::EnableBboConflation(uint64_t max_latency_us) {
+    for (auto &shard : shards_) {
+        shard->processor->EnableBboConflation(max_latency_us);
+    }
+}
+
+bool ShardedFeedProcessing::EnableBboBroadcast(const std::string &ring_path, const IPC::BroadcastSender::Config &config) {
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+        if (!shards_[shard]->processor->EnableBboBroadcast(GetShardPath(ring_path, shard), config)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ShardedFeedProcessing::SetOrderbookConfig(const std::string &instrument, const OrderbookConfig &config) {
+    return GetShardProcessor(GetShard(instrument)).SetOrderbookConfig(instrument, config);
+}
+
+bool ShardedFeedProcessing::SetInstrumentDecimals(const std::string &instrument, uint8_t price_decimals, uint8_t quantity_decimals) {
+    return GetShardProcessor(GetShard(instrument)).SetInstrumentDecimals(instrument, price_decimals, quantity_decimals);
+}
+
+const BookView *ShardedFeedProcessing::EnableBookView(const std::string &instrument) {
+    return GetShardProcessor(GetShard(instrument)).EnableBookView(instrument);
+}
+
+const DepthHistory *ShardedFeedProcessing::EnableDepthHistory(const std::string &instrument, const DepthHistory::Config &config) {
+    return GetShardProcessor(GetShard(instrument)).EnableDepthHistory(instrument, config);
+}
+
+void ShardedFeedProcessing::EnableTradeFlow(const std::string &instrument, const TradeFlowAggregator::Config &config) {
+    GetShardProcessor(GetShard(instrument)).EnableTradeFlow(instrument, config);
+}
+
+uint64_t ShardedFeedProcessing::GetBookSnapshotCount() const {
+    uint64_t count = 0;
+    for (const auto &shard : shards_) {
+        count += shard->processor->GetBookSnapshotCount();
+    }
+    return count;
+}
+
+uint64_t ShardedFeedProcessing::GetBookDeltaCount() const {
+    uint64_t count = 0;
+    for (const auto &shard : shards_) {
+        count += shard->processor->GetBookDeltaCount();
+    }
+    return count;
+}
+
+uint64_t ShardedFeedProcessing::GetTradeCount() const {
+    uint64_t count = 0;
+    for (const auto &shard : shards_) {
+        count += shard->processor->GetTradeCount();
+    }
+    return count;
+}
+
+size_t ShardedFeedProcessing::DispatchFrame(std::string_view frame, const IPC::FrameTimestamps &timestamps) {
+    size_t failed = frame_splitter_.SplitFrame(frame, frame_messages_);
+    for (size_t i = 0; i < failed; ++i) {
+        LOG_WARN("Failed to parse message");
+    }
+
+    // Messages of one shard stay together as one newline-separated frame, so
+    // each worker still publishes once per instrument per incoming frame
+    for (const auto &message : frame_messages_) {
+        AppendToShard(*shards_[GetShard(message.instrument_name)], message.json, timestamps);
+    }
+    CommitShardFrames();
+
+    return frame_messages_.size() + failed;
+}
+
+void ShardedFeedProcessing::AppendToShard(Shard &shard, std::string_view message, const IPC::FrameTimestamps &timestamps) {
+    if (!shard.open_frame) {
+        // Backpressure: wait for the worker rather than drop or reorder
+        while (!(shard.open_frame = shard.queue.BeginPush())) {
+            std::this_thread::yield();
+        }
+        shard.open_frame->messages.clear();
+        shard.open_frame->timestamps = timestamps;
+    }
+
+    shard.open_frame->messages.append(message);
+    shard.open_frame->messages.push_back('\n');
+}
+
+void ShardedFeedProcessing::CommitShardFrames() {
+    for (auto &shard : shards_) {
+        if (shard->open_frame) {
+            shard->queue.CommitPush();
+            shard->open_frame = nullptr;
+        }
+    }
+}
+
+void ShardedFeedProcessing::StartWorkers() {
+    stopping_.store(false, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        Shard &shard = *shards_[i];
+        shard.worker = std::thread([this, &shard]() { RunWorker(shard); });
+
+#ifdef __linux__
+        if (!config_.worker_cpus.empty()) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(config_.worker_cpus[i % config_.worker_cpus.size()], &cpus);
+            if (pthread_setaffinity_np(shard.worker.native_handle(), sizeof(cpus), &cpus) != 0) {
+                LOG_ERROR("Failed to pin shard {} to CPU {}", i, config_.worker_cpus[i % config_.worker_cpus.size()]);
+            }
+        }
+#endif
+    }
+}
+
+void ShardedFeedProcessing::StopWorkers() {
+    stopping_.store(true, std::memory_order_release);
+
+    for (auto &shard : shards_) {
+        if (shard->worker.joinable()) {
+            shard->worker.join();
+        }
+    }
+}
+
+void ShardedFeedProcessing::RunWorker(Shard &shard) {
+    while (true) {
+        ShardFrame *frame = shard.queue.Front();
+        if (!frame) {
+            // Everything pushed before stopping_ was set is visible once it is
+            // seen, so one more look decides whether the queue is drained
+            if (stopping_.load(std::memory_order_acquire)) {
+                frame = shard.queue.Front();
+                if (!frame) {
+                    shard.processor->FlushConflatedBbos();
+                    return;
+                }
+            } else {
+                shard.processor->FlushConflatedBbos();
+                std::this_thread::yield();
+                continue;
+            }
+        }
+
+        shard.processor->ProcessFrame(frame->messages, frame->timestamps);
+        shard.queue.Pop();
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "DataNormalization.h"
+#include "FeedProcessing.h"
+#include "IPCConnection/EventLoop.h"
+#include "IPCConnection/ReceiverGroup.h"
+#include "SpscQueue.h"
+
+struct ShardedFeedConfig {
+    size_t num_shards = 2;
+    size_t queue_capacity = 1024; // frames in flight per shard
+    std::vector<int> worker_cpus; // optional: worker i is pinned to worker_cpus[i % size]
+};
+
+// Multi-threaded variant of FeedProcessing. The thread calling Run() reads
+// frames, splits them into messages and routes each one by instrument_name to
+// one of num_shards workers over an SPSC queue. Every worker is a
+// FeedProcessing that owns the books of its instruments and publishes their
+// BBOs to its own output socket, so an instrument always lands on the same
+// worker and its messages are applied in arrival order. Messages without an
+// instrument (heartbeats, subscription acks) go to shard 0. Each frame's IPC
+// timestamps travel with its messages, so a worker's latency tracking
+// (GetShardProcessor(shard).EnableLatencyTracking()) sees the real stages;
+// its PARSE span also covers the dispatch and the wait in the queue.
+class ShardedFeedProcessing {
+  public:
+    explicit ShardedFeedProcessing(const std::string &data_input_socket_path, const std::string &bbo_output_socket_path = "/tmp/default_bbo_output.sock",
+                                   const ShardedFeedConfig &config = {});
+    ~ShardedFeedProcessing();
+
+    ShardedFeedProcessing(const ShardedFeedProcessing &) = delete;
+    ShardedFeedProcessing &operator=(const ShardedFeedProcessing &) = delete;
+
+    // Same contracts as on FeedProcessing; every input is dispatched from the
+    // thread calling Run()
+    bool AddInput(const std::string &data_input_socket_path);
+    void SetBusyPoll(bool busy_poll) { event_loop_.SetBusyPoll(busy_poll); }
+
+    // Starts the workers, dispatches until max_messages have been routed or
+    // Stop() is called, then waits for the workers to drain their queues
+    void Run(std::optional<size_t> max_messages = std::nullopt);
+
+    // Thread-safe
+    void Stop();
+
+    size_t GetShardCount() const { return shards_.size(); }
+    size_t GetShard(std::string_view instrument) const;
+
+    // Output socket of a shard's BBOs: bbo_output_socket_path + "." + shard,
+    // or bbo_output_socket_path itself with a single shard (or none)
+    std::string GetShardOutputPath(size_t shard) const { return GetShardPath(bbo_output_socket_path_, shard); }
+
+    // The worker for a shard. Configure it before Run(); its counters and
+    // instrument ids are only stable once Run() has returned.
+    FeedProcessing &GetShardProcessor(size_t shard) { return *shards_[shard]->processor; }
+
+    // Forwarded to the worker owning the instrument; same contracts as on
+    // FeedProcessing
+    bool SetDefaultOrderbookConfig(const OrderbookConfig &config);
+    bool SetOrderbookConfig(const std::string &instrument, const OrderbookConfig &config);
+    bool SetInstrumentDecimals(const std::string &instrument, uint8_t price_decimals, uint8_t quantity_decimals);
+    const BookView *EnableBookView(const std::string &instrument);
+    const DepthHistory *EnableDepthHistory(const std::string &instrument, const DepthHistory::Config &config = {});
+    void EnableTradeFlow(const std::string &instrument, const TradeFlowAggregator::Config &config = {});
+
+    // Set on every worker and invoked from the worker threads, so the callback
+    // must be thread-safe (ExchangeWebsocketClient::RequestSnapshot is)
+    void SetSnapshotRequestCallback(const FeedProcessing::SnapshotRequestCallback &callback);
+
+    // Enabled on every worker; workers retry their conflated BBOs whenever
+    // their queue is empty
+    void EnableBboConflation(uint64_t max_latency_us = 0);
+
+    // Each worker publishes on its own broadcast ring (a ring has a single
+    // writer), named like the output sockets: ring_path + "." + shard
+    bool EnableBboBroadcast(const std::string &ring_path, const IPC::BroadcastSender::Config &config = {});
+
+    // Totals over all workers; read after Run() returns
+    uint64_t GetBookSnapshotCount() const;
+    uint64_t GetBookDeltaCount() const;
+    uint64_t GetTradeCount() const;
+
+  private:
+    // Messages of one incoming frame bound for a shard, newline-separated
+    struct ShardFrame {
+        std::string messages;
+        IPC::FrameTimestamps timestamps;
+    };
+
+    struct Shard {
+        Shard(const std::string &bbo_output_socket_path, size_t queue_capacity)
+            : processor(std::make_unique<FeedProcessing>("", bbo_output_socket_path)), queue(queue_capacity) {}
+
+        std::unique_ptr<FeedProcessing> processor;
+        SpscQueue<ShardFrame> queue;
+        std::thread worker;
+
+        // Dispatcher side: slot being filled for the current frame, if any
+        ShardFrame *open_frame = nullptr;
+    };
+
+    std::string GetShardPath(const std::string &path, size_t shard) const;
+
+    // Routes every message of a frame; returns the number of messages in it
+    // (routed or failed)
+    size_t DispatchFrame(std::string_view frame, const IPC::FrameTimestamps &timestamps);
+    void AppendToShard(Shard &shard, std::string_view message, const IPC::FrameTimestamps &timestamps);
+    void CommitShardFrames();
+
+    void StartWorkers();
+    void StopWorkers();
+    void RunWorker(Shard &shard);
+
+    std::string bbo_output_socket_path_;
+    ShardedFeedConfig config_;
+    IPC::EventLoop event_loop_;
+    IPC::ReceiverGroup inputs_;
+    std::atomic<bool> stop_requested_{false};
+    size_t run_message_count_ = 0;
+    DataNormalization frame_splitter_;
+    std::vector<DataNormalization::FrameMessage> frame_messages_;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool> stopping_{false};
+};
@@ -0,0 +1,144 @@
+#include "ShardedFeedProcessing.h"
+#include "IPCConnection/IPCSender.h"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+TEST(ShardedFeedProcessingTest, SpscQueueIsFifoAndBounded) {
+    SpscQueue<std::string> queue(4);
+    EXPECT_EQ(queue.GetCapacity(), 4);
+    EXPECT_EQ(queue.Front(), nullptr);
+
+    for (int i = 0; i < 4; ++i) {
+        std::string *slot = queue.BeginPush();
+        ASSERT_NE(slot, nullptr);
+        *slot = std::to_string(i);
+        queue.CommitPush();
+    }
+    EXPECT_EQ(queue.BeginPush(), nullptr);
+
+    for (int i = 0; i < 4; ++i) {
+        std::string *front = queue.Front();
+        ASSERT_NE(front, nullptr);
+        EXPECT_EQ(*front, std::to_string(i));
+        queue.Pop();
+    }
+    EXPECT_EQ(queue.Front(), nullptr);
+}
+
+TEST(ShardedFeedProcessingTest, SpscQueuePreservesOrderAcrossThreads) {
+    constexpr uint64_t kCount = 100000;
+    SpscQueue<uint64_t> queue(64);
+
+    std::thread producer([&queue]() {
+        for (uint64_t i = 0; i < kCount; ++i) {
+            uint64_t *slot;
+            while (!(slot = queue.BeginPush())) {
+                std::this_thread::yield();
+            }
+            *slot = i;
+            queue.CommitPush();
+        }
+    });
+
+    uint64_t expected = 0;
+    while (expected < kCount) {
+        uint64_t *front = queue.Front();
+        if (!front) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(*front, expected);
+        queue.Pop();
+        expected++;
+    }
+
+    producer.join();
+}
+
+TEST(ShardedFeedProcessingTest, RoutesInstrumentsToShardsInOrder) {
+    const std::string input_socket_path = "/tmp/sharded_market_data.sock";
+    const std::string bbo_socket_path = "/tmp/sharded_bbo_output.sock";
+
+    ShardedFeedConfig config;
+    config.num_shards = 2;
+    config.queue_capacity = 4;
+    ShardedFeedProcessing fp(input_socket_path, bbo_socket_path, config);
+
+    // Pick two instruments that land on different shards
+    std::string first = "ETHUSD-PERP";
+    std::string second;
+    for (const char *candidate : {"BTCUSD-PERP", "SOLUSD-PERP", "XRPUSD-PERP", "ADAUSD-PERP", "DOGEUSD-PERP"}) {
+        if (fp.GetShard(candidate) != fp.GetShard(first)) {
+            second = candidate;
+            break;
+        }
+    }
+    ASSERT_FALSE(second.empty());
+    EXPECT_EQ(fp.GetShardOutputPath(1), bbo_socket_path + ".1");
+
+    const BookView *first_view = fp.EnableBookView(first);
+    const BookView *second_view = fp.EnableBookView(second);
+    const Telemetry::LatencyRecorder *first_latency = fp.GetShardProcessor(fp.GetShard(first)).EnableLatencyTracking();
+    const Telemetry::LatencyRecorder *second_latency = fp.GetShardProcessor(fp.GetShard(second)).EnableLatencyTracking();
+
+    auto snapshot = [](const std::string &instrument, const char *bid, const char *ask, uint64_t u) {
+        return R"({"result": {"instrument_name": ")" + instrument + R"(", "channel": "book", "data": [{"asks": [[")" + ask +
+               R"(", "1.0", "1"]], "bids": [[")" + bid + R"(", "1.0", "1"]], "t": 1, "u": )" + std::to_string(u) + "}]}}";
+    };
+    auto delta = [](const std::string &instrument, const char *bid, uint64_t u) {
+        return R"({"result": {"instrument_name": ")" + instrument + R"(", "channel": "book.update", "data": [{"update": {"bids": [[")" + bid +
+               R"(", "2.0", "1"]]}, "t": )" + std::to_string(u) + R"(, "u": )" + std::to_string(u) + R"(, "pu": )" + std::to_string(u - 1) + "}]}}";
+    };
+
+    // 2 + 20 messages in one frame, then 20 more one per frame; any reordering
+    // within an instrument breaks its pu chain
+    std::string frame = snapshot(first, "2499.00", "2501.00", 100) + "\n" + snapshot(second, "49999.00", "50001.00", 100) + "\n";
+    for (uint64_t u = 101; u <= 110; ++u) {
+        frame += delta(first, "2499.50", u) + "\n" + delta(second, "49999.50", u) + "\n";
+    }
+
+    std::thread fp_thread([&fp]() { fp.Run(43); });
+
+    // Initial Delay
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    IPC::IPCSender sender;
+    EXPECT_TRUE(sender.Connect(input_socket_path));
+    EXPECT_TRUE(sender.SendTimestampedData(frame.c_str(), frame.size(), 0));
+    for (uint64_t u = 111; u <= 120; ++u) {
+        std::string first_delta = delta(first, "2499.75", u);
+        std::string second_delta = delta(second, "49999.75", u);
+        EXPECT_TRUE(sender.SendData(first_delta.c_str(), first_delta.size()));
+        EXPECT_TRUE(sender.SendData(second_delta.c_str(), second_delta.size()));
+    }
+
+    // Heartbeat without instrument, routed to shard 0
+    std::string heartbeat = R"({"id": 1, "method": "public/heartbeat", "code": 0})";
+    EXPECT_TRUE(sender.SendData(heartbeat.c_str(), heartbeat.size()));
+
+    fp_thread.join();
+
+    EXPECT_EQ(fp.GetBookSnapshotCount(), 2);
+    EXPECT_EQ(fp.GetBookDeltaCount(), 40);
+
+    auto first_book = first_view->Load();
+    EXPECT_EQ(first_book.sequence_number, 120);
+    EXPECT_EQ(first_book.BestBid(), 2499.75);
+    EXPECT_EQ(first_book.num_bids, 3);
+
+    auto second_book = second_view->Load();
+    EXPECT_EQ(second_book.sequence_number, 120);
+    EXPECT_EQ(second_book.BestBid(), 49999.75);
+    EXPECT_EQ(second_book.num_bids, 3);
+
+    // Each shard published the batched frame once, then once per single frame
+    EXPECT_EQ(first_view->GetVersion(), 11);
+    EXPECT_EQ(second_view->GetVersion(), 11);
+
+    // The batched frame's send stamp reached both workers, for each of its
+    // 11 messages per instrument
+    EXPECT_EQ(first_latency->GetTotalHistogram(Telemetry::LatencySpan::IPC_TRANSIT).GetCount(), 11u);
+    EXPECT_EQ(second_latency->GetTotalHistogram(Telemetry::LatencySpan::IPC_TRANSIT).GetCount(), 11u);
+    EXPECT_EQ(first_latency->GetTotalHistogram(Telemetry::LatencySpan::PARSE).GetCount(), 21u);
+}
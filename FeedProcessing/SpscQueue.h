@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bounded single-producer/single-consumer queue. Slots are constructed once
+// and handed out in place (BeginPush/Front), so a producer that refills a
+// slot's std::string or std::vector reuses the capacity left by earlier
+// messages instead of allocating. Each side caches the other side's index and
+// only reloads it when the queue looks full (or empty).
+template <typename T> class SpscQueue {
+  public:
+    explicit SpscQueue(size_t capacity) : slots_(std::bit_ceil(std::max<size_t>(capacity, 2))), mask_(slots_.size() - 1) {}
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Producer: slot to fill, or nullptr while the queue is full. The slot is
+    // invisible to the consumer until CommitPush.
+    T *BeginPush() {
+        uint64_t tail = producer_.tail.load(std::memory_order_relaxed);
+        if (tail - producer_.cached_head == slots_.size()) {
+            producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+            if (tail - producer_.cached_head == slots_.size()) {
+                return nullptr;
+            }
+        }
+        return &slots_[tail & mask_];
+    }
+
+    void CommitPush() { producer_.tail.store(producer_.tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer: oldest committed slot, or nullptr while the queue is empty.
+    // The slot stays owned by the consumer until Pop.
+    T *Front() {
+        uint64_t head = consumer_.head.load(std::memory_order_relaxed);
+        if (head == consumer_.cached_tail) {
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+            if (head == consumer_.cached_tail) {
+                return nullptr;
+            }
+        }
+        return &slots_[head & mask_];
+    }
+
+    void Pop() { consumer_.head.store(consumer_.head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    size_t GetCapacity() const { return slots_.size(); }
+
+  private:
+    std::vector<T> slots_;
+    size_t mask_;
+
+    // Producer and consumer indices on separate cache lines
+    struct alignas(64) ProducerSide {
+        std::atomic<uint64_t> tail{0};
+        uint64_t cached_head = 0;
+    };
+    struct alignas(64) ConsumerSide {
+        std::atomic<uint64_t> head{0};
+        uint64_t cached_tail = 0;
+    };
+
+    ProducerSide producer_;
+    ConsumerSide consumer_;
+};
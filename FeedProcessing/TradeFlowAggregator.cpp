@@ -0,0 +1,119 @@
+#include "TradeFlowAggregator.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+TradeFlowAggregator::TradeFlowAggregator(const Config &config) : config_(config) {
+    config_.max_window_trades = std::max<size_t>(config_.max_window_trades, 1);
+    config_.bar_trades = std::max<size_t>(config_.bar_trades, 1);
+    config_.max_bars = std::max<size_t>(config_.max_bars, 1);
+
+    window_.entries.resize(config_.max_window_trades);
+    bars_.entries.resize(config_.max_bars);
+}
+
+void TradeFlowAggregator::AddTrade(uint64_t timestamp, double price, double quantity, ExchangeTypes::TradeSide side) {
+    if (!(price > 0)) {
+        return;
+    }
+
+    double squared_return = 0;
+    if (stats_.trade_count > 0) {
+        double log_return = std::log(price / stats_.last_price);
+        squared_return = log_return * log_return;
+    }
+
+    double signed_quantity = side == ExchangeTypes::TradeSide::BUY ? quantity : side == ExchangeTypes::TradeSide::SELL ? -quantity : 0;
+
+    EvictTrades(timestamp);
+    if (window_.Full()) {
+        PopOldestTrade();
+    }
+
+    window_.Push({timestamp, quantity, price * quantity, signed_quantity, squared_return});
+    window_quantity_ += quantity;
+    window_notional_ += price * quantity;
+    window_signed_quantity_ += signed_quantity;
+    window_squared_returns_ += squared_return;
+
+    stats_.timestamp = timestamp;
+    stats_.trade_count++;
+    stats_.last_price = price;
+
+    AddToBar(timestamp, price, quantity, signed_quantity);
+    RefreshStats();
+}
+
+void TradeFlowAggregator::EvictTrades(uint64_t now) {
+    while (window_.size > 0 && window_.Oldest().timestamp + config_.window_ms <= now) {
+        PopOldestTrade();
+    }
+}
+
+void TradeFlowAggregator::PopOldestTrade() {
+    const WindowTrade &oldest = window_.Oldest();
+    window_quantity_ -= oldest.quantity;
+    window_notional_ -= oldest.notional;
+    window_signed_quantity_ -= oldest.signed_quantity;
+    window_squared_returns_ -= oldest.squared_return;
+    window_.PopOldest();
+
+    // Running sums drift by rounding; an empty window resets them exactly
+    if (window_.size == 0) {
+        window_quantity_ = window_notional_ = window_signed_quantity_ = window_squared_returns_ = 0;
+    }
+}
+
+void TradeFlowAggregator::AddToBar(uint64_t timestamp, double price, double quantity, double signed_quantity) {
+    if (current_bar_.trades == 0) {
+        current_bar_ = {timestamp, timestamp, price, price, price, price, 0, 0, 0, 0, 0, 0};
+    }
+
+    current_bar_.end_time = timestamp;
+    current_bar_.high = std::max(current_bar_.high, price);
+    current_bar_.low = std::min(current_bar_.low, price);
+    current_bar_.close = price;
+    current_bar_.volume += quantity;
+    current_bar_.notional += price * quantity;
+    current_bar_.signed_volume += signed_quantity;
+    current_bar_.trades++;
+
+    if (current_bar_.trades >= config_.bar_trades) {
+        CloseBar();
+    }
+}
+
+void TradeFlowAggregator::CloseBar() {
+    if (last_bar_close_ > 0) {
+        double log_return = std::log(current_bar_.close / last_bar_close_);
+        current_bar_.squared_return = log_return * log_return;
+    }
+    double log_range = std::log(current_bar_.high / current_bar_.low);
+    current_bar_.range_variance = log_range * log_range / (4 * std::numbers::ln2);
+    last_bar_close_ = current_bar_.close;
+
+    if (bars_.Full()) {
+        const TradeBar &oldest = bars_.Oldest();
+        bar_squared_returns_ -= oldest.squared_return;
+        bar_range_variance_ -= oldest.range_variance;
+        bars_.PopOldest();
+    }
+
+    bars_.Push(current_bar_);
+    bar_squared_returns_ += current_bar_.squared_return;
+    bar_range_variance_ += current_bar_.range_variance;
+    current_bar_.trades = 0;
+}
+
+void TradeFlowAggregator::RefreshStats() {
+    stats_.window_trades = static_cast<uint32_t>(window_.size);
+    stats_.window_volume = window_quantity_;
+    stats_.vwap = window_quantity_ > 0 ? window_notional_ / window_quantity_ : stats_.last_price;
+    stats_.signed_volume = window_signed_quantity_;
+    stats_.imbalance = window_quantity_ > 0 ? std::clamp(window_signed_quantity_ / window_quantity_, -1.0, 1.0) : 0;
+    stats_.realized_variance = std::max(window_squared_returns_, 0.0);
+
+    stats_.num_bars = static_cast<uint32_t>(bars_.size);
+    stats_.bar_realized_variance = std::max(bar_squared_returns_, 0.0);
+    stats_.parkinson_variance = std::max(bar_range_variance_, 0.0);
+}
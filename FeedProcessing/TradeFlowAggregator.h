@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Types/NormalizedMessage.h"
+#include "Types/TradeFlowTypes.h"
+
+struct TradeBar {
+    uint64_t start_time;
+    uint64_t end_time;
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+    double notional;
+    double signed_volume;
+    uint32_t trades;
+
+    // This bar's terms in the bar variance estimators
+    double squared_return; // ln(close / previous bar close)^2
+    double range_variance; // ln(high / low)^2 / (4 ln 2)
+};
+
+// Incremental trade-flow statistics for one instrument. Trades are kept in a
+// fixed-size ring covering the last window_ms (ending at the latest trade),
+// completed bars of bar_trades trades in a second ring, and every aggregate
+// is a running sum that is adjusted as entries enter and leave, so AddTrade
+// is O(1) amortized and allocation-free after construction.
+class TradeFlowAggregator {
+  public:
+    struct Config {
+        uint64_t window_ms = 60000;
+        size_t max_window_trades = 4096; // older trades leave early if the window holds more
+        size_t bar_trades = 100;
+        size_t max_bars = 64;
+    };
+
+    TradeFlowAggregator() : TradeFlowAggregator(Config{}) {}
+    explicit TradeFlowAggregator(const Config &config);
+
+    // Trades must arrive in time order; non-positive prices are ignored
+    void AddTrade(uint64_t timestamp, double price, double quantity, ExchangeTypes::TradeSide side);
+
+    const ExchangeTypes::TradeFlowStats &GetStats() const { return stats_; }
+
+    // Completed bars, age 0 being the most recent
+    size_t GetBarCount() const { return bars_.size; }
+    const TradeBar &GetBar(size_t age) const { return bars_.entries[(bars_.head + bars_.size - 1 - age) % bars_.entries.size()]; }
+
+  private:
+    struct WindowTrade {
+        uint64_t timestamp;
+        double quantity;
+        double notional;
+        double signed_quantity;
+        double squared_return;
+    };
+
+    template <typename T> struct Ring {
+        std::vector<T> entries;
+        size_t head = 0; // oldest
+        size_t size = 0;
+
+        bool Full() const { return size == entries.size(); }
+        T &Oldest() { return entries[head]; }
+        void Push(const T &value) { entries[(head + size++) % entries.size()] = value; }
+        void PopOldest() {
+            head = (head + 1) % entries.size();
+            size--;
+        }
+    };
+
+    void EvictTrades(uint64_t now);
+    void PopOldestTrade();
+    void AddToBar(uint64_t timestamp, double price, double quantity, double signed_quantity);
+    void CloseBar();
+    void RefreshStats();
+
+    Config config_;
+    ExchangeTypes::TradeFlowStats stats_;
+
+    Ring<WindowTrade> window_;
+    double window_quantity_ = 0;
+    double window_notional_ = 0;
+    double window_signed_quantity_ = 0;
+    double window_squared_returns_ = 0;
+
+    Ring<TradeBar> bars_;
+    TradeBar current_bar_{};
+    double bar_squared_returns_ = 0;
+    double bar_range_variance_ = 0;
+    double last_bar_close_ = 0;
+};
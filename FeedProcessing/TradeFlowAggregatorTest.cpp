@@ -0,0 +1,88 @@
+#include "TradeFlowAggregator.h"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <numbers>
+
+using ExchangeTypes::TradeSide;
+
+TEST(TradeFlowAggregatorTest, RollingVwapAndImbalance) {
+    TradeFlowAggregator::Config config;
+    config.window_ms = 1000;
+    TradeFlowAggregator aggregator(config);
+
+    aggregator.AddTrade(0, 100.0, 1.0, TradeSide::BUY);
+    aggregator.AddTrade(100, 102.0, 3.0, TradeSide::SELL);
+
+    const auto &stats = aggregator.GetStats();
+    EXPECT_EQ(stats.trade_count, 2);
+    EXPECT_EQ(stats.window_trades, 2);
+    EXPECT_DOUBLE_EQ(stats.window_volume, 4.0);
+    EXPECT_DOUBLE_EQ(stats.vwap, (100.0 + 306.0) / 4.0);
+    EXPECT_DOUBLE_EQ(stats.signed_volume, -2.0);
+    EXPECT_DOUBLE_EQ(stats.imbalance, -0.5);
+    EXPECT_DOUBLE_EQ(stats.last_price, 102.0);
+
+    // The first trade leaves the window once it is window_ms old
+    aggregator.AddTrade(1000, 101.0, 1.0, TradeSide::UNKNOWN);
+    EXPECT_EQ(stats.trade_count, 3);
+    EXPECT_EQ(stats.window_trades, 2);
+    EXPECT_DOUBLE_EQ(stats.window_volume, 4.0);
+    EXPECT_DOUBLE_EQ(stats.vwap, (306.0 + 101.0) / 4.0);
+    EXPECT_DOUBLE_EQ(stats.signed_volume, -3.0);
+    EXPECT_EQ(stats.timestamp, 1000);
+
+    // A quiet period empties the window down to the new trade
+    aggregator.AddTrade(10000, 99.0, 2.0, TradeSide::BUY);
+    EXPECT_EQ(stats.window_trades, 1);
+    EXPECT_DOUBLE_EQ(stats.vwap, 99.0);
+    EXPECT_DOUBLE_EQ(stats.imbalance, 1.0);
+}
+
+TEST(TradeFlowAggregatorTest, WindowIsBoundedByCapacity) {
+    TradeFlowAggregator::Config config;
+    config.max_window_trades = 4;
+    TradeFlowAggregator aggregator(config);
+
+    for (int i = 0; i < 10; ++i) {
+        aggregator.AddTrade(i, 100.0 + i, 1.0, TradeSide::BUY);
+    }
+
+    const auto &stats = aggregator.GetStats();
+    EXPECT_EQ(stats.window_trades, 4);
+    EXPECT_DOUBLE_EQ(stats.window_volume, 4.0);
+    EXPECT_DOUBLE_EQ(stats.vwap, (106.0 + 107.0 + 108.0 + 109.0) / 4.0);
+}
+
+TEST(TradeFlowAggregatorTest, RealizedVarianceFromTradesAndBars) {
+    TradeFlowAggregator::Config config;
+    config.bar_trades = 2;
+    config.max_bars = 2;
+    TradeFlowAggregator aggregator(config);
+
+    const double prices[] = {100.0, 101.0, 99.0, 100.0, 102.0, 98.0};
+    for (int i = 0; i < 6; ++i) {
+        aggregator.AddTrade(i, prices[i], 1.0, TradeSide::BUY);
+    }
+
+    double trade_variance = 0;
+    for (int i = 1; i < 6; ++i) {
+        trade_variance += std::pow(std::log(prices[i] / prices[i - 1]), 2);
+    }
+
+    const auto &stats = aggregator.GetStats();
+    EXPECT_NEAR(stats.realized_variance, trade_variance, 1e-15);
+
+    // Three bars closed at 101, 100, 98; only the last two are kept
+    ASSERT_EQ(aggregator.GetBarCount(), 2);
+    EXPECT_EQ(stats.num_bars, 2);
+    EXPECT_EQ(aggregator.GetBar(0).close, 98.0);
+    EXPECT_EQ(aggregator.GetBar(0).high, 102.0);
+    EXPECT_EQ(aggregator.GetBar(1).open, 99.0);
+    EXPECT_EQ(aggregator.GetBar(1).trades, 2);
+
+    double bar_variance = std::pow(std::log(100.0 / 101.0), 2) + std::pow(std::log(98.0 / 100.0), 2);
+    EXPECT_NEAR(stats.bar_realized_variance, bar_variance, 1e-15);
+
+    double parkinson = (std::pow(std::log(100.0 / 99.0), 2) + std::pow(std::log(102.0 / 98.0), 2)) / (4 * std::numbers::ln2);
+    EXPECT_NEAR(stats.parkinson_variance, parkinson, 1e-15);
+}
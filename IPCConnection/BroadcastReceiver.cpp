@@ -0,0 +1,53 @@
+#include "BroadcastReceiver.h"
+#include "Telemetry/Clock.h"
+#include <cstring>
+#include <iostream>
+
+namespace IPC {
+
+bool BroadcastReceiver::Connect(const std::string &ring_path) {
+    if (!ring_.Open(ring_path)) {
+        return false;
+    }
+    std::cout << "Connected to broadcast ring: " << ring_path << std::endl;
+    return true;
+}
+
+std::vector<uint8_t> BroadcastReceiver::ReadData() {
+    std::vector<uint8_t> data;
+    if (!ring_.IsOpen()) {
+        std::cerr << "Not connected to any broadcast ring" << std::endl;
+        return data;
+    }
+
+    while (!TryReadData(data)) {
+        if (!ring_.WaitForData(-1, config_.spin_count) && !ring_.IsWriterAttached()) {
+            data.clear();
+            break;
+        }
+    }
+    return data;
+}
+
+bool BroadcastReceiver::TryReadData(std::vector<uint8_t> &data) {
+    uint32_t flags;
+    if (!ring_.IsOpen() || !ring_.TryRead(flags, data)) {
+        return false;
+    }
+
+    last_timestamps_ = FrameTimestamps{};
+    if (flags & kTimestampedFrameFlag) {
+        uint64_t timestamps[2];
+        memcpy(timestamps, data.data(), sizeof(timestamps));
+        last_timestamps_.origin_ns = timestamps[0];
+        last_timestamps_.send_ns = timestamps[1];
+        data.erase(data.begin(), data.begin() + sizeof(timestamps));
+    }
+
+    last_timestamps_.receive_ns = Telemetry::NowNanos();
+    return true;
+}
+
+bool BroadcastReceiver::WaitForData(int timeout_ms) { return ring_.IsOpen() && ring_.WaitForData(timeout_ms, config_.spin_count); }
+
+} // namespace IPC
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BroadcastRing.h"
+#include "IPCFrame.h"
+
+namespace IPC {
+
+// One reader of a BroadcastSender's ring. It sees the frames sent after it
+// connects and keeps its own cursor; other receivers neither see nor slow
+// it. If it falls a whole ring behind it skips to the next frame sent, and
+// the overrun and lost counts say so.
+class BroadcastReceiver {
+  public:
+    struct Config {
+        int spin_count = 256;
+    };
+
+    BroadcastReceiver() : BroadcastReceiver(Config{}) {}
+    explicit BroadcastReceiver(const Config &config) : config_(config) {}
+
+    // Attaches to the sender's current ring; call again to follow a
+    // restarted sender, whose ring replaces the old file
+    bool Connect(const std::string &ring_path);
+    void Disconnect() { ring_.Close(); }
+
+    // Blocks until a frame arrives; empty once the sender is gone
+    std::vector<uint8_t> ReadData();
+
+    // Non-blocking: copies the next frame into data, reusing its capacity;
+    // false if there is none
+    bool TryReadData(std::vector<uint8_t> &data);
+
+    // Waits up to timeout_ms (-1 for no limit) for a frame; false at once if
+    // the sender is gone
+    bool WaitForData(int timeout_ms);
+
+    // Same contract as IPCReceiver::GetLastFrameTimestamps
+    const FrameTimestamps &GetLastFrameTimestamps() const { return last_timestamps_; }
+
+    // Times this receiver was lapped by the sender, and the frames it lost
+    uint64_t GetOverrunCount() const { return ring_.GetOverrunCount(); }
+    uint64_t GetLostCount() const { return ring_.GetLostCount(); }
+
+    bool IsConnected() const { return ring_.IsOpen(); }
+    bool IsSenderAttached() const { return ring_.IsWriterAttached(); }
+
+  private:
+    Config config_;
+    BroadcastRing ring_;
+    FrameTimestamps last_timestamps_;
+};
+
+} // namespace IPC
@@ -0,0 +1,334 @@
+#include "BroadcastRing.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <linux/futex.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace IPC {
+
+namespace {
+
+constexpr size_t kMinCapacity = 4096;
+
+uint64_t align_record(uint64_t size) { return (size + 7) & ~uint64_t{7}; }
+
+size_t round_up_power_of_two(size_t value) {
+    size_t result = kMinCapacity;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Not FUTEX_PRIVATE: the word lives in a mapping shared across processes
+long futex(std::atomic<uint32_t> *word, int op, uint32_t value, const struct timespec *timeout) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), op, value, timeout, nullptr, 0);
+}
+
+std::atomic_ref<uint64_t> word_at(const uint8_t *address) {
+    return std::atomic_ref<uint64_t>(*reinterpret_cast<uint64_t *>(const_cast<uint8_t *>(address)));
+}
+
+// dst is 8-byte aligned; the last word is zero-filled past size
+void store_words(uint8_t *dst, const void *src, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(src);
+    for (size_t offset = 0; offset < size; offset += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        memcpy(&word, bytes + offset, std::min(sizeof(word), size - offset));
+        word_at(dst + offset).store(word, std::memory_order_relaxed);
+    }
+}
+
+// src is 8-byte aligned
+void load_words(uint8_t *dst, const uint8_t *src, size_t size) {
+    for (size_t offset = 0; offset < size; offset += sizeof(uint64_t)) {
+        uint64_t word = word_at(src + offset).load(std::memory_order_relaxed);
+        memcpy(dst + offset, &word, std::min(sizeof(word), size - offset));
+    }
+}
+
+} // namespace
+
+BroadcastRing::~BroadcastRing() { Close(); }
+
+bool BroadcastRing::Create(const std::string &path, size_t capacity, bool futex_wakeup) {
+    Close();
+
+    // A new file rather than truncating the old one: readers of a previous
+    // writer may still map it, and shrinking it under them would SIGBUS
+    unlink(path.c_str());
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        std::cerr << "Failed to create broadcast ring " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    capacity = round_up_power_of_two(capacity);
+    size_t size = sizeof(BroadcastRingHeader) + capacity;
+    if (ftruncate(fd, size) < 0) {
+        std::cerr << "Failed to size broadcast ring " << path << ": " << strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+
+    if (!Map(fd, size)) {
+        return false;
+    }
+
+    new (header_) BroadcastRingHeader();
+    header_->version = BroadcastRingHeader::kVersion;
+    header_->futex_wakeup = futex_wakeup;
+    header_->capacity = capacity;
+    header_->writer_attached.store(1, std::memory_order_relaxed);
+    header_->magic.store(BroadcastRingHeader::kMagic, std::memory_order_release);
+
+    writer_ = true;
+    capacity_ = capacity;
+    futex_wakeup_ = futex_wakeup;
+    cursor_ = 0;
+    sequence_ = 0;
+    return true;
+}
+
+bool BroadcastRing::Open(const std::string &path) {
+    Close();
+
+    int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Failed to open broadcast ring " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(BroadcastRingHeader) + kMinCapacity) {
+        std::cerr << "Broadcast ring " << path << " is not initialized" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    if (!Map(fd, info.st_size)) {
+        return false;
+    }
+
+    if (header_->magic.load(std::memory_order_acquire) != BroadcastRingHeader::kMagic || header_->version != BroadcastRingHeader::kVersion ||
+        sizeof(BroadcastRingHeader) + header_->capacity != mapping_size_) {
+        std::cerr << "Broadcast ring " << path << " has an unknown layout" << std::endl;
+        Close();
+        return false;
+    }
+
+    capacity_ = header_->capacity;
+    futex_wakeup_ = header_->futex_wakeup;
+    overrun_count_ = 0;
+    lost_count_ = 0;
+    SyncToWriter();
+
+    // After taking the cursor: whatever the writer republishes once it sees
+    // the new generation lands past it
+    header_->reader_generation.fetch_add(1, std::memory_order_acq_rel);
+    return true;
+}
+
+bool BroadcastRing::Map(int fd, size_t size) {
+    void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map broadcast ring: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    header_ = static_cast<BroadcastRingHeader *>(mapping);
+    data_ = static_cast<uint8_t *>(mapping) + sizeof(BroadcastRingHeader);
+    mapping_size_ = size;
+    return true;
+}
+
+void BroadcastRing::Close() {
+    if (!header_) {
+        return;
+    }
+
+    if (writer_) {
+        header_->writer_attached.store(0, std::memory_order_release);
+        WakeReaders();
+        writer_ = false;
+    }
+    munmap(header_, mapping_size_);
+    header_ = nullptr;
+    data_ = nullptr;
+}
+
+size_t BroadcastRing::GetMaxRecordSize() const { return capacity_ / 2 - sizeof(RecordHeader); }
+
+bool BroadcastRing::Write(uint32_t flags, const void *prefix, size_t prefix_size, const void *payload, size_t payload_size) {
+    size_t content_size = prefix_size + payload_size;
+    if (content_size > GetMaxRecordSize()) {
+        return false;
+    }
+
+    uint64_t record_size = align_record(sizeof(RecordHeader) + content_size);
+    uint64_t to_end = capacity_ - (cursor_ & (capacity_ - 1));
+    uint64_t end = cursor_ + (record_size <= to_end ? record_size : to_end + record_size);
+
+    // Claim before overwriting: a reader whose copy overlaps these bytes sees
+    // the claim once it has seen any of them (seqlock-style fence pairing)
+    header_->claim_pos.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (record_size > to_end) {
+        RecordHeader padding{static_cast<uint32_t>(to_end), kPaddingRecord};
+        store_words(At(cursor_), &padding, sizeof(padding));
+        cursor_ += to_end;
+    }
+
+    uint8_t *record = At(cursor_);
+    RecordHeader record_header{static_cast<uint32_t>(content_size), flags};
+    store_words(record, &record_header, sizeof(record_header));
+    if (prefix_size > 0) {
+        store_words(record + sizeof(RecordHeader), prefix, prefix_size);
+    }
+    store_words(record + sizeof(RecordHeader) + prefix_size, payload, payload_size);
+
+    cursor_ = end;
+    header_->write_sequence.store(++sequence_, std::memory_order_relaxed);
+    header_->write_pos.store(cursor_, std::memory_order_release);
+
+    if (futex_wakeup_) {
+        WakeReaders();
+    }
+    return true;
+}
+
+void BroadcastRing::WakeReaders() {
+    // Pairs with the fence in WaitForData: either a reader sees the new
+    // write_pos before sleeping, or this sees it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->readers_waiting.load(std::memory_order_relaxed)) {
+        header_->wakeup_seq.fetch_add(1, std::memory_order_release);
+        futex(&header_->wakeup_seq, FUTEX_WAKE, INT_MAX, nullptr);
+    }
+}
+
+void BroadcastRing::SyncToWriter() {
+    // A position and record count of the same moment: the count is stored
+    // after the claim, so while they differ it may already be the next one's
+    do {
+        cursor_ = header_->write_pos.load(std::memory_order_acquire);
+        sequence_ = header_->write_sequence.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (header_->claim_pos.load(std::memory_order_relaxed) != cursor_);
+}
+
+void BroadcastRing::Resync() {
+    // Lapped: skip past everything published so far and count it as lost
+    uint64_t sequence = sequence_;
+    SyncToWriter();
+    overrun_count_++;
+    lost_count_ += sequence_ - sequence;
+
+    // Like a new reader, this one needs per-stream state published again
+    header_->reader_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+bool BroadcastRing::TryRead(uint32_t &flags, std::vector<uint8_t> &data) {
+    while (true) {
+        uint64_t write_pos = header_->write_pos.load(std::memory_order_acquire);
+        if (cursor_ == write_pos) {
+            return false;
+        }
+        if (write_pos - cursor_ > capacity_) {
+            Resync();
+            continue;
+        }
+
+        const uint8_t *record = At(cursor_);
+        RecordHeader record_header;
+        load_words(reinterpret_cast<uint8_t *>(&record_header), record, sizeof(record_header));
+
+        // The header may already be overwritten, so check its size before
+        // copying anything it describes
+        bool padding = record_header.flags == kPaddingRecord;
+        uint64_t record_size = padding ? record_header.size : align_record(sizeof(RecordHeader) + record_header.size);
+        bool valid = record_size >= sizeof(RecordHeader) && record_size <= write_pos - cursor_;
+        if (valid && !padding) {
+            data.resize(record_header.size);
+            load_words(data.data(), record + sizeof(RecordHeader), record_header.size);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!valid || header_->claim_pos.load(std::memory_order_relaxed) - cursor_ > capacity_) {
+            Resync();
+            continue;
+        }
+
+        cursor_ += record_size;
+        if (padding) {
+            continue;
+        }
+
+        sequence_++;
+        flags = record_header.flags;
+        return true;
+    }
+}
+
+bool BroadcastRing::WaitForData(int timeout_ms, int spin_count) {
+    for (int i = 0; i < spin_count; ++i) {
+        if (HasData()) {
+            return true;
+        }
+        cpu_relax();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!HasData()) {
+        if (!IsWriterAttached()) {
+            return false;
+        }
+
+        auto remaining = deadline - std::chrono::steady_clock::now();
+        if (timeout_ms >= 0 && remaining <= std::chrono::nanoseconds::zero()) {
+            return false;
+        }
+
+        if (!futex_wakeup_) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint32_t seq = header_->wakeup_seq.load(std::memory_order_acquire);
+        header_->readers_waiting.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!HasData() && IsWriterAttached()) {
+            struct timespec timeout;
+            if (timeout_ms >= 0) {
+                auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+                timeout.tv_sec = nanos / 1000000000;
+                timeout.tv_nsec = nanos % 1000000000;
+            }
+            futex(&header_->wakeup_seq, FUTEX_WAIT, seq, timeout_ms >= 0 ? &timeout : nullptr);
+        }
+        header_->readers_waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+} // namespace IPC
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SharedMemoryRing.h"
+
+namespace IPC {
+
+// Start of a broadcast ring mapping; the data area follows it. Everything the
+// writer updates per record sits on one cache line; readers keep their
+// cursors privately, so the writer's cost does not depend on how many there are.
+struct alignas(kCacheLineSize) BroadcastRingHeader {
+    static constexpr uint64_t kMagic = 0x5453414344424950ull; // "PIBDCAST"
+    static constexpr uint32_t kVersion = 1;
+
+    std::atomic<uint64_t> magic; // stored last by the creator
+    uint32_t version;
+    uint32_t futex_wakeup; // readers may sleep on wakeup_seq
+    uint64_t capacity;     // data bytes, a power of two
+    std::atomic<uint32_t> writer_attached;
+    std::atomic<uint32_t> reader_generation; // bumped by every reader that attaches or is lapped
+
+    // Bytes and records ever published, and the end of the record being
+    // written: data below claim_pos - capacity may be overwritten at any moment
+    alignas(kCacheLineSize) std::atomic<uint64_t> write_pos;
+    std::atomic<uint64_t> write_sequence;
+    std::atomic<uint64_t> claim_pos;
+
+    alignas(kCacheLineSize) std::atomic<uint32_t> readers_waiting;
+    std::atomic<uint32_t> wakeup_seq; // futex word
+};
+
+// Single-writer multi-reader ring of variable-length records in a file-backed
+// shared mapping (use a path under /dev/shm). The writer never waits for
+// readers: it overwrites the oldest records, and a reader that was lapped
+// notices when it validates its copy against claim_pos, counts the overrun
+// and skips ahead to the next record the writer publishes; the writer's
+// record count tells it how many it lost. Records are an 8-byte header
+// (size, flags) and the payload, padded to 8 bytes, and never wrap. Both
+// sides copy them as std::atomic_ref words (as in Seqlock), so racing reads
+// are not data races.
+class BroadcastRing {
+  public:
+    BroadcastRing() = default;
+    ~BroadcastRing();
+
+    BroadcastRing(const BroadcastRing &) = delete;
+    BroadcastRing &operator=(const BroadcastRing &) = delete;
+
+    // Writer side: creates a new ring at path, replacing any older file
+    // (readers still mapping that one keep it until they reopen); capacity is
+    // rounded up to a power of two
+    bool Create(const std::string &path, size_t capacity, bool futex_wakeup);
+
+    // Reader side: maps the ring at path; reads start with the next record
+    // published
+    bool Open(const std::string &path);
+
+    void Close();
+
+    bool IsOpen() const { return header_ != nullptr; }
+    bool IsWriterAttached() const { return header_ && header_->writer_attached.load(std::memory_order_acquire); }
+
+    // Largest prefix + payload a single record can carry
+    size_t GetMaxRecordSize() const;
+
+    // Writer: appends prefix (a multiple of 8 bytes) then payload as one
+    // record; false only if it exceeds GetMaxRecordSize()
+    bool Write(uint32_t flags, const void *prefix, size_t prefix_size, const void *payload, size_t payload_size);
+
+    // Writer: changes whenever a reader attaches or skips ahead after being
+    // lapped, i.e. starts reading without what was published before
+    uint32_t GetReaderGeneration() const { return header_->reader_generation.load(std::memory_order_acquire); }
+
+    // Reader: copies the next record into data; false if there is none yet
+    bool TryRead(uint32_t &flags, std::vector<uint8_t> &data);
+
+    // Reader: waits up to timeout_ms (-1 for no limit) for a record,
+    // spinning spin_count times first and then sleeping on the futex (or
+    // yielding without futex_wakeup)
+    bool WaitForData(int timeout_ms, int spin_count);
+
+    // Reader: times this reader was lapped, and records it lost to that
+    uint64_t GetOverrunCount() const { return overrun_count_; }
+    uint64_t GetLostCount() const { return lost_count_; }
+
+  private:
+    struct RecordHeader {
+        uint32_t size;
+        uint32_t flags;
+    };
+    static constexpr uint32_t kPaddingRecord = UINT32_MAX;
+
+    bool Map(int fd, size_t size);
+    uint8_t *At(uint64_t pos) const { return data_ + (pos & (capacity_ - 1)); }
+    bool HasData() const { return cursor_ != header_->write_pos.load(std::memory_order_acquire); }
+    void SyncToWriter();
+    void Resync();
+    void WakeReaders();
+
+    BroadcastRingHeader *header_ = nullptr;
+    uint8_t *data_ = nullptr;
+    size_t mapping_size_ = 0;
+    uint64_t capacity_ = 0;
+    bool futex_wakeup_ = false;
+    bool writer_ = false;
+
+    // Writer: next position and record count. Reader: its cursor, the
+    // sequence number of the record there and its overrun counts.
+    uint64_t cursor_ = 0;
+    uint64_t sequence_ = 0;
+    uint64_t overrun_count_ = 0;
+    uint64_t lost_count_ = 0;
+};
+
+} // namespace IPC
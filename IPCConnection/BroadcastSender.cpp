@@ -0,0 +1,46 @@
+#include "BroadcastSender.h"
+#include "Telemetry/Clock.h"
+#include <iostream>
+#include <unistd.h>
+
+namespace IPC {
+
+BroadcastSender::BroadcastSender(const std::string &ring_path, const Config &config) : ring_path_(ring_path), config_(config) {}
+
+BroadcastSender::~BroadcastSender() {
+    if (ring_.IsOpen()) {
+        ring_.Close();
+        unlink(ring_path_.c_str());
+    }
+}
+
+bool BroadcastSender::Initialize() {
+    if (!ring_.Create(ring_path_, config_.capacity, config_.futex_wakeup)) {
+        return false;
+    }
+    std::cout << "Broadcast ring ready at: " << ring_path_ << std::endl;
+    return true;
+}
+
+bool BroadcastSender::SendData(const void *data, size_t size) { return Send(0, nullptr, 0, data, size); }
+
+bool BroadcastSender::SendTimestampedData(const void *data, size_t size, uint64_t origin_ns) {
+    uint64_t timestamps[2] = {origin_ns, Telemetry::NowNanos()};
+    return Send(kTimestampedFrameFlag, timestamps, sizeof(timestamps), data, size);
+}
+
+bool BroadcastSender::Send(uint32_t flags, const void *prefix, size_t prefix_size, const void *data, size_t size) {
+    if (!ring_.IsOpen()) {
+        std::cerr << "Broadcast ring not initialized" << std::endl;
+        return false;
+    }
+
+    if (size > GetMaxMessageSize()) {
+        std::cerr << "Message of " << size << " bytes exceeds the broadcast ring's limit of " << GetMaxMessageSize() << std::endl;
+        return false;
+    }
+
+    return ring_.Write(flags, prefix, prefix_size, data, size);
+}
+
+} // namespace IPC
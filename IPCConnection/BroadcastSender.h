@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "BroadcastRing.h"
+#include "IPCFrame.h"
+
+namespace IPC {
+
+// One-to-many publisher over a BroadcastRing it creates at ring_path (e.g.
+// /dev/shm/bbo) and removes on destruction. Any number of BroadcastReceivers
+// read the same frames, each at its own pace. A send costs the same however
+// many there are and never waits: a receiver a whole ring behind loses the
+// oldest frames instead of holding the sender up.
+class BroadcastSender {
+  public:
+    struct Config {
+        size_t capacity = 1 << 22; // bytes, rounded up to a power of two
+        // Let receivers sleep on a futex; costs the sender a fence per message
+        bool futex_wakeup = true;
+    };
+
+    explicit BroadcastSender(const std::string &ring_path) : BroadcastSender(ring_path, Config{}) {}
+    BroadcastSender(const std::string &ring_path, const Config &config);
+    ~BroadcastSender();
+
+    bool Initialize();
+
+    // False only if the ring is not initialized or the message is too large
+    bool SendData(const void *data, size_t size);
+    bool SendTimestampedData(const void *data, size_t size, uint64_t origin_ns);
+
+    // Changes whenever a receiver attaches or is lapped and skips ahead, so
+    // per-stream state (e.g. instrument announcements) can be republished
+    // for it
+    uint32_t GetReaderGeneration() const { return ring_.IsOpen() ? ring_.GetReaderGeneration() : 0; }
+
+    bool IsInitialized() const { return ring_.IsOpen(); }
+
+    // Largest payload SendTimestampedData (and so every send) accepts
+    size_t GetMaxMessageSize() const { return ring_.IsOpen() ? ring_.GetMaxRecordSize() - sizeof(uint64_t) * 2 : 0; }
+
+    const std::string &GetRingPath() const { return ring_path_; }
+
+  private:
+    bool Send(uint32_t flags, const void *prefix, size_t prefix_size, const void *data, size_t size);
+
+    std::string ring_path_;
+    Config config_;
+    BroadcastRing ring_;
+};
+
+} // namespace IPC
@@ -0,0 +1,188 @@
+#include "BroadcastReceiver.h"
+#include "BroadcastSender.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace IPC {
+
+namespace {
+
+// Every word of a frame holds its index, so a torn copy is easy to spot
+using Frame = std::array<uint64_t, 24>;
+
+Frame make_frame(uint64_t index) {
+    Frame frame;
+    frame.fill(index);
+    return frame;
+}
+
+bool read_frame(BroadcastReceiver &receiver, std::vector<uint8_t> &data, Frame &frame) {
+    if (!receiver.TryReadData(data) || data.size() != sizeof(Frame)) {
+        return false;
+    }
+    memcpy(frame.data(), data.data(), sizeof(Frame));
+    return true;
+}
+
+} // namespace
+
+TEST(BroadcastTest, EveryReaderGetsEveryFrame) {
+    BroadcastSender sender("/dev/shm/test_broadcast_fanout");
+    ASSERT_TRUE(sender.Initialize());
+    EXPECT_EQ(sender.GetReaderGeneration(), 0u);
+
+    BroadcastReceiver first;
+    BroadcastReceiver second;
+    ASSERT_TRUE(first.Connect(sender.GetRingPath()));
+    ASSERT_TRUE(second.Connect(sender.GetRingPath()));
+    EXPECT_EQ(sender.GetReaderGeneration(), 2u);
+    EXPECT_TRUE(first.IsSenderAttached());
+
+    std::string message = "Hello, everyone!";
+    EXPECT_TRUE(sender.SendData(message.data(), message.size()));
+    EXPECT_TRUE(sender.SendTimestampedData(message.data(), 5, 42));
+
+    for (BroadcastReceiver *receiver : {&first, &second}) {
+        auto data = receiver->ReadData();
+        EXPECT_EQ(std::string(data.begin(), data.end()), message);
+        EXPECT_EQ(receiver->GetLastFrameTimestamps().origin_ns, 0u);
+
+        data = receiver->ReadData();
+        EXPECT_EQ(std::string(data.begin(), data.end()), "Hello");
+        const FrameTimestamps &stamps = receiver->GetLastFrameTimestamps();
+        EXPECT_EQ(stamps.origin_ns, 42u);
+        EXPECT_GE(stamps.receive_ns, stamps.send_ns);
+
+        EXPECT_FALSE(receiver->TryReadData(data));
+        EXPECT_FALSE(receiver->WaitForData(10));
+        EXPECT_EQ(receiver->GetOverrunCount(), 0u);
+    }
+
+    // A late reader sees only what is sent after it connects
+    BroadcastReceiver late;
+    ASSERT_TRUE(late.Connect(sender.GetRingPath()));
+    EXPECT_EQ(sender.GetReaderGeneration(), 3u);
+    std::vector<uint8_t> data;
+    EXPECT_FALSE(late.TryReadData(data));
+    EXPECT_TRUE(sender.SendData("x", 1));
+    EXPECT_TRUE(late.TryReadData(data));
+    EXPECT_TRUE(first.TryReadData(data));
+
+    std::string too_big(sender.GetMaxMessageSize() + 1, 'x');
+    EXPECT_FALSE(sender.SendData(too_big.data(), too_big.size()));
+}
+
+TEST(BroadcastTest, LappedReaderSkipsAheadAndCountsLoss) {
+    BroadcastSender sender("/dev/shm/test_broadcast_lapped", BroadcastSender::Config{.capacity = 4096});
+    ASSERT_TRUE(sender.Initialize());
+
+    BroadcastReceiver reader;
+    ASSERT_TRUE(reader.Connect(sender.GetRingPath()));
+
+    // Nobody reads while the sender laps the ring many times over; it never waits
+    constexpr uint64_t kFrames = 1000;
+    for (uint64_t i = 0; i < kFrames; ++i) {
+        Frame frame = make_frame(i);
+        ASSERT_TRUE(sender.SendData(frame.data(), sizeof(frame)));
+    }
+
+    // The first read finds its cursor overwritten and skips past everything
+    // published so far; it carries on from the next frame
+    std::vector<uint8_t> data;
+    Frame frame;
+    EXPECT_EQ(sender.GetReaderGeneration(), 1u);
+    EXPECT_FALSE(read_frame(reader, data, frame));
+    EXPECT_EQ(reader.GetOverrunCount(), 1u);
+
+    // ...and tells the sender it missed whatever per-stream state it had sent
+    EXPECT_EQ(sender.GetReaderGeneration(), 2u);
+
+    for (uint64_t i = kFrames; i < kFrames + 3; ++i) {
+        frame = make_frame(i);
+        ASSERT_TRUE(sender.SendData(frame.data(), sizeof(frame)));
+    }
+
+    uint64_t received = 0;
+    while (read_frame(reader, data, frame)) {
+        EXPECT_EQ(frame.front(), kFrames + received);
+        EXPECT_EQ(frame.back(), frame.front());
+        received++;
+    }
+    EXPECT_EQ(received, 3u);
+    EXPECT_EQ(reader.GetLostCount(), kFrames);
+    EXPECT_EQ(reader.GetOverrunCount(), 1u);
+}
+
+TEST(BroadcastTest, ConcurrentReadersNeverSeeTornFrames) {
+    auto sender = std::make_unique<BroadcastSender>("/dev/shm/test_broadcast_concurrent", BroadcastSender::Config{.capacity = 16384});
+    ASSERT_TRUE(sender->Initialize());
+
+    constexpr uint64_t kFrames = 200000;
+    struct Result {
+        uint64_t received = 0;
+        uint64_t torn = 0;
+        uint64_t out_of_order = 0;
+        uint64_t lost = 0;
+    };
+
+    auto run_reader = [path = sender->GetRingPath()](Result &result, bool slow) {
+        BroadcastReceiver reader;
+        ASSERT_TRUE(reader.Connect(path));
+
+        std::vector<uint8_t> data;
+        Frame frame;
+        int64_t last = -1;
+        do {
+            while (read_frame(reader, data, frame)) {
+                result.torn += std::any_of(frame.begin(), frame.end(), [&frame](uint64_t word) { return word != frame.front(); });
+                result.out_of_order += static_cast<int64_t>(frame.front()) <= last;
+                last = frame.front();
+                result.received++;
+                if (slow && result.received % 64 == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+        } while (reader.WaitForData(-1));
+        result.lost = reader.GetLostCount();
+    };
+
+    Result fast;
+    Result slow;
+    std::thread fast_reader(run_reader, std::ref(fast), false);
+    std::thread slow_reader(run_reader, std::ref(slow), true);
+    while (sender->GetReaderGeneration() < 2) {
+        std::this_thread::yield();
+    }
+
+    for (uint64_t i = 0; i < kFrames; ++i) {
+        Frame frame = make_frame(i);
+        ASSERT_TRUE(sender->SendData(frame.data(), sizeof(frame)));
+    }
+
+    // Detaching wakes the readers, which stop once they have drained the ring
+    BroadcastReceiver probe;
+    ASSERT_TRUE(probe.Connect(sender->GetRingPath()));
+    sender.reset();
+    EXPECT_FALSE(probe.IsSenderAttached());
+    EXPECT_FALSE(probe.WaitForData(-1));
+
+    fast_reader.join();
+    slow_reader.join();
+
+    for (const Result *result : {&fast, &slow}) {
+        EXPECT_EQ(result->torn, 0u);
+        EXPECT_EQ(result->out_of_order, 0u);
+        EXPECT_EQ(result->received + result->lost, kFrames);
+    }
+
+    // The sender never waited for the slow reader; it was lapped instead
+    EXPECT_GT(slow.lost, 0u);
+}
+
+} // namespace IPC
@@ -0,0 +1,55 @@
+#include "CaptureReader.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+namespace IPC {
+
+bool CaptureReader::Open(const std::string &path) {
+    Close();
+
+    fd_ = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open capture file " << path << ": " << strerror(errno) << std::endl;
+        fd_ = -1;
+        return false;
+    }
+    reader_ = FrameReader();
+    return true;
+}
+
+void CaptureReader::Close() {
+    if (fd_ != -1) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool CaptureReader::NextFrame(std::span<const uint8_t> &frame, FrameTimestamps &timestamps) {
+    if (fd_ == -1) {
+        return false;
+    }
+
+    while (!reader_.NextFrame(frame, timestamps)) {
+        if (reader_.HasOversizedFrame()) {
+            std::cerr << "Capture has a corrupt frame header" << std::endl;
+            return false;
+        }
+        ssize_t bytes_read = read(fd_, chunk_.data(), chunk_.size());
+        if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_read < 0) {
+            std::cerr << "Failed to read capture: " << strerror(errno) << std::endl;
+        }
+        if (bytes_read <= 0) {
+            return false;
+        }
+        reader_.Append(chunk_.data(), bytes_read);
+    }
+    return true;
+}
+
+} // namespace IPC
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "FrameReader.h"
+#include "IPCFrame.h"
+
+namespace IPC {
+
+// Replays a CaptureWriter file frame by frame, reading it in large chunks
+class CaptureReader {
+  public:
+    CaptureReader() = default;
+    ~CaptureReader() { Close(); }
+
+    CaptureReader(const CaptureReader &) = delete;
+    CaptureReader &operator=(const CaptureReader &) = delete;
+
+    bool Open(const std::string &path);
+    void Close();
+
+    // The next frame, valid until the next call. timestamps get its origin
+    // time and, as send_ns, the time it was captured. false at the end of
+    // the file (a frame cut short by a crash is dropped).
+    bool NextFrame(std::span<const uint8_t> &frame, FrameTimestamps &timestamps);
+
+    bool IsOpen() const { return fd_ != -1; }
+
+  private:
+    int fd_ = -1;
+    FrameReader reader_;
+    std::vector<uint8_t> chunk_ = std::vector<uint8_t>(FrameReader::kDefaultChunkSize);
+};
+
+} // namespace IPC
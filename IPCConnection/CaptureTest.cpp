@@ -0,0 +1,84 @@
+#include "CaptureReader.h"
+#include "CaptureWriter.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace IPC {
+
+namespace {
+
+std::string make_frame(size_t index) { return std::string(index * 37 % 3000 + 1, static_cast<char>('a' + index % 26)); }
+
+} // namespace
+
+TEST(CaptureTest, RoundTripsOnEitherBackend) {
+    for (IoBackend backend : {IoBackend::POSIX, IoBackend::IO_URING}) {
+        const std::string path = "/tmp/test_capture.bin";
+
+        // Small buffers, so most writes wait for one to come back from disk
+        CaptureWriter writer(CaptureWriter::Config{.io_backend = backend, .buffer_size = 8192, .num_buffers = 2});
+        ASSERT_TRUE(writer.Open(path));
+        EXPECT_EQ(writer.GetIoBackend(), ResolveIoBackend(backend));
+
+        constexpr size_t kFrames = 5000;
+        constexpr size_t kHeaderSize = 20; // prefix and both stamps
+        uint64_t expected_bytes = 0;
+        for (size_t i = 0; i < kFrames; ++i) {
+            std::string frame = make_frame(i);
+            ASSERT_TRUE(writer.Write(frame.data(), frame.size(), i + 1));
+            expected_bytes += kHeaderSize + frame.size();
+        }
+        // Larger than a buffer: written on its own, in order
+        std::string large(20000, 'L');
+        ASSERT_TRUE(writer.Write(large.data(), large.size(), kFrames + 1));
+        std::string last = "last";
+        ASSERT_TRUE(writer.Write(last.data(), last.size()));
+        ASSERT_TRUE(writer.Flush());
+        EXPECT_EQ(writer.GetBytesWritten(), expected_bytes + 2 * kHeaderSize + large.size() + last.size());
+        writer.Close();
+
+        CaptureReader reader;
+        ASSERT_TRUE(reader.Open(path));
+        std::span<const uint8_t> frame;
+        FrameTimestamps timestamps;
+        for (size_t i = 0; i < kFrames; ++i) {
+            ASSERT_TRUE(reader.NextFrame(frame, timestamps));
+            ASSERT_EQ(std::string(frame.begin(), frame.end()), make_frame(i));
+            EXPECT_EQ(timestamps.origin_ns, i + 1);
+            EXPECT_NE(timestamps.send_ns, 0u);
+        }
+        ASSERT_TRUE(reader.NextFrame(frame, timestamps));
+        EXPECT_EQ(std::string(frame.begin(), frame.end()), large);
+        ASSERT_TRUE(reader.NextFrame(frame, timestamps));
+        EXPECT_EQ(std::string(frame.begin(), frame.end()), last);
+        EXPECT_EQ(timestamps.origin_ns, 0u);
+        EXPECT_FALSE(reader.NextFrame(frame, timestamps));
+    }
+}
+
+TEST(CaptureTest, DropsFrameCutShort) {
+    const std::string path = "/tmp/test_capture_cut.bin";
+    {
+        CaptureWriter writer;
+        ASSERT_TRUE(writer.Open(path));
+        ASSERT_TRUE(writer.Write("whole", 5, 1));
+        ASSERT_TRUE(writer.Write("cut short", 9, 2));
+    }
+
+    // As if the process died halfway through writing the second frame
+    ASSERT_EQ(truncate(path.c_str(), 20 + 5 + 20 + 4), 0);
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.Open(path));
+    std::span<const uint8_t> frame;
+    FrameTimestamps timestamps;
+    ASSERT_TRUE(reader.NextFrame(frame, timestamps));
+    EXPECT_EQ(std::string(frame.begin(), frame.end()), "whole");
+    EXPECT_FALSE(reader.NextFrame(frame, timestamps));
+
+    EXPECT_FALSE(reader.Open("/tmp/no_such_capture.bin"));
+}
+
+} // namespace IPC
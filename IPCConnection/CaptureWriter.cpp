@@ -0,0 +1,221 @@
+#include "CaptureWriter.h"
+#include "Telemetry/Clock.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+namespace IPC {
+
+namespace {
+
+constexpr size_t kHeaderSize = sizeof(uint32_t) + sizeof(uint64_t) * 2;
+
+bool pwrite_all(int fd, const uint8_t *data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t written = pwrite(fd, data, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Failed to write capture: " << strerror(errno) << std::endl;
+            return false;
+        }
+        data += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
+
+} // namespace
+
+bool CaptureWriter::Open(const std::string &path) {
+    Close();
+
+    fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open capture file " << path << ": " << strerror(errno) << std::endl;
+        fd_ = -1;
+        return false;
+    }
+
+    buffers_ = std::vector<Buffer>(std::clamp(config_.num_buffers, 1u, 1024u));
+    for (Buffer &buffer : buffers_) {
+        buffer.data.resize(std::max<size_t>(config_.buffer_size, 4096));
+    }
+    current_ = 0;
+    file_offset_ = 0;
+    failed_ = false;
+
+    if (ResolveIoBackend(config_.io_backend) == IoBackend::IO_URING && !SetupIoUring()) {
+        std::cerr << "Falling back to POSIX writes" << std::endl;
+        uring_.reset();
+    }
+
+    std::cout << "Capturing frames to: " << path << std::endl;
+    return true;
+}
+
+bool CaptureWriter::SetupIoUring() {
+    uring_ = std::make_unique<IoUring>();
+    if (!uring_->Initialize(buffers_.size())) {
+        return false;
+    }
+
+    std::vector<iovec> registered;
+    for (Buffer &buffer : buffers_) {
+        registered.push_back({buffer.data.data(), buffer.data.size()});
+    }
+    return uring_->RegisterBuffers(registered);
+}
+
+bool CaptureWriter::Write(const void *data, size_t size, uint64_t origin_ns) {
+    if (fd_ == -1 || failed_) {
+        return false;
+    }
+    if (size >= kTimestampedFrameFlag) {
+        std::cerr << "Frame too large to capture: " << size << " bytes" << std::endl;
+        return false;
+    }
+
+    uint8_t header[kHeaderSize];
+    uint32_t prefix = static_cast<uint32_t>(size) | kTimestampedFrameFlag;
+    uint64_t timestamps[2] = {origin_ns, Telemetry::NowNanos()};
+    memcpy(header, &prefix, sizeof(prefix));
+    memcpy(header + sizeof(prefix), timestamps, sizeof(timestamps));
+
+    size_t frame_size = kHeaderSize + size;
+    Buffer *buffer = &buffers_[current_];
+    if (buffer->used + frame_size > buffer->data.size()) {
+        if (!WriteOut(current_)) {
+            return false;
+        }
+        current_ = (current_ + 1) % buffers_.size();
+        if (!WaitForBuffer(current_)) {
+            return false;
+        }
+        buffer = &buffers_[current_];
+    }
+
+    // Too large for any buffer: written on its own, after the ones before it
+    if (frame_size > buffer->data.size()) {
+        return WriteDirect(header, data, size);
+    }
+
+    if (buffer->used == 0) {
+        buffer->offset = file_offset_;
+    }
+    memcpy(buffer->data.data() + buffer->used, header, kHeaderSize);
+    memcpy(buffer->data.data() + buffer->used + kHeaderSize, data, size);
+    buffer->used += frame_size;
+    file_offset_ += frame_size;
+    return true;
+}
+
+bool CaptureWriter::WriteDirect(const uint8_t *header, const void *data, size_t size) {
+    if (!pwrite_all(fd_, header, kHeaderSize, file_offset_) ||
+        !pwrite_all(fd_, static_cast<const uint8_t *>(data), size, file_offset_ + kHeaderSize)) {
+        failed_ = true;
+        return false;
+    }
+    file_offset_ += kHeaderSize + size;
+    return true;
+}
+
+bool CaptureWriter::WriteOut(uint16_t index) {
+    Buffer &buffer = buffers_[index];
+    if (buffer.used == 0) {
+        return true;
+    }
+
+    if (uring_) {
+        buffer.written = 0;
+        buffer.in_flight = true;
+        return SubmitWrite(index);
+    }
+
+    if (!pwrite_all(fd_, buffer.data.data(), buffer.used, buffer.offset)) {
+        failed_ = true;
+        return false;
+    }
+    buffer.used = 0;
+    return true;
+}
+
+bool CaptureWriter::SubmitWrite(uint16_t index) {
+    Buffer &buffer = buffers_[index];
+    io_uring_sqe *sqe = uring_->GetSqe();
+    if (!sqe) {
+        failed_ = true;
+        return false;
+    }
+
+    IoUring::PrepWriteFixed(sqe, fd_, buffer.data.data() + buffer.written, buffer.used - buffer.written, buffer.offset + buffer.written, index,
+                            index);
+    if (uring_->Submit() < 0) {
+        failed_ = true;
+    }
+    return !failed_;
+}
+
+void CaptureWriter::ReapCompletions() {
+    uring_->ForEachCompletion([this](const io_uring_cqe &cqe) {
+        uint16_t index = static_cast<uint16_t>(cqe.user_data);
+        Buffer &buffer = buffers_[index];
+        if (cqe.res <= 0) {
+            std::cerr << "Failed to write capture: " << strerror(cqe.res < 0 ? -cqe.res : EIO) << std::endl;
+            failed_ = true;
+            buffer.in_flight = false;
+            buffer.used = 0;
+            return;
+        }
+
+        buffer.written += cqe.res;
+        if (buffer.written < buffer.used) {
+            // Short write: send the rest
+            SubmitWrite(index);
+            return;
+        }
+        buffer.in_flight = false;
+        buffer.used = 0;
+    });
+}
+
+bool CaptureWriter::WaitForBuffer(uint16_t index) {
+    while (!failed_ && buffers_[index].in_flight) {
+        ReapCompletions();
+        if (buffers_[index].in_flight && uring_->Submit(1) < 0) {
+            failed_ = true;
+        }
+    }
+    return !failed_;
+}
+
+bool CaptureWriter::Flush() {
+    if (fd_ == -1 || !WriteOut(current_)) {
+        return false;
+    }
+    if (uring_) {
+        for (uint16_t index = 0; index < buffers_.size(); ++index) {
+            WaitForBuffer(index);
+        }
+    }
+    return !failed_;
+}
+
+void CaptureWriter::Close() {
+    if (fd_ == -1) {
+        return;
+    }
+
+    Flush();
+    uring_.reset();
+    close(fd_);
+    fd_ = -1;
+    buffers_.clear();
+}
+
+} // namespace IPC
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IPCFrame.h"
+#include "IoUring.h"
+
+namespace IPC {
+
+// Records frames to a file in the IPC framing, each stamped with its origin
+// time and the time it was captured (as send_ns), for CaptureReader to
+// replay. Frames are gathered in a few large buffers and each full buffer is
+// written out in one go.
+//
+// With IoBackend::IO_URING the buffers are registered with the kernel and
+// written asynchronously (IORING_OP_WRITE_FIXED): Write only blocks when
+// every buffer is still on its way to disk, and completions are reaped from
+// the ring without a system call. With POSIX a full buffer is a pwrite.
+class CaptureWriter {
+  public:
+    struct Config {
+        IoBackend io_backend = IoBackend::POSIX; // IO_URING falls back to POSIX where unavailable
+        size_t buffer_size = 1 << 20;
+        unsigned num_buffers = 4;
+    };
+
+    CaptureWriter() : CaptureWriter(Config{}) {}
+    explicit CaptureWriter(const Config &config) : config_(config) {}
+    ~CaptureWriter() { Close(); }
+
+    CaptureWriter(const CaptureWriter &) = delete;
+    CaptureWriter &operator=(const CaptureWriter &) = delete;
+
+    // Creates or truncates path
+    bool Open(const std::string &path);
+
+    // false once a write to the file has failed
+    bool Write(const void *data, size_t size, uint64_t origin_ns = 0);
+
+    // Writes out what is buffered and waits until all of it is in the file
+    bool Flush();
+
+    // Flushes and closes
+    void Close();
+
+    bool IsOpen() const { return fd_ != -1; }
+
+    // Backend in use once open
+    IoBackend GetIoBackend() const { return uring_ ? IoBackend::IO_URING : IoBackend::POSIX; }
+
+    uint64_t GetBytesWritten() const { return file_offset_; }
+
+  private:
+    struct Buffer {
+        std::vector<uint8_t> data;
+        size_t used = 0;
+        size_t written = 0;   // of used, confirmed by completions
+        uint64_t offset = 0;  // in the file
+        bool in_flight = false;
+    };
+
+    bool SetupIoUring();
+    bool WriteOut(uint16_t index);
+    bool WriteDirect(const uint8_t *header, const void *data, size_t size);
+    bool SubmitWrite(uint16_t index);
+    void ReapCompletions();
+    bool WaitForBuffer(uint16_t index);
+
+    Config config_;
+    int fd_ = -1;
+    std::unique_ptr<IoUring> uring_;
+
+    std::vector<Buffer> buffers_;
+    uint16_t current_ = 0;
+    uint64_t file_offset_ = 0; // end of everything written or buffered
+    bool failed_ = false;
+};
+
+} // namespace IPC
@@ -0,0 +1,122 @@
+#include "EventLoop.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace IPC {
+
+EventLoop::EventLoop(const Config &config) : config_(config) {
+    if (config_.max_events < 1) {
+        config_.max_events = 1;
+    }
+    ready_.resize(config_.max_events);
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        std::cerr << "Failed to create epoll instance: " << strerror(errno) << std::endl;
+        return;
+    }
+
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = wakeup_fd_;
+    if (wakeup_fd_ < 0 || epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &event) < 0) {
+        std::cerr << "Failed to create wakeup eventfd: " << strerror(errno) << std::endl;
+    }
+}
+
+EventLoop::~EventLoop() {
+    if (wakeup_fd_ != -1) {
+        close(wakeup_fd_);
+    }
+    if (epoll_fd_ != -1) {
+        close(epoll_fd_);
+    }
+}
+
+bool EventLoop::Add(int fd, uint32_t events, Handler handler) {
+    if (fd < 0 || epoll_fd_ == -1) {
+        return false;
+    }
+
+    struct epoll_event event = {};
+    event.events = events;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+        std::cerr << "Failed to add descriptor " << fd << " to epoll: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (static_cast<size_t>(fd) >= handlers_.size()) {
+        handlers_.resize(fd + 1);
+    }
+    handlers_[fd] = std::make_shared<Handler>(std::move(handler));
+    return true;
+}
+
+bool EventLoop::Modify(int fd, uint32_t events) {
+    struct epoll_event event = {};
+    event.events = events;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) < 0) {
+        std::cerr << "Failed to modify descriptor " << fd << " in epoll: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void EventLoop::Remove(int fd) {
+    if (fd < 0 || static_cast<size_t>(fd) >= handlers_.size() || !handlers_[fd]) {
+        return;
+    }
+
+    // Fails harmlessly when the descriptor was already closed, which removes
+    // it from the epoll set by itself
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    handlers_[fd].reset();
+}
+
+int EventLoop::Poll(int timeout_ms) {
+    if (epoll_fd_ == -1) {
+        return 0;
+    }
+
+    int count = epoll_wait(epoll_fd_, ready_.data(), config_.max_events, config_.busy_poll ? 0 : timeout_ms);
+    if (count < 0) {
+        if (errno != EINTR) {
+            std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+        }
+        return 0;
+    }
+
+    int handled = 0;
+    for (int i = 0; i < count; ++i) {
+        int fd = ready_[i].data.fd;
+        if (fd == wakeup_fd_) {
+            uint64_t value;
+            ssize_t drained = read(wakeup_fd_, &value, sizeof(value));
+            (void)drained;
+            continue;
+        }
+
+        // An earlier handler in this batch may have removed the descriptor
+        if (static_cast<size_t>(fd) >= handlers_.size() || !handlers_[fd]) {
+            continue;
+        }
+        std::shared_ptr<Handler> handler = handlers_[fd];
+        (*handler)(ready_[i].events);
+        handled++;
+    }
+    return handled;
+}
+
+void EventLoop::Wakeup() {
+    uint64_t one = 1;
+    ssize_t written = write(wakeup_fd_, &one, sizeof(one));
+    (void)written;
+}
+
+} // namespace IPC
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <sys/epoll.h>
+#include <vector>
+
+namespace IPC {
+
+// Level-triggered epoll dispatcher over file descriptors. Handlers run on the
+// thread calling Poll() and may add, modify or remove any descriptor,
+// including their own.
+class EventLoop {
+  public:
+    using Handler = std::function<void(uint32_t events)>;
+
+    struct Config {
+        // Spin on non-blocking epoll_wait instead of sleeping in the kernel:
+        // lower wakeup latency for a dedicated core
+        bool busy_poll = false;
+        int max_events = 64; // per Poll()
+    };
+
+    EventLoop() : EventLoop(Config{}) {}
+    explicit EventLoop(const Config &config);
+    ~EventLoop();
+
+    EventLoop(const EventLoop &) = delete;
+    EventLoop &operator=(const EventLoop &) = delete;
+
+    bool IsValid() const { return epoll_fd_ != -1; }
+    const Config &GetConfig() const { return config_; }
+    void SetBusyPoll(bool busy_poll) { config_.busy_poll = busy_poll; }
+
+    // events are EPOLLIN/EPOLLOUT/...; 0 keeps the descriptor registered but quiet
+    bool Add(int fd, uint32_t events, Handler handler);
+    bool Modify(int fd, uint32_t events);
+    void Remove(int fd);
+
+    // Waits up to timeout_ms (-1 without limit; always 0 with busy_poll) and
+    // runs the handlers of ready descriptors. Returns the number handled.
+    int Poll(int timeout_ms);
+
+    // Thread-safe: makes a blocked Poll() return
+    void Wakeup();
+
+  private:
+    Config config_;
+    int epoll_fd_ = -1;
+    int wakeup_fd_ = -1;
+
+    // Indexed by descriptor; shared so a handler can remove itself while running
+    std::vector<std::shared_ptr<Handler>> handlers_;
+    std::vector<epoll_event> ready_;
+};
+
+} // namespace IPC
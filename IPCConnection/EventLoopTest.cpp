@@ -0,0 +1,111 @@
+#include "EventLoop.h"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <sys/epoll.h>
+#include <thread>
+#include <unistd.h>
+
+namespace IPC {
+
+namespace {
+
+struct Pipe {
+    Pipe() { EXPECT_EQ(pipe(fds), 0); }
+    ~Pipe() {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    void Write() { EXPECT_EQ(write(fds[1], "x", 1), 1); }
+    void Drain() {
+        char byte;
+        EXPECT_EQ(read(fds[0], &byte, 1), 1);
+    }
+
+    int fds[2];
+};
+
+} // namespace
+
+TEST(EventLoopTest, DispatchesReadyDescriptors) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.IsValid());
+
+    Pipe pipe;
+    int calls = 0;
+    uint32_t seen_events = 0;
+    ASSERT_TRUE(loop.Add(pipe.fds[0], EPOLLIN, [&](uint32_t events) {
+        calls++;
+        seen_events = events;
+        pipe.Drain();
+    }));
+
+    EXPECT_EQ(loop.Poll(0), 0);
+
+    pipe.Write();
+    EXPECT_EQ(loop.Poll(1000), 1);
+    EXPECT_EQ(calls, 1);
+    EXPECT_TRUE(seen_events & EPOLLIN);
+
+    // Drained, and a quiet registration does not report at all
+    EXPECT_EQ(loop.Poll(0), 0);
+    pipe.Write();
+    ASSERT_TRUE(loop.Modify(pipe.fds[0], 0));
+    EXPECT_EQ(loop.Poll(0), 0);
+    ASSERT_TRUE(loop.Modify(pipe.fds[0], EPOLLIN));
+    EXPECT_EQ(loop.Poll(0), 1);
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(EventLoopTest, HandlersMayRemoveDescriptors) {
+    EventLoop loop;
+    Pipe first;
+    Pipe second;
+    int first_calls = 0;
+    int second_calls = 0;
+
+    // Whichever runs first removes both, so the other is skipped even though
+    // it was reported in the same batch
+    auto remove_both = [&]() {
+        loop.Remove(first.fds[0]);
+        loop.Remove(second.fds[0]);
+    };
+    ASSERT_TRUE(loop.Add(first.fds[0], EPOLLIN, [&](uint32_t) {
+        first_calls++;
+        remove_both();
+    }));
+    ASSERT_TRUE(loop.Add(second.fds[0], EPOLLIN, [&](uint32_t) {
+        second_calls++;
+        remove_both();
+    }));
+
+    first.Write();
+    second.Write();
+    EXPECT_EQ(loop.Poll(1000), 1);
+    EXPECT_EQ(first_calls + second_calls, 1);
+    EXPECT_EQ(loop.Poll(0), 0);
+}
+
+TEST(EventLoopTest, WakeupInterruptsBlockingPoll) {
+    EventLoop loop;
+
+    std::thread waker([&loop]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        loop.Wakeup();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(loop.Poll(-1), 0);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    waker.join();
+}
+
+TEST(EventLoopTest, BusyPollNeverBlocks) {
+    EventLoop loop(EventLoop::Config{.busy_poll = true});
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(loop.Poll(5000), 0);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+} // namespace IPC
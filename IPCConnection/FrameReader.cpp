@@ -0,0 +1,118 @@
+#include "FrameReader.h"
+#include "Telemetry/Clock.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+
+namespace IPC {
+
+namespace {
+
+constexpr size_t kTimestampsSize = sizeof(uint64_t) * 2;
+
+} // namespace
+
+FrameReader::FrameReader(size_t chunk_size, size_t max_frame_size)
+    : chunk_size_(std::max<size_t>(chunk_size, 64)), max_frame_size_(max_frame_size), buffer_(chunk_size_) {}
+
+size_t FrameReader::GetFrameSize() const {
+    if (end_ - begin_ < sizeof(uint32_t)) {
+        return 0;
+    }
+
+    uint32_t prefix;
+    memcpy(&prefix, buffer_.data() + begin_, sizeof(prefix));
+    size_t header_size = sizeof(prefix) + (prefix & kTimestampedFrameFlag ? kTimestampsSize : 0);
+    return header_size + (prefix & ~kTimestampedFrameFlag);
+}
+
+bool FrameReader::HasFrame() const {
+    size_t frame_size = GetFrameSize();
+    return frame_size != 0 && frame_size <= end_ - begin_ && !HasOversizedFrame();
+}
+
+bool FrameReader::HasOversizedFrame() const {
+    if (end_ - begin_ < sizeof(uint32_t)) {
+        return false;
+    }
+
+    uint32_t prefix;
+    memcpy(&prefix, buffer_.data() + begin_, sizeof(prefix));
+    return (prefix & ~kTimestampedFrameFlag) > max_frame_size_;
+}
+
+void FrameReader::Reserve(size_t size) {
+    if (begin_ > 0) {
+        memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+
+    // Room for size more bytes, or for the rest of a frame larger than that
+    // unless the peer's prefix claims more than any frame may be
+    size_t wanted = std::max(end_ + size, HasOversizedFrame() ? 0 : GetFrameSize());
+    if (buffer_.size() < wanted) {
+        buffer_.resize(wanted);
+    }
+}
+
+void FrameReader::Append(const uint8_t *data, size_t size) {
+    Reserve(size);
+    memcpy(buffer_.data() + end_, data, size);
+    end_ += size;
+    chunk_receive_ns_ = Telemetry::NowNanos();
+}
+
+FrameReader::ReadResult FrameReader::ReadFrom(int fd) {
+    if (HasOversizedFrame()) {
+        errno = EMSGSIZE;
+        return ReadResult::FAILED;
+    }
+    Reserve(chunk_size_);
+
+    while (true) {
+        ssize_t bytes_read = recv(fd, buffer_.data() + end_, buffer_.size() - end_, MSG_DONTWAIT);
+        if (bytes_read > 0) {
+            end_ += bytes_read;
+            chunk_receive_ns_ = Telemetry::NowNanos();
+            return ReadResult::DATA;
+        }
+        if (bytes_read == 0) {
+            return ReadResult::CLOSED;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK ? ReadResult::WOULD_BLOCK : ReadResult::FAILED;
+    }
+}
+
+bool FrameReader::NextFrame(std::span<const uint8_t> &frame, FrameTimestamps &timestamps) {
+    if (!HasFrame()) {
+        return false;
+    }
+
+    const uint8_t *data = buffer_.data() + begin_;
+    uint32_t prefix;
+    memcpy(&prefix, data, sizeof(prefix));
+    data += sizeof(prefix);
+
+    timestamps = FrameTimestamps{};
+    if (prefix & kTimestampedFrameFlag) {
+        memcpy(&timestamps.origin_ns, data, sizeof(uint64_t));
+        memcpy(&timestamps.send_ns, data + sizeof(uint64_t), sizeof(uint64_t));
+        data += kTimestampsSize;
+    }
+    timestamps.receive_ns = chunk_receive_ns_;
+
+    size_t size = prefix & ~kTimestampedFrameFlag;
+    frame = std::span<const uint8_t>(data, size);
+    begin_ = data + size - buffer_.data();
+    if (begin_ == end_) {
+        begin_ = end_ = 0;
+    }
+    return true;
+}
+
+} // namespace IPC
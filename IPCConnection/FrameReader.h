@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "IPCFrame.h"
+
+namespace IPC {
+
+// Reassembles length-prefixed frames from a stream socket. Each ReadFrom is a
+// single non-blocking recv of up to a chunk into a buffer reused for the life
+// of the connection, after which NextFrame hands out views of every complete
+// frame in it. Only the partial frame left at the end of a chunk is moved.
+class FrameReader {
+  public:
+    static constexpr size_t kDefaultChunkSize = 64 * 1024;
+    static constexpr size_t kDefaultMaxFrameSize = 64 * 1024 * 1024;
+
+    enum class ReadResult { DATA, WOULD_BLOCK, CLOSED, FAILED };
+
+    // A length prefix claiming a payload over max_frame_size is never
+    // allocated for; see HasOversizedFrame
+    explicit FrameReader(size_t chunk_size = kDefaultChunkSize, size_t max_frame_size = kDefaultMaxFrameSize);
+
+    // Invalidates the views returned so far. FAILED with EMSGSIZE once an
+    // oversized frame is next.
+    ReadResult ReadFrom(int fd);
+
+    // Takes a chunk read elsewhere (an io_uring receive buffer, a capture
+    // file) as if ReadFrom had read it. Same invalidation.
+    void Append(const uint8_t *data, size_t size);
+
+    // The next complete frame, valid until the next ReadFrom. timestamps get
+    // the frame's carried stamps and the receive time of its chunk.
+    bool NextFrame(std::span<const uint8_t> &frame, FrameTimestamps &timestamps);
+
+    bool HasFrame() const;
+
+    // The next frame claims more than max_frame_size: it is never handed out
+    // and the stream cannot be trusted past it, so the connection should be
+    // dropped
+    bool HasOversizedFrame() const;
+
+    size_t GetBufferedBytes() const { return end_ - begin_; }
+
+  private:
+    // Bytes the frame at begin_ occupies, or 0 if its header is incomplete
+    size_t GetFrameSize() const;
+
+    // Moves the partial frame to the front and makes room for at least size more bytes
+    void Reserve(size_t size);
+
+    size_t chunk_size_;
+    size_t max_frame_size_;
+    std::vector<uint8_t> buffer_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    uint64_t chunk_receive_ns_ = 0;
+};
+
+} // namespace IPC
@@ -0,0 +1,117 @@
+#include "FrameReader.h"
+#include <cerrno>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace IPC {
+
+namespace {
+
+std::string encode_frame(const std::string &payload, const uint64_t *timestamps = nullptr) {
+    uint32_t prefix = static_cast<uint32_t>(payload.size()) | (timestamps ? kTimestampedFrameFlag : 0);
+    std::string frame(reinterpret_cast<const char *>(&prefix), sizeof(prefix));
+    if (timestamps) {
+        frame.append(reinterpret_cast<const char *>(timestamps), sizeof(uint64_t) * 2);
+    }
+    return frame + payload;
+}
+
+std::string as_string(std::span<const uint8_t> frame) { return std::string(frame.begin(), frame.end()); }
+
+struct SocketPair {
+    SocketPair() { EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0); }
+    ~SocketPair() {
+        close(fds[0]);
+        if (fds[1] != -1) {
+            close(fds[1]);
+        }
+    }
+
+    void Write(const std::string &bytes) { EXPECT_EQ(write(fds[1], bytes.data(), bytes.size()), static_cast<ssize_t>(bytes.size())); }
+
+    int fds[2];
+};
+
+} // namespace
+
+TEST(FrameReaderTest, SplitsOneChunkIntoFrames) {
+    SocketPair sockets;
+    FrameReader reader;
+
+    uint64_t timestamps[2] = {11, 22};
+    sockets.Write(encode_frame("first") + encode_frame("second", timestamps) + encode_frame(""));
+    ASSERT_EQ(reader.ReadFrom(sockets.fds[0]), FrameReader::ReadResult::DATA);
+
+    std::span<const uint8_t> frame;
+    FrameTimestamps stamps;
+    ASSERT_TRUE(reader.NextFrame(frame, stamps));
+    EXPECT_EQ(as_string(frame), "first");
+    EXPECT_EQ(stamps.origin_ns, 0u);
+    EXPECT_NE(stamps.receive_ns, 0u);
+
+    ASSERT_TRUE(reader.NextFrame(frame, stamps));
+    EXPECT_EQ(as_string(frame), "second");
+    EXPECT_EQ(stamps.origin_ns, 11u);
+    EXPECT_EQ(stamps.send_ns, 22u);
+
+    ASSERT_TRUE(reader.NextFrame(frame, stamps));
+    EXPECT_TRUE(frame.empty());
+    EXPECT_FALSE(reader.NextFrame(frame, stamps));
+    EXPECT_EQ(reader.ReadFrom(sockets.fds[0]), FrameReader::ReadResult::WOULD_BLOCK);
+}
+
+TEST(FrameReaderTest, ReassemblesFramesAcrossReads) {
+    SocketPair sockets;
+    FrameReader reader(64);
+
+    // A frame split mid-header, then one far larger than a chunk
+    std::string large(1000, 'x');
+    std::string bytes = encode_frame("split") + encode_frame(large);
+    sockets.Write(bytes.substr(0, 2));
+
+    std::span<const uint8_t> frame;
+    FrameTimestamps stamps;
+    ASSERT_EQ(reader.ReadFrom(sockets.fds[0]), FrameReader::ReadResult::DATA);
+    EXPECT_FALSE(reader.HasFrame());
+
+    sockets.Write(bytes.substr(2));
+    std::vector<std::string> frames;
+    while (frames.size() < 2) {
+        ASSERT_EQ(reader.ReadFrom(sockets.fds[0]), FrameReader::ReadResult::DATA);
+        while (reader.NextFrame(frame, stamps)) {
+            frames.push_back(as_string(frame));
+        }
+    }
+    EXPECT_EQ(frames[0], "split");
+    EXPECT_EQ(frames[1], large);
+    EXPECT_EQ(reader.GetBufferedBytes(), 0u);
+
+    close(sockets.fds[1]);
+    sockets.fds[1] = -1;
+    EXPECT_EQ(reader.ReadFrom(sockets.fds[0]), FrameReader::ReadResult::CLOSED);
+}
+
+TEST(FrameReaderTest, RefusesOversizedFrames) {
+    SocketPair sockets;
+    FrameReader reader(64, 100);
+
+    // A prefix claiming 2 GiB is not allocated for
+    uint32_t prefix = 0x7fffffff;
+    sockets.Write(encode_frame("fits") + std::string(reinterpret_cast<const char *>(&prefix), sizeof(prefix)) + "garbage");
+    ASSERT_EQ(reader.ReadFrom(sockets.fds[0]), FrameReader::ReadResult::DATA);
+
+    std::span<const uint8_t> frame;
+    FrameTimestamps stamps;
+    ASSERT_TRUE(reader.NextFrame(frame, stamps));
+    EXPECT_EQ(as_string(frame), "fits");
+    EXPECT_FALSE(reader.NextFrame(frame, stamps));
+    EXPECT_TRUE(reader.HasOversizedFrame());
+
+    EXPECT_EQ(reader.ReadFrom(sockets.fds[0]), FrameReader::ReadResult::FAILED);
+    EXPECT_EQ(errno, EMSGSIZE);
+}
+
+} // namespace IPC
@@ -1,6 +1,7 @@
 #include "IPCReceiver.h"
 #include "IPCSender.h"
 #include <chrono>
+#include <cstring>
 #include <gtest/gtest.h>
 #include <thread>
 
@@ -99,4 +100,276 @@ TEST(IPCConnectionTest, MultipleMessages) {
     }
 }
 
+TEST(IPCConnectionTest, TimestampedFrames) {
+    IPCReceiver receiver("test_timestamp_socket");
+    EXPECT_TRUE(receiver.Initialize());
+
+    std::vector<std::string> received_messages;
+    std::vector<FrameTimestamps> received_timestamps;
+
+    std::thread receiver_thread([&receiver, &received_messages, &received_timestamps]() {
+        for (int i = 0; i < 2; i++) {
+            auto data = receiver.ReadData();
+            received_messages.emplace_back(data.begin(), data.end());
+            received_timestamps.push_back(receiver.GetLastFrameTimestamps());
+        }
+    });
+
+    // Delay for setup
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    IPCSender sender;
+    EXPECT_TRUE(sender.Connect(receiver.GetSocketPath()));
+
+    std::string stamped = "stamped";
+    std::string plain = "plain";
+    EXPECT_TRUE(sender.SendTimestampedData(stamped.c_str(), stamped.size(), 12345));
+    EXPECT_TRUE(sender.SendData(plain.c_str(), plain.size()));
+
+    // A length reaching the timestamp flag bit would be misread: refused
+    // before anything is written
+    EXPECT_FALSE(sender.SendTimestampedData(plain.c_str(), kTimestampedFrameFlag, 1));
+    EXPECT_FALSE(sender.SendData(plain.c_str(), kTimestampedFrameFlag));
+    EXPECT_EQ(sender.TrySendData(plain.c_str(), kTimestampedFrameFlag), IPCSender::SendResult::FAILED);
+
+    receiver_thread.join();
+
+    ASSERT_EQ(received_messages.size(), 2);
+    EXPECT_EQ(received_messages[0], stamped);
+    EXPECT_EQ(received_timestamps[0].origin_ns, 12345);
+    EXPECT_GT(received_timestamps[0].send_ns, 0);
+    EXPECT_GE(received_timestamps[0].receive_ns, received_timestamps[0].send_ns);
+
+    // Untimestamped frames are unchanged on the wire and only get receive_ns
+    EXPECT_EQ(received_messages[1], plain);
+    EXPECT_EQ(received_timestamps[1].origin_ns, 0);
+    EXPECT_EQ(received_timestamps[1].send_ns, 0);
+    EXPECT_GE(received_timestamps[1].receive_ns, received_timestamps[0].receive_ns);
+}
+
+TEST(IPCConnectionTest, ServesManySenders) {
+    IPCReceiver receiver("test_many_senders_socket");
+    ASSERT_TRUE(receiver.Initialize());
+
+    constexpr int kSenders = 4;
+    constexpr int kMessagesPerSender = 500;
+    std::vector<std::thread> senders;
+    for (int id = 0; id < kSenders; ++id) {
+        senders.emplace_back([&receiver, id]() {
+            IPCSender sender;
+            ASSERT_TRUE(sender.Connect(receiver.GetSocketPath()));
+            for (int i = 0; i < kMessagesPerSender; ++i) {
+                int message[2] = {id, i};
+                ASSERT_TRUE(sender.SendData(message, sizeof(message)));
+            }
+        });
+    }
+
+    // Views straight into the per-connection buffers; each sender in order
+    std::vector<int> next(kSenders, 0);
+    for (int received = 0; received < kSenders * kMessagesPerSender; ++received) {
+        std::span<const uint8_t> frame;
+        ASSERT_TRUE(receiver.ReadFrame(frame, 5000));
+        ASSERT_EQ(frame.size(), sizeof(int) * 2);
+
+        int message[2];
+        std::memcpy(message, frame.data(), sizeof(message));
+        ASSERT_GE(message[0], 0);
+        ASSERT_LT(message[0], kSenders);
+        EXPECT_EQ(message[1], next[message[0]]++);
+    }
+
+    for (auto &sender : senders) {
+        sender.join();
+    }
+    for (int id = 0; id < kSenders; ++id) {
+        EXPECT_EQ(next[id], kMessagesPerSender);
+    }
+
+    // Disconnected senders are dropped once nothing of theirs is left to read
+    std::span<const uint8_t> frame;
+    EXPECT_FALSE(receiver.ReadFrame(frame, 50));
+    EXPECT_EQ(receiver.GetClientCount(), 0u);
+}
+
+TEST(IPCConnectionTest, ServesManySendersThroughIoUring) {
+    if (!IoUring::IsSupported()) {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+
+    // Few, small receive buffers: frames straddle buffers and the multishot
+    // receives run out of them and get re-armed
+    IPCReceiver receiver("test_uring_senders_socket",
+                         IPCReceiver::Config{.io_backend = IoBackend::IO_URING, .receive_buffers = 4, .receive_buffer_size = 256});
+    ASSERT_TRUE(receiver.Initialize());
+    EXPECT_EQ(receiver.GetIoBackend(), IoBackend::IO_URING);
+
+    constexpr int kSenders = 4;
+    constexpr int kMessagesPerSender = 500;
+    constexpr size_t kMessageInts = 100; // 400 bytes, larger than a receive buffer
+    std::vector<std::thread> senders;
+    for (int id = 0; id < kSenders; ++id) {
+        senders.emplace_back([&receiver, id]() {
+            IPCSender sender;
+            ASSERT_TRUE(sender.Connect(receiver.GetSocketPath()));
+            std::vector<int> message(kMessageInts, id);
+            for (int i = 0; i < kMessagesPerSender; ++i) {
+                message[1] = i;
+                ASSERT_TRUE(sender.SendTimestampedData(message.data(), message.size() * sizeof(int), i + 1));
+            }
+        });
+    }
+
+    std::vector<int> next(kSenders, 0);
+    for (int received = 0; received < kSenders * kMessagesPerSender; ++received) {
+        std::span<const uint8_t> frame;
+        ASSERT_TRUE(receiver.ReadFrame(frame, 5000));
+        ASSERT_EQ(frame.size(), sizeof(int) * kMessageInts);
+
+        std::vector<int> message(kMessageInts);
+        std::memcpy(message.data(), frame.data(), frame.size());
+        ASSERT_GE(message[0], 0);
+        ASSERT_LT(message[0], kSenders);
+        EXPECT_EQ(message[1], next[message[0]]++);
+        EXPECT_EQ(message.back(), message[0]);
+        EXPECT_EQ(receiver.GetLastFrameTimestamps().origin_ns, static_cast<uint64_t>(message[1] + 1));
+    }
+
+    for (auto &sender : senders) {
+        sender.join();
+    }
+
+    std::span<const uint8_t> frame;
+    EXPECT_FALSE(receiver.ReadFrame(frame, 50));
+    EXPECT_EQ(receiver.GetClientCount(), 0u);
+
+    // Still serving after every connection ended
+    IPCSender sender;
+    ASSERT_TRUE(sender.Connect(receiver.GetSocketPath()));
+    EXPECT_TRUE(sender.SendData("again", 5));
+    ASSERT_TRUE(receiver.ReadFrame(frame, 5000));
+    EXPECT_EQ(std::string(frame.begin(), frame.end()), "again");
+}
+
+TEST(IPCConnectionTest, DropsSenderClaimingOversizedFrame) {
+    for (IoBackend backend : {IoBackend::POSIX, IoBackend::IO_URING}) {
+        if (backend == IoBackend::IO_URING && !IoUring::IsSupported()) {
+            continue;
+        }
+
+        IPCReceiver receiver("test_oversized_frame_socket", IPCReceiver::Config{.io_backend = backend, .max_frame_size = 64});
+        ASSERT_TRUE(receiver.Initialize());
+
+        // Frames ahead of the oversized one are still delivered; nothing is
+        // buffered for it and the sender is cut off
+        IPCSender sender;
+        ASSERT_TRUE(sender.Connect(receiver.GetSocketPath()));
+        ASSERT_TRUE(sender.SendData("ok", 2));
+        std::string oversized(1000, 'x');
+        ASSERT_TRUE(sender.SendData(oversized.data(), oversized.size()));
+
+        std::span<const uint8_t> frame;
+        ASSERT_TRUE(receiver.ReadFrame(frame, 5000));
+        EXPECT_EQ(std::string(frame.begin(), frame.end()), "ok");
+        EXPECT_FALSE(receiver.ReadFrame(frame, 100));
+        EXPECT_EQ(receiver.GetClientCount(), 0u);
+
+        IPCSender other;
+        ASSERT_TRUE(other.Connect(receiver.GetSocketPath()));
+        ASSERT_TRUE(other.SendData("next", 4));
+        ASSERT_TRUE(receiver.ReadFrame(frame, 5000));
+        EXPECT_EQ(std::string(frame.begin(), frame.end()), "next");
+    }
+}
+
+TEST(IPCConnectionTest, BatchedSendsShareWrites) {
+    IPCReceiver receiver("test_batch_socket");
+    ASSERT_TRUE(receiver.Initialize());
+
+    IPCSender sender;
+    ASSERT_TRUE(sender.Connect(receiver.GetSocketPath()));
+    sender.EnableBatching(IPCSender::BatchConfig{.flush_bytes = 1024});
+
+    // 12-byte frames: nothing written until 1024 bytes are buffered
+    for (uint64_t i = 0; i < 85; ++i) {
+        ASSERT_TRUE(sender.SendData(&i, sizeof(i)));
+    }
+    EXPECT_EQ(sender.GetWriteCount(), 0u);
+    EXPECT_EQ(sender.GetBufferedBytes(), 85u * 12);
+
+    for (uint64_t i = 85; i < 100; ++i) {
+        ASSERT_TRUE(sender.SendData(&i, sizeof(i)));
+    }
+    EXPECT_EQ(sender.GetWriteCount(), 1u);
+    EXPECT_TRUE(sender.Flush());
+    EXPECT_EQ(sender.GetWriteCount(), 2u);
+    EXPECT_FALSE(sender.HasPendingData());
+
+    for (uint64_t i = 0; i < 100; ++i) {
+        auto data = receiver.ReadData();
+        ASSERT_EQ(data.size(), sizeof(i));
+        uint64_t value;
+        std::memcpy(&value, data.data(), sizeof(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(IPCConnectionTest, BatchedSendsFlushByAge) {
+    IPCReceiver receiver("test_batch_age_socket");
+    ASSERT_TRUE(receiver.Initialize());
+
+    IPCSender sender;
+    ASSERT_TRUE(sender.Connect(receiver.GetSocketPath()));
+    sender.EnableBatching(IPCSender::BatchConfig{.flush_interval_us = 2000});
+
+    std::string message = "aged";
+    ASSERT_TRUE(sender.SendData(message.c_str(), message.size()));
+    EXPECT_TRUE(sender.FlushIfDue());
+    EXPECT_TRUE(sender.HasPendingData());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_TRUE(sender.FlushIfDue());
+    EXPECT_FALSE(sender.HasPendingData());
+    EXPECT_EQ(sender.GetWriteCount(), 1u);
+
+    auto data = receiver.ReadData();
+    EXPECT_EQ(std::string(data.begin(), data.end()), message);
+}
+
+TEST(IPCConnectionTest, PartialWritesKeepFraming) {
+    IPCReceiver receiver("test_partial_socket");
+    ASSERT_TRUE(receiver.Initialize());
+
+    IPCSender sender;
+    ASSERT_TRUE(sender.Connect(receiver.GetSocketPath()));
+    sender.EnableBatching(IPCSender::BatchConfig{.flush_bytes = 16 * 1024});
+
+    // Frames of odd sizes against an unread socket until it pushes back
+    std::vector<uint8_t> frame;
+    uint32_t sent = 0;
+    while (true) {
+        frame.assign(1000 + sent % 777, static_cast<uint8_t>(sent));
+        auto result = sender.TrySendData(frame.data(), frame.size());
+        ASSERT_NE(result, IPCSender::SendResult::FAILED);
+        if (result == IPCSender::SendResult::WOULD_BLOCK) {
+            break;
+        }
+        sent++;
+    }
+    EXPECT_TRUE(sender.HasPendingData());
+
+    std::thread reader([&receiver, sent]() {
+        for (uint32_t i = 0; i < sent; ++i) {
+            std::span<const uint8_t> data;
+            ASSERT_TRUE(receiver.ReadFrame(data, 5000));
+            ASSERT_EQ(data.size(), 1000 + i % 777) << "frame " << i;
+            EXPECT_EQ(data.front(), static_cast<uint8_t>(i));
+            EXPECT_EQ(data.back(), static_cast<uint8_t>(i));
+        }
+    });
+
+    EXPECT_TRUE(sender.Flush());
+    reader.join();
+}
+
 } // namespace IPC
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace IPC {
+
+// Set in a frame's length prefix when FrameTimestamps' origin_ns and send_ns
+// (two uint64_t) sit between the prefix and the payload. The rest of the
+// prefix is still the payload size, so untimestamped frames are unchanged.
+constexpr uint32_t kTimestampedFrameFlag = 0x80000000u;
+
+// Pipeline stamps in Telemetry::NowNanos() time; zero when not carried
+struct FrameTimestamps {
+    uint64_t origin_ns = 0;  // when the payload entered the pipeline, e.g. websocket receipt
+    uint64_t send_ns = 0;    // when the sender wrote the frame
+    uint64_t receive_ns = 0; // when ReadData finished reading it
+};
+
+} // namespace IPC
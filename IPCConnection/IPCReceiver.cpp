@@ -1,5 +1,7 @@
 #include "IPCReceiver.h"
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cstring>
 #include <iostream>
 #include <sys/socket.h>
@@ -8,14 +10,15 @@
 
 namespace IPC {
 
-IPCReceiver::IPCReceiver(const std::string &socket_path) : socket_path_(socket_path), server_socket_(-1), client_socket_(-1) {}
+IPCReceiver::IPCReceiver(const std::string &socket_path, const Config &config)
+    : socket_path_(socket_path), config_(config), server_socket_(-1) {}
 
 IPCReceiver::~IPCReceiver() { CleanupSocket(); }
 
 bool IPCReceiver::Initialize() {
     unlink(socket_path_.c_str());
 
-    server_socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    server_socket_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (server_socket_ < 0) {
         std::cerr << "Failed to create socket: " << strerror(errno) << std::endl;
         return false;
@@ -32,86 +35,289 @@ bool IPCReceiver::Initialize() {
         return false;
     }
 
-    if (listen(server_socket_, 1) < 0) {
+    if (listen(server_socket_, SOMAXCONN) < 0) {
         std::cerr << "Failed to listen on socket: " << strerror(errno) << std::endl;
         CleanupSocket();
         return false;
     }
 
+    if (ResolveIoBackend(config_.io_backend) == IoBackend::IO_URING && !SetupIoUring()) {
+        std::cerr << "Falling back to POSIX reads" << std::endl;
+        uring_.reset();
+    }
+
     std::cout << "IPC socket listening on: " << socket_path_ << std::endl;
     return true;
 }
 
-std::vector<uint8_t> IPCReceiver::ReadData() {
+bool IPCReceiver::SetupIoUring() {
+    uring_ = std::make_unique<IoUring>();
+    return uring_->Initialize(config_.ring_entries) && uring_->ProvideBuffers(config_.receive_buffers, config_.receive_buffer_size);
+}
+
+bool IPCReceiver::Attach(EventLoop &loop, FrameHandler handler) {
+    if (loop_) {
+        std::cerr << "IPC receiver is already being served" << std::endl;
+        return false;
+    }
+
+    handler_ = std::move(handler);
+    return Register(loop);
+}
+
+bool IPCReceiver::Register(EventLoop &loop) {
     if (server_socket_ == -1) {
         std::cerr << "Socket not initialized" << std::endl;
-        return {};
+        return false;
     }
 
-    if (client_socket_ == -1) {
-        if (!AcceptConnection()) {
-            return {};
-        }
+    if (!loop.Add(server_socket_, EPOLLIN, [this](uint32_t) { OnAcceptReady(); })) {
+        return false;
+    }
+    if (uring_ && !loop.Add(uring_->GetFd(), EPOLLIN, [this](uint32_t) { OnCompletions(); })) {
+        loop.Remove(server_socket_);
+        return false;
     }
+    loop_ = &loop;
+    return true;
+}
 
-    // Read data length first (4 bytes)
-    uint32_t data_length;
-    if (!ReadExact(&data_length, sizeof(data_length))) {
+std::vector<uint8_t> IPCReceiver::ReadData() {
+    std::span<const uint8_t> frame;
+    if (!ReadFrame(frame)) {
         return {};
     }
+    return std::vector<uint8_t>(frame.begin(), frame.end());
+}
 
-    // Read the actual data
-    std::vector<uint8_t> data(data_length);
-    if (!ReadExact(data.data(), data_length)) {
-        return {};
+bool IPCReceiver::ReadFrame(std::span<const uint8_t> &frame, int timeout_ms) {
+    retired_.reset();
+    if (!WaitForData(timeout_ms)) {
+        return false;
     }
+    return NextQueuedFrame(frame);
+}
 
-    return data;
+bool IPCReceiver::WaitForData(int timeout_ms) {
+    if (handler_) {
+        std::cerr << "Attached IPC receiver delivers frames to its handler" << std::endl;
+        return false;
+    }
+    if (!loop_) {
+        own_loop_ = std::make_unique<EventLoop>();
+        if (!Register(*own_loop_)) {
+            return false;
+        }
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (ready_.empty()) {
+        int wait_ms = -1;
+        if (timeout_ms >= 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining < 0) {
+                return false;
+            }
+            wait_ms = static_cast<int>(remaining);
+        }
+        loop_->Poll(wait_ms);
+    }
+    return true;
 }
 
-bool IPCReceiver::ReadExact(void *buffer, size_t size) {
-    size_t bytes_remaining = size;
-    uint8_t *buf_ptr = static_cast<uint8_t *>(buffer);
+bool IPCReceiver::NextQueuedFrame(std::span<const uint8_t> &frame) {
+    while (!ready_.empty()) {
+        Client *client = ready_.front();
+        ready_.pop_front();
 
-    while (bytes_remaining > 0) {
-        ssize_t bytes_read = recv(client_socket_, buf_ptr, bytes_remaining, 0);
-        if (bytes_read <= 0) {
-            if (bytes_read == 0) {
-                std::cout << "Client disconnected" << std::endl;
-            } else {
-                std::cerr << "Failed to read data: " << strerror(errno) << std::endl;
+        bool found = client->reader.NextFrame(frame, last_timestamps_);
+        if (client->reader.HasFrame()) {
+            ready_.push_back(client);
+        } else {
+            client->queued = false;
+            if (client->socket == -1) {
+                // Disconnected while it still had frames; keep the buffer
+                // alive for the view handed out
+                EraseClient(*client);
+            } else if (client->reader.HasOversizedFrame()) {
+                DropOversizedClient(*client);
             }
-            close(client_socket_);
-            client_socket_ = -1;
-            return false;
         }
 
-        bytes_remaining -= bytes_read;
-        buf_ptr += bytes_read;
+        if (found) {
+            return true;
+        }
     }
+    return false;
+}
 
-    return true;
+void IPCReceiver::OnAcceptReady() {
+    // io_uring waits for data itself; a non-blocking socket would make its
+    // receives fail with EAGAIN instead
+    int flags = uring_ ? SOCK_CLOEXEC : SOCK_NONBLOCK | SOCK_CLOEXEC;
+    while (true) {
+        int socket = accept4(server_socket_, nullptr, nullptr, flags);
+        if (socket < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "Failed to accept connection: " << strerror(errno) << std::endl;
+            }
+            break;
+        }
+
+        auto client = std::make_unique<Client>(config_.max_frame_size);
+        client->socket = socket;
+        Client *added = client.get();
+        bool served = uring_ ? ArmReceive(*added) : loop_->Add(socket, EPOLLIN, [this, added](uint32_t) { OnClientReady(*added); });
+        if (!served) {
+            close(socket);
+            continue;
+        }
+        clients_.push_back(std::move(client));
+        std::cout << "Client connected to IPC socket" << std::endl;
+    }
+
+    if (uring_) {
+        uring_->Submit();
+    }
+}
+
+void IPCReceiver::OnClientReady(Client &client) {
+    FrameReader::ReadResult result = client.reader.ReadFrom(client.socket);
+
+    if (result == FrameReader::ReadResult::DATA) {
+        DeliverFrames(client);
+        if (!client.queued && client.reader.HasOversizedFrame()) {
+            DropOversizedClient(client);
+        }
+    } else if (result != FrameReader::ReadResult::WOULD_BLOCK) {
+        DropClient(client, result == FrameReader::ReadResult::FAILED, errno);
+    }
+}
+
+void IPCReceiver::DeliverFrames(Client &client) {
+    if (handler_) {
+        std::span<const uint8_t> frame;
+        while (client.reader.NextFrame(frame, last_timestamps_)) {
+            handler_(frame, last_timestamps_);
+        }
+    } else if (!client.queued && client.reader.HasFrame()) {
+        client.queued = true;
+        ready_.push_back(&client);
+    }
 }
 
-bool IPCReceiver::AcceptConnection() {
-    client_socket_ = accept(server_socket_, nullptr, nullptr);
-    if (client_socket_ < 0) {
-        std::cerr << "Failed to accept connection: " << strerror(errno) << std::endl;
+void IPCReceiver::DropClient(Client &client, bool failed, int error) {
+    if (failed) {
+        std::cerr << "Failed to read data: " << strerror(error) << std::endl;
+    } else {
+        std::cout << "Client disconnected" << std::endl;
+    }
+    CloseClient(client);
+    if (!client.queued) {
+        EraseClient(client);
+    }
+}
+
+void IPCReceiver::DropOversizedClient(Client &client) {
+    if (uring_) {
+        // Ends the multishot receive, whose last completion drops the client
+        shutdown(client.socket, SHUT_RDWR);
+    } else {
+        DropClient(client, true, EMSGSIZE);
+    }
+}
+
+bool IPCReceiver::ArmReceive(Client &client) {
+    io_uring_sqe *sqe = uring_->GetSqe();
+    if (!sqe) {
         return false;
     }
-    std::cout << "Client connected to IPC socket" << std::endl;
+    IoUring::PrepRecvMultishot(sqe, client.socket, reinterpret_cast<uint64_t>(&client));
     return true;
 }
 
+void IPCReceiver::OnCompletions() {
+    uring_->ForEachCompletion([this](const io_uring_cqe &cqe) {
+        OnReceiveCompletion(*reinterpret_cast<Client *>(cqe.user_data), cqe.res, cqe.flags);
+    });
+    // Returns the used buffers and re-arms the receives that ended, all at once
+    uring_->Submit();
+}
+
+void IPCReceiver::OnReceiveCompletion(Client &client, int result, uint32_t flags) {
+    if (result > 0 && (flags & IORING_CQE_F_BUFFER)) {
+        uint16_t id = flags >> IORING_CQE_BUFFER_SHIFT;
+        client.reader.Append(uring_->GetBuffer(id), result);
+        uring_->RecycleBuffer(id);
+        DeliverFrames(client);
+    }
+    bool oversized = !client.queued && client.reader.HasOversizedFrame();
+    if (flags & IORING_CQE_F_MORE) {
+        if (oversized) {
+            DropOversizedClient(client);
+        }
+        return;
+    }
+
+    // The multishot receive ended: because the buffers ran out or the kernel
+    // stopped it, which just needs a new one, or for good
+    if (oversized) {
+        result = -EMSGSIZE;
+    } else if (result > 0 || result == -ENOBUFS) {
+        if (ArmReceive(client)) {
+            return;
+        }
+        result = -EBUSY;
+    }
+    DropClient(client, result < 0, -result);
+}
+
+void IPCReceiver::CloseClient(Client &client) {
+    // io_uring clients are not in the loop, and their receive ends with the
+    // socket or with the ring
+    if (!uring_) {
+        loop_->Remove(client.socket);
+    }
+    close(client.socket);
+    client.socket = -1;
+}
+
+void IPCReceiver::EraseClient(Client &client) {
+    auto it = std::find_if(clients_.begin(), clients_.end(), [&client](const auto &entry) { return entry.get() == &client; });
+    if (it == clients_.end()) {
+        return;
+    }
+
+    retired_ = std::move(*it);
+    *it = std::move(clients_.back());
+    clients_.pop_back();
+}
+
 void IPCReceiver::CleanupSocket() {
-    if (client_socket_ != -1) {
-        close(client_socket_);
-        client_socket_ = -1;
+    for (auto &client : clients_) {
+        if (client->socket != -1) {
+            CloseClient(*client);
+        }
     }
+    clients_.clear();
+    ready_.clear();
+
+    // Cancels the receives still armed, which keep their sockets open
+    if (uring_) {
+        if (loop_) {
+            loop_->Remove(uring_->GetFd());
+        }
+        uring_.reset();
+    }
+
     if (server_socket_ != -1) {
+        if (loop_) {
+            loop_->Remove(server_socket_);
+        }
         close(server_socket_);
         server_socket_ = -1;
     }
+    loop_ = nullptr;
     unlink(socket_path_.c_str());
 }
 
@@ -1,32 +1,117 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
+#include "EventLoop.h"
+#include "FrameReader.h"
+#include "IPCFrame.h"
+#include "IoUring.h"
+
 namespace IPC {
 
+// Listens on a Unix socket and serves any number of senders at once. Each
+// connection reads whole chunks into its own FrameReader, so a burst of
+// frames costs one recv and no allocation.
+//
+// With IoBackend::IO_URING the connections are read by one multishot receive
+// each, into a shared pool of kernel-selected buffers: the kernel keeps
+// receiving without being asked again, completions are picked up from the
+// ring's shared memory (the loop only waits on its fd), and buffers go back
+// with the next batch of submissions, so however many connections are busy,
+// reading them costs one io_uring_enter per wakeup instead of a recv each.
 class IPCReceiver {
   public:
-    IPCReceiver(const std::string &socket_path);
+    using FrameHandler = std::function<void(std::span<const uint8_t> frame, const FrameTimestamps &timestamps)>;
+
+    struct Config {
+        IoBackend io_backend = IoBackend::POSIX; // IO_URING falls back to POSIX where unavailable
+        unsigned ring_entries = 256;
+        uint16_t receive_buffers = 64; // io_uring receive buffer pool, shared by all connections
+        uint32_t receive_buffer_size = FrameReader::kDefaultChunkSize;
+        uint32_t max_frame_size = FrameReader::kDefaultMaxFrameSize; // a sender whose length prefix claims more is dropped
+    };
+
+    IPCReceiver(const std::string &socket_path) : IPCReceiver(socket_path, Config{}) {}
+    IPCReceiver(const std::string &socket_path, const Config &config);
     ~IPCReceiver();
 
     bool Initialize();
 
+    // Blocks until a frame from any sender is available and returns a copy
     std::vector<uint8_t> ReadData();
 
+    // Waits up to timeout_ms (-1 for no limit) for the next frame from any
+    // sender and views it in place; the view is valid until the next read on
+    // this receiver. Senders with buffered frames take turns frame by frame.
+    bool ReadFrame(std::span<const uint8_t> &frame, int timeout_ms = -1);
+
+    // Waits up to timeout_ms (-1 for no limit) until ReadFrame has a frame
+    bool WaitForData(int timeout_ms);
+
+    // Stamps of the frame last returned by ReadData/ReadFrame. receive_ns is
+    // always set (when its chunk was read); origin_ns and send_ns only for
+    // frames sent with SendTimestampedData.
+    const FrameTimestamps &GetLastFrameTimestamps() const { return last_timestamps_; }
+
+    // Event-driven use instead of ReadData/ReadFrame: serves the sockets
+    // from loop and passes every complete frame to handler as its chunk
+    // arrives. The view is valid for the duration of the call. Call once,
+    // after Initialize(); loop must outlive the receiver.
+    bool Attach(EventLoop &loop, FrameHandler handler);
+
     bool IsInitialized() const { return server_socket_ != -1; }
+    size_t GetClientCount() const { return clients_.size(); }
+
+    // Backend in use once initialized
+    IoBackend GetIoBackend() const { return uring_ ? IoBackend::IO_URING : IoBackend::POSIX; }
 
     const std::string &GetSocketPath() const { return socket_path_; }
 
   private:
+    struct Client {
+        explicit Client(size_t max_frame_size) : reader(FrameReader::kDefaultChunkSize, max_frame_size) {}
+
+        int socket = -1;
+        FrameReader reader;
+        bool queued = false; // in ready_
+    };
+
+    bool Register(EventLoop &loop);
+    void OnAcceptReady();
+    void OnClientReady(Client &client);
+    void DeliverFrames(Client &client);
+    void DropClient(Client &client, bool failed, int error);
+    void DropOversizedClient(Client &client); // once the frames before the oversized one are delivered
+
+    // io_uring backend
+    bool SetupIoUring();
+    bool ArmReceive(Client &client);
+    void OnCompletions();
+    void OnReceiveCompletion(Client &client, int result, uint32_t flags);
+    void CloseClient(Client &client);
+    void EraseClient(Client &client);
+    bool NextQueuedFrame(std::span<const uint8_t> &frame);
     void CleanupSocket();
-    bool AcceptConnection();
-    bool ReadExact(void *buffer, size_t size);
 
     std::string socket_path_;
+    Config config_;
     int server_socket_;
-    int client_socket_;
+    std::unique_ptr<IoUring> uring_;
+
+    EventLoop *loop_ = nullptr;
+    std::unique_ptr<EventLoop> own_loop_; // for ReadData/ReadFrame
+    FrameHandler handler_;
+
+    std::vector<std::unique_ptr<Client>> clients_;
+    std::deque<Client *> ready_; // clients with complete frames, for ReadFrame
+    std::unique_ptr<Client> retired_; // closed client whose last frame may still be viewed
+    FrameTimestamps last_timestamps_;
 };
 
 } // namespace IPC
@@ -1,13 +1,29 @@
 #include "IPCSender.h"
+#include "Telemetry/Clock.h"
 #include <cerrno>
 #include <cstring>
 #include <iostream>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
 
 namespace IPC {
 
+namespace {
+
+// The top bit of the length prefix marks timestamped frames, so a payload
+// must stay below it
+bool fits_in_frame(size_t size) {
+    if (size >= kTimestampedFrameFlag) {
+        std::cerr << "Message too large for an IPC frame: " << size << " bytes" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
 IPCSender::IPCSender() : client_socket_(-1) {}
 
 IPCSender::~IPCSender() { Disconnect(); }
@@ -29,9 +45,10 @@ bool IPCSender::Connect(const std::string &socket_path) {
     strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
 
     if (connect(client_socket_, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
-        std::cerr << "Failed to connect to server at " << socket_path << ": " << strerror(errno) << std::endl;
+        int error = errno;
         close(client_socket_);
         client_socket_ = -1;
+        errno = error;
         return false;
     }
 
@@ -41,28 +58,188 @@ bool IPCSender::Connect(const std::string &socket_path) {
 }
 
 bool IPCSender::SendData(const void *data, size_t size) {
-    if (client_socket_ == -1) {
-        std::cerr << "Not connected to any socket" << std::endl;
+    if (!fits_in_frame(size)) {
         return false;
     }
+    uint32_t prefix = static_cast<uint32_t>(size);
+    struct iovec iov[2] = {{&prefix, sizeof(prefix)}, {const_cast<void *>(data), size}};
+    return SendFrame(iov, 2, true) == SendResult::SENT;
+}
 
-    // Send size first (4 bytes)
-    uint32_t data_size = static_cast<uint32_t>(size);
-    if (send(client_socket_, &data_size, sizeof(data_size), 0) < 0) {
-        std::cerr << "Failed to send data size: " << strerror(errno) << std::endl;
+bool IPCSender::SendTimestampedData(const void *data, size_t size, uint64_t origin_ns) {
+    if (!fits_in_frame(size)) {
         return false;
     }
+    uint32_t prefix = static_cast<uint32_t>(size) | kTimestampedFrameFlag;
+    uint64_t timestamps[2] = {origin_ns, Telemetry::NowNanos()};
+    struct iovec iov[3] = {{&prefix, sizeof(prefix)}, {timestamps, sizeof(timestamps)}, {const_cast<void *>(data), size}};
+    return SendFrame(iov, 3, true) == SendResult::SENT;
+}
+
+IPCSender::SendResult IPCSender::TrySendData(const void *data, size_t size) {
+    if (!fits_in_frame(size)) {
+        return SendResult::FAILED;
+    }
+    uint32_t prefix = static_cast<uint32_t>(size);
+    struct iovec iov[2] = {{&prefix, sizeof(prefix)}, {const_cast<void *>(data), size}};
+    return SendFrame(iov, 2, false);
+}
+
+void IPCSender::EnableBatching(const BatchConfig &config) {
+    batching_ = true;
+    batch_config_ = config;
+}
+
+bool IPCSender::Flush() { return !HasPendingData() || (client_socket_ != -1 && FlushPending(0) == SendResult::SENT); }
+
+IPCSender::SendResult IPCSender::TryFlush() {
+    if (!HasPendingData()) {
+        return SendResult::SENT;
+    }
+    return client_socket_ == -1 ? SendResult::FAILED : FlushPending(MSG_DONTWAIT);
+}
+
+bool IPCSender::FlushIfDue() { return !IsBatchDue() || Flush(); }
+
+bool IPCSender::IsBatchDue() const {
+    return batch_config_.flush_interval_us > 0 && HasPendingData() &&
+           Telemetry::NowNanos() - batch_started_ns_ >= batch_config_.flush_interval_us * 1000;
+}
+
+IPCSender::SendResult IPCSender::SendFrame(struct iovec *iov, size_t count, bool blocking) {
+    if (client_socket_ == -1) {
+        std::cerr << "Not connected to any socket" << std::endl;
+        return SendResult::FAILED;
+    }
+
+    int flags = blocking ? 0 : MSG_DONTWAIT;
 
-    // Send the actual data
-    if (send(client_socket_, data, size, 0) < 0) {
-        std::cerr << "Failed to send data: " << strerror(errno) << std::endl;
+    if (batching_) {
+        // Once the socket has refused the batch, a non-blocking send is only
+        // taken after the backlog is written, as without batching
+        if (!blocking && write_blocked_) {
+            SendResult result = FlushPending(flags);
+            if (result != SendResult::SENT) {
+                return result;
+            }
+        }
+
+        AppendPending(iov, count, 0);
+        if (GetBufferedBytes() >= batch_config_.flush_bytes || IsBatchDue()) {
+            if (FlushPending(flags) == SendResult::FAILED) {
+                return SendResult::FAILED;
+            }
+        }
+        return SendResult::SENT;
+    }
+
+    if (HasPendingData()) {
+        SendResult result = FlushPending(flags);
+        if (result != SendResult::SENT) {
+            return result;
+        }
+    }
+
+    SendResult result = WriteVector(iov, count, flags);
+    if (result == SendResult::SENT && blocking && HasPendingData()) {
+        return FlushPending(0);
+    }
+    return result;
+}
+
+IPCSender::SendResult IPCSender::WriteVector(struct iovec *iov, size_t count, int flags) {
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+
+    ssize_t sent;
+    do {
+        sent = sendmsg(client_socket_, &msg, flags | MSG_NOSIGNAL);
+        write_count_++;
+    } while (sent < 0 && errno == EINTR);
+
+    if (sent < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return SendResult::WOULD_BLOCK;
+        }
+        return FailSend();
+    }
+
+    // Part of the frame is on the wire, so the rest must follow before
+    // anything else
+    AppendPending(iov, count, static_cast<size_t>(sent));
+    return SendResult::SENT;
+}
+
+void IPCSender::AppendPending(const struct iovec *iov, size_t count, size_t skip) {
+    if (!HasPendingData()) {
+        pending_.clear();
+        pending_offset_ = 0;
+        batch_started_ns_ = batch_config_.flush_interval_us > 0 ? Telemetry::NowNanos() : 0;
+    } else if (pending_offset_ * 2 >= pending_.size()) {
+        pending_.erase(pending_.begin(), pending_.begin() + pending_offset_);
+        pending_offset_ = 0;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (skip >= iov[i].iov_len) {
+            skip -= iov[i].iov_len;
+            continue;
+        }
+        const uint8_t *bytes = static_cast<const uint8_t *>(iov[i].iov_base);
+        pending_.insert(pending_.end(), bytes + skip, bytes + iov[i].iov_len);
+        skip = 0;
+    }
+}
+
+IPCSender::SendResult IPCSender::FlushPending(int flags) {
+    while (HasPendingData()) {
+        ssize_t sent = send(client_socket_, pending_.data() + pending_offset_, pending_.size() - pending_offset_, flags | MSG_NOSIGNAL);
+        write_count_++;
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                write_blocked_ = true;
+                return SendResult::WOULD_BLOCK;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            return FailSend();
+        }
+        pending_offset_ += static_cast<size_t>(sent);
+    }
+
+    pending_.clear();
+    pending_offset_ = 0;
+    write_blocked_ = false;
+    return SendResult::SENT;
+}
+
+IPCSender::SendResult IPCSender::FailSend() {
+    int error = errno;
+    std::cerr << "Failed to send data: " << strerror(error) << std::endl;
+    // The receiver is gone: nothing more can be sent on this socket, so drop
+    // it and let the caller see IsConnected() false and reconnect
+    if (error == EPIPE || error == ECONNRESET || error == ENOTCONN) {
+        Disconnect();
+    }
+    return SendResult::FAILED;
+}
+
+bool IPCSender::WaitWritable(int timeout_ms) const {
+    if (client_socket_ == -1) {
         return false;
     }
 
-    return true;
+    struct pollfd fd = {client_socket_, POLLOUT, 0};
+    return poll(&fd, 1, timeout_ms) > 0 && (fd.revents & POLLOUT);
 }
 
 void IPCSender::Disconnect() {
+    pending_.clear();
+    pending_offset_ = 0;
+    write_blocked_ = false;
     if (client_socket_ != -1) {
         close(client_socket_);
         client_socket_ = -1;
@@ -2,8 +2,11 @@
 
 #include <cstdint>
 #include <string>
+#include <sys/uio.h>
 #include <vector>
 
+#include "IPCFrame.h"
+
 namespace IPC {
 
 class IPCSender {
@@ -11,17 +14,78 @@ class IPCSender {
     IPCSender();
     ~IPCSender();
 
+    // Quiet when nobody listens at socket_path (errno says why), so a caller
+    // retrying in a loop decides how often that is worth logging
     bool Connect(const std::string &socket_path);
 
+    // Writes the length prefix and payload with one writev, finishing any
+    // partial write before returning
     bool SendData(const void *data, size_t size);
 
+    // SendData with FrameTimestamps: origin_ns as given (0 if unknown) and
+    // send_ns taken now, for per-stage latency tracking downstream
+    bool SendTimestampedData(const void *data, size_t size, uint64_t origin_ns);
+
+    enum class SendResult { SENT, WOULD_BLOCK, FAILED };
+
+    // Non-blocking SendData. WOULD_BLOCK means the socket buffer is full and
+    // the message was not taken. A message the socket only partly accepted
+    // counts as SENT; its tail is kept and written before any later message.
+    SendResult TrySendData(const void *data, size_t size);
+
+    // Waits up to timeout_ms (-1 for no limit) for the socket to accept data
+    bool WaitWritable(int timeout_ms) const;
+
+    struct BatchConfig {
+        size_t flush_bytes = 64 * 1024; // flush once this much is buffered
+        uint64_t flush_interval_us = 0; // and once the oldest buffered frame is this old; 0 for no age limit
+    };
+
+    // Coalesces frames: sends append to a buffer that goes out in as few
+    // writes as the socket allows on Flush() or when the policy says so. The
+    // age limit is checked on every send and by FlushIfDue(), for idle
+    // callers. TrySendData keeps its contract: once the socket refuses a
+    // write it returns WOULD_BLOCK until the buffered frames are out.
+    void EnableBatching() { EnableBatching(BatchConfig{}); }
+    void EnableBatching(const BatchConfig &config);
+
+    // Blocking; true once everything buffered is written
+    bool Flush();
+    SendResult TryFlush();
+    bool FlushIfDue();
+
+    bool HasPendingData() const { return pending_offset_ < pending_.size(); }
+    size_t GetBufferedBytes() const { return pending_.size() - pending_offset_; }
+
+    // System calls made to write frames, for checking how well sends batch
+    uint64_t GetWriteCount() const { return write_count_; }
+
     void Disconnect();
 
+    // Also false once a send found the receiver gone (EPIPE, ECONNRESET):
+    // the socket is closed then and Connect() starts over
     bool IsConnected() const { return client_socket_ != -1; }
 
   private:
+    SendResult SendFrame(struct iovec *iov, size_t count, bool blocking);
+    SendResult WriteVector(struct iovec *iov, size_t count, int flags);
+    void AppendPending(const struct iovec *iov, size_t count, size_t skip);
+    SendResult FlushPending(int flags);
+    SendResult FailSend(); // after a send failed with errno
+    bool IsBatchDue() const;
+
     int client_socket_;
     std::string connected_socket_path_;
+
+    // Bytes not yet written: the batch, or the tail of a partly written frame
+    std::vector<uint8_t> pending_;
+    size_t pending_offset_ = 0;
+
+    bool batching_ = false;
+    BatchConfig batch_config_;
+    uint64_t batch_started_ns_ = 0;
+    bool write_blocked_ = false; // the last flush stopped on a full socket
+    uint64_t write_count_ = 0;
 };
 
 } // namespace IPC
@@ -0,0 +1,286 @@
+#include "IoUring.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace IPC {
+
+namespace {
+
+int io_uring_setup(unsigned entries, io_uring_params *params) { return static_cast<int>(syscall(__NR_io_uring_setup, entries, params)); }
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int fd, unsigned opcode, const void *arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T> T *ring_field(void *mapping, uint32_t offset) { return reinterpret_cast<T *>(static_cast<uint8_t *>(mapping) + offset); }
+
+// Arms a multishot receive on a socketpair and feeds it a byte: kernels
+// without it fail the entry with EINVAL, and one that stays armed says
+// IORING_CQE_F_MORE
+bool probe_multishot_recv() {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) < 0) {
+        return false;
+    }
+
+    bool supported = false;
+    IoUring ring;
+    uint8_t byte = 0;
+    if (ring.Initialize(2) && ring.ProvideBuffers(1, 64) && write(fds[1], &byte, 1) == 1) {
+        io_uring_sqe *sqe = ring.GetSqe();
+        if (sqe) {
+            IoUring::PrepRecvMultishot(sqe, fds[0], 1);
+            if (ring.Submit(1) >= 0) {
+                ring.ForEachCompletion([&supported](const io_uring_cqe &cqe) { supported = cqe.res == 1 && (cqe.flags & IORING_CQE_F_MORE); });
+            }
+        }
+    }
+    close(fds[0]);
+    close(fds[1]);
+    return supported;
+}
+
+} // namespace
+
+IoBackend ResolveIoBackend(IoBackend backend) {
+    if (backend == IoBackend::IO_URING && !IoUring::IsSupported()) {
+        std::cerr << "io_uring is not available, using POSIX I/O" << std::endl;
+        return IoBackend::POSIX;
+    }
+    return backend;
+}
+
+bool IoUring::IsSupported() {
+    static const bool supported = []() {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        int fd = io_uring_setup(2, &params);
+        if (fd < 0) {
+            return false;
+        }
+        close(fd);
+        // One mapping for both rings, poll-driven receives and silent buffer returns
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_FAST_POLL) ||
+            !(params.features & IORING_FEAT_CQE_SKIP)) {
+            return false;
+        }
+        // Those came in 5.17; multishot receive only in 6.0
+        return probe_multishot_recv();
+    }();
+    return supported;
+}
+
+IoUring::~IoUring() { Close(); }
+
+bool IoUring::Initialize(unsigned entries) {
+    Close();
+
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    // Completions may outnumber entries (multishot), so give them room
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = entries * 4;
+
+    ring_fd_ = io_uring_setup(entries, &params);
+    if (ring_fd_ < 0) {
+        std::cerr << "Failed to set up io_uring: " << strerror(errno) << std::endl;
+        ring_fd_ = -1;
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        std::cerr << "io_uring without single-mmap rings is not supported" << std::endl;
+        Close();
+        return false;
+    }
+
+    ring_mapping_size_ = std::max<size_t>(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+                                          params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring_mapping_ = mmap(nullptr, ring_mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (ring_mapping_ == MAP_FAILED) {
+        std::cerr << "Failed to map io_uring rings: " << strerror(errno) << std::endl;
+        ring_mapping_ = nullptr;
+        Close();
+        return false;
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        std::cerr << "Failed to map io_uring entries: " << strerror(errno) << std::endl;
+        Close();
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    sq_head_ = ring_field<std::atomic<uint32_t>>(ring_mapping_, params.sq_off.head);
+    sq_tail_ = ring_field<std::atomic<uint32_t>>(ring_mapping_, params.sq_off.tail);
+    sq_array_ = ring_field<uint32_t>(ring_mapping_, params.sq_off.array);
+    sq_mask_ = *ring_field<uint32_t>(ring_mapping_, params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_local_tail_ = sq_tail_->load(std::memory_order_relaxed);
+
+    cq_head_ = ring_field<std::atomic<uint32_t>>(ring_mapping_, params.cq_off.head);
+    cq_tail_ = ring_field<std::atomic<uint32_t>>(ring_mapping_, params.cq_off.tail);
+    cqes_ = ring_field<io_uring_cqe>(ring_mapping_, params.cq_off.cqes);
+    cq_mask_ = *ring_field<uint32_t>(ring_mapping_, params.cq_off.ring_mask);
+    return true;
+}
+
+void IoUring::Close() {
+    if (ring_fd_ != -1) {
+        // Cancel what is still in flight and wait for it, so no receive can
+        // land in the buffers after they are unmapped
+        io_uring_sync_cancel_reg cancel;
+        memset(&cancel, 0, sizeof(cancel));
+        cancel.fd = -1;
+        cancel.flags = IORING_ASYNC_CANCEL_ANY;
+        cancel.timeout.tv_sec = -1;
+        cancel.timeout.tv_nsec = -1;
+        io_uring_register(ring_fd_, IORING_REGISTER_SYNC_CANCEL, &cancel, 1);
+        close(ring_fd_);
+        ring_fd_ = -1;
+    }
+    if (buffers_) {
+        munmap(buffers_, buffers_size_);
+        buffers_ = nullptr;
+    }
+    if (sqes_) {
+        munmap(sqes_, sqes_size_);
+        sqes_ = nullptr;
+    }
+    if (ring_mapping_) {
+        munmap(ring_mapping_, ring_mapping_size_);
+        ring_mapping_ = nullptr;
+    }
+}
+
+io_uring_sqe *IoUring::GetSqe() {
+    if (GetQueuedCount() >= sq_entries_) {
+        Submit();
+        if (GetQueuedCount() >= sq_entries_) {
+            return nullptr;
+        }
+    }
+
+    uint32_t index = sq_local_tail_ & sq_mask_;
+    io_uring_sqe *sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    sq_local_tail_++;
+    return sqe;
+}
+
+int IoUring::Submit(unsigned min_complete) {
+    sq_tail_->store(sq_local_tail_, std::memory_order_release);
+    unsigned to_submit = GetQueuedCount();
+    if (to_submit == 0 && min_complete == 0) {
+        return 0;
+    }
+
+    while (true) {
+        int result = io_uring_enter(ring_fd_, to_submit, min_complete, min_complete > 0 ? IORING_ENTER_GETEVENTS : 0);
+        if (result >= 0) {
+            return result;
+        }
+        if (errno != EINTR) {
+            std::cerr << "io_uring_enter failed: " << strerror(errno) << std::endl;
+            return -errno;
+        }
+    }
+}
+
+bool IoUring::RegisterBuffers(const std::vector<iovec> &buffers) {
+    if (io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) < 0) {
+        std::cerr << "Failed to register io_uring buffers: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool IoUring::ProvideBuffers(uint16_t count, uint32_t size) {
+    buffers_size_ = size_t{count} * size;
+    void *mapping = mmap(nullptr, buffers_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to allocate io_uring receive buffers: " << strerror(errno) << std::endl;
+        return false;
+    }
+    buffers_ = static_cast<uint8_t *>(mapping);
+    buffer_size_ = size;
+
+    // All of them in one entry, and wait to see it through
+    io_uring_sqe *sqe = GetSqe();
+    if (!sqe) {
+        return false;
+    }
+    PrepProvideBuffers(sqe, buffers_, size, count, 0);
+    sqe->user_data = 0;
+    if (Submit(1) < 0) {
+        return false;
+    }
+
+    int result = -EIO;
+    ForEachCompletion([&result](const io_uring_cqe &cqe) { result = cqe.res; });
+    if (result < 0) {
+        std::cerr << "Failed to provide io_uring receive buffers: " << strerror(-result) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void IoUring::RecycleBuffer(uint16_t id) {
+    io_uring_sqe *sqe = GetSqe();
+    if (!sqe) {
+        std::cerr << "Failed to return io_uring receive buffer: submission queue full" << std::endl;
+        return;
+    }
+    PrepProvideBuffers(sqe, GetBuffer(id), buffer_size_, 1, id);
+    sqe->flags |= IOSQE_CQE_SKIP_SUCCESS;
+}
+
+void IoUring::PrepProvideBuffers(io_uring_sqe *sqe, const uint8_t *data, uint32_t size, uint16_t count, uint16_t first_id) {
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = count;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = size;
+    sqe->off = first_id;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = kInternalUserData;
+}
+
+void IoUring::OnInternalCompletion(const io_uring_cqe &cqe) {
+    if (cqe.res < 0) {
+        std::cerr << "Failed to return io_uring receive buffer: " << strerror(-cqe.res) << std::endl;
+    }
+}
+
+void IoUring::PrepRecvMultishot(io_uring_sqe *sqe, int fd, uint64_t user_data) {
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = user_data;
+}
+
+void IoUring::PrepWriteFixed(io_uring_sqe *sqe, int fd, const void *data, uint32_t size, uint64_t offset, uint16_t buffer_index,
+                             uint64_t user_data) {
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = size;
+    sqe->off = offset;
+    sqe->buf_index = buffer_index;
+    sqe->user_data = user_data;
+}
+
+} // namespace IPC
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#include <vector>
+
+namespace IPC {
+
+// How a component does its socket or file I/O: one system call per read or
+// write, or through an io_uring
+enum class IoBackend { POSIX, IO_URING };
+
+// backend, unless it is IO_URING and the kernel (or a seccomp policy) does
+// not allow io_uring, in which case POSIX
+IoBackend ResolveIoBackend(IoBackend backend);
+
+// Minimal io_uring over the raw system calls (no liburing): the submission
+// and completion rings, registered buffers for fixed reads and writes, and
+// one group of provided buffers for multishot receives. Entries are queued
+// with GetSqe() and go to the kernel together on the next Submit();
+// completions are read straight from the shared ring without any system
+// call. Needs Linux 6.0 or later (multishot receive). Not thread-safe.
+class IoUring {
+  public:
+    IoUring() = default;
+    ~IoUring();
+
+    IoUring(const IoUring &) = delete;
+    IoUring &operator=(const IoUring &) = delete;
+
+    static bool IsSupported();
+
+    bool Initialize(unsigned entries);
+    bool IsValid() const { return ring_fd_ != -1; }
+
+    // Becomes readable (EPOLLIN) while completions are waiting
+    int GetFd() const { return ring_fd_; }
+
+    // A zeroed entry to fill in; submits the queued ones first if the queue
+    // is full. nullptr if even that fails.
+    io_uring_sqe *GetSqe();
+
+    // Hands every queued entry to the kernel with one io_uring_enter, first
+    // waiting for min_complete completions; returns the entries submitted or
+    // -errno
+    int Submit(unsigned min_complete = 0);
+    unsigned GetQueuedCount() const { return sq_local_tail_ - sq_head_->load(std::memory_order_acquire); }
+
+    // Calls visit(const io_uring_cqe &) for every waiting completion of the
+    // caller's entries, then frees their slots
+    template <typename Visitor> void ForEachCompletion(Visitor &&visit);
+
+    // Buffers for IORING_OP_READ_FIXED / WRITE_FIXED, addressed by index
+    bool RegisterBuffers(const std::vector<iovec> &buffers);
+
+    // count buffers of size bytes each that the kernel picks from for
+    // receives with IOSQE_BUFFER_SELECT and group kBufferGroup. A completion
+    // names its buffer in the upper flag bits; hand it back with
+    // RecycleBuffer once done with the data, which queues an entry for the
+    // next Submit() (and posts no completion).
+    static constexpr uint16_t kBufferGroup = 0;
+    bool ProvideBuffers(uint16_t count, uint32_t size);
+    const uint8_t *GetBuffer(uint16_t id) const { return buffers_ + size_t{id} * buffer_size_; }
+    void RecycleBuffer(uint16_t id);
+
+    // Entry preparation
+    static void PrepRecvMultishot(io_uring_sqe *sqe, int fd, uint64_t user_data);
+    static void PrepWriteFixed(io_uring_sqe *sqe, int fd, const void *data, uint32_t size, uint64_t offset, uint16_t buffer_index,
+                               uint64_t user_data);
+
+  private:
+    // Tags this class's own entries, whose completions callers never see
+    static constexpr uint64_t kInternalUserData = ~uint64_t{0};
+
+    void Close();
+    static void PrepProvideBuffers(io_uring_sqe *sqe, const uint8_t *data, uint32_t size, uint16_t count, uint16_t first_id);
+    static void OnInternalCompletion(const io_uring_cqe &cqe);
+
+    int ring_fd_ = -1;
+
+    void *ring_mapping_ = nullptr;
+    size_t ring_mapping_size_ = 0;
+    io_uring_sqe *sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    // Submission ring: the kernel consumes up to *sq_tail_
+    std::atomic<uint32_t> *sq_head_ = nullptr;
+    std::atomic<uint32_t> *sq_tail_ = nullptr;
+    uint32_t *sq_array_ = nullptr;
+    uint32_t sq_mask_ = 0;
+    uint32_t sq_entries_ = 0;
+    uint32_t sq_local_tail_ = 0; // entries handed out by GetSqe
+
+    // Completion ring: the kernel produces up to *cq_tail_
+    std::atomic<uint32_t> *cq_head_ = nullptr;
+    std::atomic<uint32_t> *cq_tail_ = nullptr;
+    io_uring_cqe *cqes_ = nullptr;
+    uint32_t cq_mask_ = 0;
+
+    // Provided buffers
+    uint8_t *buffers_ = nullptr;
+    size_t buffers_size_ = 0;
+    uint32_t buffer_size_ = 0;
+};
+
+template <typename Visitor> void IoUring::ForEachCompletion(Visitor &&visit) {
+    uint32_t head = cq_head_->load(std::memory_order_relaxed);
+    uint32_t tail = cq_tail_->load(std::memory_order_acquire);
+    for (uint32_t i = head; i != tail; ++i) {
+        const io_uring_cqe &cqe = cqes_[i & cq_mask_];
+        if (cqe.user_data == kInternalUserData) {
+            OnInternalCompletion(cqe);
+        } else {
+            visit(cqe);
+        }
+    }
+    cq_head_->store(tail, std::memory_order_release);
+}
+
+} // namespace IPC
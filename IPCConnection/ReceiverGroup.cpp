@@ -0,0 +1,25 @@
+#include "ReceiverGroup.h"
+
+namespace IPC {
+
+ReceiverGroup::ReceiverGroup(EventLoop &loop, FrameHandler handler) : loop_(loop), handler_(std::move(handler)) {}
+
+bool ReceiverGroup::AddInput(const std::string &socket_path) {
+    auto receiver = std::make_unique<IPCReceiver>(socket_path, receiver_config_);
+    if (!receiver->Initialize() || !receiver->Attach(loop_, handler_)) {
+        return false;
+    }
+
+    receivers_.push_back(std::move(receiver));
+    return true;
+}
+
+size_t ReceiverGroup::GetConnectedCount() const {
+    size_t count = 0;
+    for (const auto &receiver : receivers_) {
+        count += receiver->GetClientCount();
+    }
+    return count;
+}
+
+} // namespace IPC
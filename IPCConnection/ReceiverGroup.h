@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EventLoop.h"
+#include "IPCReceiver.h"
+
+namespace IPC {
+
+// Serves several IPCReceivers (e.g. one per exchange or websocket shard) from
+// one EventLoop. Every input takes any number of senders, which may connect,
+// drop and reconnect at any time. Frames are handed to the handler on the
+// thread polling the loop, in order per sender.
+class ReceiverGroup {
+  public:
+    using FrameHandler = IPCReceiver::FrameHandler;
+
+    ReceiverGroup(EventLoop &loop, FrameHandler handler);
+
+    ReceiverGroup(const ReceiverGroup &) = delete;
+    ReceiverGroup &operator=(const ReceiverGroup &) = delete;
+
+    // Listens on socket_path; false if the socket could not be set up
+    bool AddInput(const std::string &socket_path);
+
+    // Receiver settings (e.g. the I/O backend) for inputs added from now on
+    void SetReceiverConfig(const IPCReceiver::Config &config) { receiver_config_ = config; }
+
+    size_t GetInputCount() const { return receivers_.size(); }
+    size_t GetConnectedCount() const;
+
+  private:
+    EventLoop &loop_;
+    FrameHandler handler_;
+    IPCReceiver::Config receiver_config_;
+    std::vector<std::unique_ptr<IPCReceiver>> receivers_;
+};
+
+} // namespace IPC
@@ -0,0 +1,89 @@
+#include "IPCSender.h"
+#include "ReceiverGroup.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace IPC {
+
+namespace {
+
+// Polls until pred holds or about two seconds have passed
+template <typename Pred> bool PollUntil(EventLoop &loop, Pred pred) {
+    for (int i = 0; i < 200 && !pred(); ++i) {
+        loop.Poll(10);
+    }
+    return pred();
+}
+
+bool SendString(IPCSender &sender, const std::string &message) { return sender.SendData(message.data(), message.size()); }
+
+} // namespace
+
+TEST(ReceiverGroupTest, ServesSeveralInputs) {
+    EventLoop loop;
+    std::vector<std::string> frames;
+    ReceiverGroup group(loop, [&frames](std::span<const uint8_t> frame, const FrameTimestamps &timestamps) {
+        EXPECT_NE(timestamps.receive_ns, 0u);
+        frames.emplace_back(frame.begin(), frame.end());
+    });
+
+    ASSERT_TRUE(group.AddInput("test_group_socket_a"));
+    ASSERT_TRUE(group.AddInput("test_group_socket_b"));
+    EXPECT_EQ(group.GetInputCount(), 2u);
+
+    IPCSender sender_a;
+    IPCSender sender_b;
+    ASSERT_TRUE(sender_a.Connect("test_group_socket_a"));
+    ASSERT_TRUE(sender_b.Connect("test_group_socket_b"));
+    EXPECT_TRUE(PollUntil(loop, [&]() { return group.GetConnectedCount() == 2; }));
+
+    EXPECT_TRUE(SendString(sender_a, "a1"));
+    EXPECT_TRUE(SendString(sender_b, "b1"));
+    EXPECT_TRUE(SendString(sender_a, "a2"));
+    EXPECT_TRUE(SendString(sender_b, "b2"));
+    ASSERT_TRUE(PollUntil(loop, [&]() { return frames.size() == 4; }));
+
+    // Interleaved across inputs, in order within each
+    std::vector<std::string> from_a;
+    std::vector<std::string> from_b;
+    for (const auto &frame : frames) {
+        (frame[0] == 'a' ? from_a : from_b).push_back(frame);
+    }
+    EXPECT_EQ(from_a, (std::vector<std::string>{"a1", "a2"}));
+    EXPECT_EQ(from_b, (std::vector<std::string>{"b1", "b2"}));
+}
+
+TEST(ReceiverGroupTest, ReacceptsAfterDisconnect) {
+    EventLoop loop;
+    std::vector<std::string> frames;
+    ReceiverGroup group(loop, [&frames](std::span<const uint8_t> frame, const FrameTimestamps &) { frames.emplace_back(frame.begin(), frame.end()); });
+    ASSERT_TRUE(group.AddInput("test_group_reconnect_socket"));
+
+    {
+        IPCSender sender;
+        ASSERT_TRUE(sender.Connect("test_group_reconnect_socket"));
+        EXPECT_TRUE(SendString(sender, "first"));
+        ASSERT_TRUE(PollUntil(loop, [&]() { return frames.size() == 1; }));
+    }
+
+    EXPECT_TRUE(PollUntil(loop, [&]() { return group.GetConnectedCount() == 0; }));
+
+    // Nothing is ready while the upstream is away: no spinning on a dead socket
+    EXPECT_EQ(loop.Poll(20), 0);
+
+    // It comes back, alongside a second sender on the same input
+    IPCSender sender;
+    IPCSender other;
+    ASSERT_TRUE(sender.Connect("test_group_reconnect_socket"));
+    ASSERT_TRUE(other.Connect("test_group_reconnect_socket"));
+    EXPECT_TRUE(SendString(sender, "second"));
+    EXPECT_TRUE(SendString(other, "other"));
+    ASSERT_TRUE(PollUntil(loop, [&]() { return frames.size() == 3; }));
+    EXPECT_EQ(std::count(frames.begin(), frames.end(), "second"), 1);
+    EXPECT_EQ(std::count(frames.begin(), frames.end(), "other"), 1);
+    EXPECT_EQ(group.GetConnectedCount(), 2u);
+}
+
+} // namespace IPC
@@ -0,0 +1,66 @@
+#include "SharedMemoryReceiver.h"
+#include "Telemetry/Clock.h"
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+namespace IPC {
+
+SharedMemoryReceiver::SharedMemoryReceiver(const std::string &ring_path, const Config &config) : ring_path_(ring_path), config_(config) {}
+
+SharedMemoryReceiver::~SharedMemoryReceiver() {
+    if (ring_.IsOpen()) {
+        ring_.Close();
+        unlink(ring_path_.c_str());
+    }
+}
+
+bool SharedMemoryReceiver::Initialize() {
+    if (!ring_.Create(ring_path_, config_.capacity, config_.futex_wakeup)) {
+        return false;
+    }
+    std::cout << "Shared memory ring ready at: " << ring_path_ << std::endl;
+    return true;
+}
+
+std::vector<uint8_t> SharedMemoryReceiver::ReadData() {
+    std::vector<uint8_t> data;
+    if (!ring_.IsOpen()) {
+        std::cerr << "Shared memory ring not initialized" << std::endl;
+        return data;
+    }
+
+    while (!TryReadData(data)) {
+        ring_.WaitForData(-1, config_.spin_count);
+    }
+    return data;
+}
+
+bool SharedMemoryReceiver::TryReadData(std::vector<uint8_t> &data) {
+    uint32_t flags;
+    const uint8_t *record;
+    size_t size;
+    if (!ring_.IsOpen() || !ring_.Peek(flags, record, size)) {
+        return false;
+    }
+
+    last_timestamps_ = FrameTimestamps{};
+    if (flags & kTimestampedFrameFlag) {
+        uint64_t timestamps[2];
+        memcpy(timestamps, record, sizeof(timestamps));
+        last_timestamps_.origin_ns = timestamps[0];
+        last_timestamps_.send_ns = timestamps[1];
+        record += sizeof(timestamps);
+        size -= sizeof(timestamps);
+    }
+
+    data.assign(record, record + size);
+    ring_.Consume();
+
+    last_timestamps_.receive_ns = Telemetry::NowNanos();
+    return true;
+}
+
+bool SharedMemoryReceiver::WaitForData(int timeout_ms) { return ring_.IsOpen() && ring_.WaitForData(timeout_ms, config_.spin_count); }
+
+} // namespace IPC
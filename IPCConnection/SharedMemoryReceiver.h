@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "IPCFrame.h"
+#include "SharedMemoryRing.h"
+
+namespace IPC {
+
+// IPCReceiver over a shared-memory SPSC ring instead of a socket. The ring is
+// created by Initialize() at ring_path (e.g. /dev/shm/market_data) and
+// removed on destruction; a SharedMemorySender connects to the same path.
+class SharedMemoryReceiver {
+  public:
+    struct Config {
+        size_t capacity = 1 << 20; // bytes, rounded up to a power of two
+        // Sleep on a futex once spin_count checks found nothing, instead of
+        // yielding; costs the sender a fence per message
+        bool futex_wakeup = true;
+        int spin_count = 256;
+    };
+
+    explicit SharedMemoryReceiver(const std::string &ring_path) : SharedMemoryReceiver(ring_path, Config{}) {}
+    SharedMemoryReceiver(const std::string &ring_path, const Config &config);
+    ~SharedMemoryReceiver();
+
+    bool Initialize();
+
+    // Blocks until a frame arrives
+    std::vector<uint8_t> ReadData();
+
+    // Non-blocking: copies the next frame into data, reusing its capacity;
+    // false if there is none
+    bool TryReadData(std::vector<uint8_t> &data);
+
+    // Waits up to timeout_ms (-1 for no limit) for a frame
+    bool WaitForData(int timeout_ms);
+
+    // Same contract as IPCReceiver::GetLastFrameTimestamps
+    const FrameTimestamps &GetLastFrameTimestamps() const { return last_timestamps_; }
+
+    bool IsInitialized() const { return ring_.IsOpen(); }
+
+    const std::string &GetRingPath() const { return ring_path_; }
+
+  private:
+    std::string ring_path_;
+    Config config_;
+    SharedMemoryRing ring_;
+    FrameTimestamps last_timestamps_;
+};
+
+} // namespace IPC
@@ -0,0 +1,304 @@
+#include "SharedMemoryRing.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <linux/futex.h>
+#include <new>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace IPC {
+
+namespace {
+
+constexpr size_t kMinCapacity = 4096;
+
+uint64_t align_record(uint64_t size) { return (size + 7) & ~uint64_t{7}; }
+
+size_t round_up_power_of_two(size_t value) {
+    size_t result = kMinCapacity;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Not FUTEX_PRIVATE: the word lives in a mapping shared across processes
+long futex(std::atomic<uint32_t> *word, int op, uint32_t value, const struct timespec *timeout) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), op, value, timeout, nullptr, 0);
+}
+
+} // namespace
+
+SharedMemoryRing::~SharedMemoryRing() { Close(); }
+
+bool SharedMemoryRing::Create(const std::string &path, size_t capacity, bool futex_wakeup) {
+    Close();
+
+    // A new file rather than truncating the old one: a sender may still map
+    // it, and shrinking or resetting it under that sender would SIGBUS it or
+    // let it write into the new ring alongside the next sender
+    unlink(path.c_str());
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        std::cerr << "Failed to create shared memory ring " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    capacity = round_up_power_of_two(capacity);
+    size_t size = sizeof(SharedRingHeader) + capacity;
+    if (ftruncate(fd, size) < 0) {
+        std::cerr << "Failed to size shared memory ring " << path << ": " << strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+
+    if (!Map(fd, size)) {
+        return false;
+    }
+
+    new (header_) SharedRingHeader();
+    header_->version = SharedRingHeader::kVersion;
+    header_->futex_wakeup = futex_wakeup;
+    header_->capacity = capacity;
+    header_->receiver_pid.store(getpid(), std::memory_order_relaxed);
+    header_->magic.store(SharedRingHeader::kMagic, std::memory_order_release);
+
+    capacity_ = capacity;
+    futex_wakeup_ = futex_wakeup;
+    local_pos_ = 0;
+    cached_remote_pos_ = 0;
+    return true;
+}
+
+bool SharedMemoryRing::Open(const std::string &path) {
+    Close();
+
+    int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Failed to open shared memory ring " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(SharedRingHeader) + kMinCapacity) {
+        std::cerr << "Shared memory ring " << path << " is not initialized" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    if (!Map(fd, info.st_size)) {
+        return false;
+    }
+
+    if (header_->magic.load(std::memory_order_acquire) != SharedRingHeader::kMagic || header_->version != SharedRingHeader::kVersion ||
+        sizeof(SharedRingHeader) + header_->capacity != mapping_size_) {
+        std::cerr << "Shared memory ring " << path << " has an unknown layout" << std::endl;
+        Close();
+        return false;
+    }
+
+    if (!AttachSender()) {
+        std::cerr << "Shared memory ring " << path << " already has a sender" << std::endl;
+        munmap(header_, mapping_size_);
+        header_ = nullptr;
+        return false;
+    }
+
+    producer_ = true;
+    capacity_ = header_->capacity;
+    futex_wakeup_ = header_->futex_wakeup;
+    local_pos_ = header_->write_pos.load(std::memory_order_relaxed);
+    cached_remote_pos_ = header_->read_pos.load(std::memory_order_acquire);
+    return true;
+}
+
+bool SharedMemoryRing::AttachSender() {
+    int32_t self = getpid();
+    int32_t owner = 0;
+    while (!header_->sender_pid.compare_exchange_strong(owner, self, std::memory_order_acq_rel)) {
+        // Taken over only from a process that no longer exists, which could
+        // not detach. Same-host processes only: pids from another pid
+        // namespace cannot be checked.
+        if (owner == self || kill(owner, 0) == 0 || errno != ESRCH) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SharedMemoryRing::Map(int fd, size_t size) {
+    void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory ring: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    header_ = static_cast<SharedRingHeader *>(mapping);
+    data_ = static_cast<uint8_t *>(mapping) + sizeof(SharedRingHeader);
+    mapping_size_ = size;
+    return true;
+}
+
+void SharedMemoryRing::Close() {
+    if (!header_) {
+        return;
+    }
+
+    if (producer_) {
+        header_->sender_pid.store(0, std::memory_order_release);
+        producer_ = false;
+    } else {
+        // Tells a sender still attached to stop writing into a ring nobody
+        // reads (Create closes the previous ring before replacing its file)
+        header_->receiver_pid.store(0, std::memory_order_release);
+    }
+    munmap(header_, mapping_size_);
+    header_ = nullptr;
+    data_ = nullptr;
+    peeked_bytes_ = 0;
+}
+
+size_t SharedMemoryRing::GetMaxRecordSize() const { return capacity_ / 2 - sizeof(RecordHeader); }
+
+bool SharedMemoryRing::IsReceiverGone() const {
+    int32_t receiver = header_->receiver_pid.load(std::memory_order_acquire);
+    return receiver == 0 || (kill(receiver, 0) < 0 && errno == ESRCH);
+}
+
+bool SharedMemoryRing::TryWrite(uint32_t flags, const void *prefix, size_t prefix_size, const void *payload, size_t payload_size) {
+    size_t content_size = prefix_size + payload_size;
+    if (content_size > GetMaxRecordSize() || header_->receiver_pid.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    uint64_t record_size = align_record(sizeof(RecordHeader) + content_size);
+    uint64_t to_end = capacity_ - (local_pos_ & (capacity_ - 1));
+    uint64_t needed = record_size <= to_end ? record_size : to_end + record_size;
+
+    if (local_pos_ + needed - cached_remote_pos_ > capacity_) {
+        cached_remote_pos_ = header_->read_pos.load(std::memory_order_acquire);
+        if (local_pos_ + needed - cached_remote_pos_ > capacity_) {
+            return false;
+        }
+    }
+
+    if (record_size > to_end) {
+        RecordHeader padding{static_cast<uint32_t>(to_end), kPaddingRecord};
+        memcpy(At(local_pos_), &padding, sizeof(padding));
+        local_pos_ += to_end;
+    }
+
+    uint8_t *record = At(local_pos_);
+    RecordHeader record_header{static_cast<uint32_t>(content_size), flags};
+    memcpy(record, &record_header, sizeof(record_header));
+    if (prefix_size > 0) {
+        memcpy(record + sizeof(RecordHeader), prefix, prefix_size);
+    }
+    memcpy(record + sizeof(RecordHeader) + prefix_size, payload, payload_size);
+
+    local_pos_ += record_size;
+    header_->write_pos.store(local_pos_, std::memory_order_release);
+
+    if (futex_wakeup_) {
+        WakeConsumer();
+    }
+    return true;
+}
+
+void SharedMemoryRing::WakeConsumer() {
+    // Pairs with the fence in WaitForData: either the consumer sees the new
+    // write_pos before sleeping, or this sees consumer_waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->consumer_waiting.load(std::memory_order_relaxed)) {
+        header_->wakeup_seq.fetch_add(1, std::memory_order_release);
+        futex(&header_->wakeup_seq, FUTEX_WAKE, 1, nullptr);
+    }
+}
+
+bool SharedMemoryRing::HasData() {
+    if (local_pos_ == cached_remote_pos_) {
+        cached_remote_pos_ = header_->write_pos.load(std::memory_order_acquire);
+    }
+    return local_pos_ != cached_remote_pos_;
+}
+
+bool SharedMemoryRing::Peek(uint32_t &flags, const uint8_t *&data, size_t &size) {
+    while (HasData()) {
+        RecordHeader record_header;
+        memcpy(&record_header, At(local_pos_), sizeof(record_header));
+
+        if (record_header.flags == kPaddingRecord) {
+            local_pos_ += record_header.size;
+            header_->read_pos.store(local_pos_, std::memory_order_release);
+            continue;
+        }
+
+        flags = record_header.flags;
+        data = At(local_pos_) + sizeof(RecordHeader);
+        size = record_header.size;
+        peeked_bytes_ = align_record(sizeof(RecordHeader) + size);
+        return true;
+    }
+    return false;
+}
+
+void SharedMemoryRing::Consume() {
+    local_pos_ += peeked_bytes_;
+    peeked_bytes_ = 0;
+    header_->read_pos.store(local_pos_, std::memory_order_release);
+}
+
+bool SharedMemoryRing::WaitForData(int timeout_ms, int spin_count) {
+    for (int i = 0; i < spin_count; ++i) {
+        if (HasData()) {
+            return true;
+        }
+        cpu_relax();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!HasData()) {
+        auto remaining = deadline - std::chrono::steady_clock::now();
+        if (timeout_ms >= 0 && remaining <= std::chrono::nanoseconds::zero()) {
+            return false;
+        }
+
+        if (!futex_wakeup_) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint32_t seq = header_->wakeup_seq.load(std::memory_order_acquire);
+        header_->consumer_waiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!HasData()) {
+            struct timespec timeout;
+            if (timeout_ms >= 0) {
+                auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+                timeout.tv_sec = nanos / 1000000000;
+                timeout.tv_nsec = nanos % 1000000000;
+            }
+            futex(&header_->wakeup_seq, FUTEX_WAIT, seq, timeout_ms >= 0 ? &timeout : nullptr);
+        }
+        header_->consumer_waiting.store(0, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+} // namespace IPC
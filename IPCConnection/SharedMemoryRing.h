@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace IPC {
+
+inline constexpr size_t kCacheLineSize = 64;
+
+// Start of a shared ring mapping; the data area follows it. The producer's
+// and the consumer's positions sit on separate cache lines, and each side
+// keeps a private copy of the other's position that it refreshes only when
+// it has run out of room or records, so the lines change owner once per
+// batch rather than once per record.
+struct alignas(kCacheLineSize) SharedRingHeader {
+    static constexpr uint64_t kMagic = 0x474e495250434950ull; // "PICPRING"
+    static constexpr uint32_t kVersion = 3;
+
+    std::atomic<uint64_t> magic; // stored last by the creator
+    uint32_t version;
+    uint32_t futex_wakeup; // consumer may sleep on wakeup_seq
+    uint64_t capacity;     // data bytes, a power of two
+    std::atomic<int32_t> sender_pid;   // 0 while no sender is attached
+    std::atomic<int32_t> receiver_pid; // the creator; 0 once it closed or replaced the ring
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> write_pos; // bytes ever written
+    alignas(kCacheLineSize) std::atomic<uint64_t> read_pos;  // bytes ever consumed
+
+    alignas(kCacheLineSize) std::atomic<uint32_t> consumer_waiting;
+    std::atomic<uint32_t> wakeup_seq; // futex word
+};
+
+// Single-producer single-consumer ring of variable-length records in a
+// file-backed shared mapping (use a path under /dev/shm). Records are an
+// 8-byte header (size, flags) followed by the payload, padded to 8 bytes; a
+// record never wraps, the space left at the end is skipped instead.
+class SharedMemoryRing {
+  public:
+    SharedMemoryRing() = default;
+    ~SharedMemoryRing();
+
+    SharedMemoryRing(const SharedMemoryRing &) = delete;
+    SharedMemoryRing &operator=(const SharedMemoryRing &) = delete;
+
+    // Consumer side: creates the ring at path, replacing any previous one
+    // with a new file; capacity is rounded up to a power of two. A sender
+    // still mapping the previous ring sees it closed and must reconnect.
+    bool Create(const std::string &path, size_t capacity, bool futex_wakeup);
+
+    // Producer side: maps a ring created by Create(). Fails while another
+    // live process is attached; a sender that died attached is replaced.
+    bool Open(const std::string &path);
+
+    void Close();
+
+    bool IsOpen() const { return header_ != nullptr; }
+    SharedRingHeader *GetHeader() const { return header_; }
+
+    // Largest prefix + payload a single record can carry
+    size_t GetMaxRecordSize() const;
+
+    // Producer: whether the consumer has closed or replaced the ring, or its
+    // process is gone (a system call; check only once the ring is full)
+    bool IsReceiverGone() const;
+
+    // Producer: appends prefix then payload as one record; false if the ring
+    // does not have room for it right now or the consumer has closed it
+    bool TryWrite(uint32_t flags, const void *prefix, size_t prefix_size, const void *payload, size_t payload_size);
+
+    // Consumer: the next record, valid until Consume(); false if none
+    bool Peek(uint32_t &flags, const uint8_t *&data, size_t &size);
+    void Consume();
+
+    // Consumer: waits up to timeout_ms (-1 for no limit) for a record,
+    // spinning spin_count times first and then sleeping on the futex (or
+    // yielding without futex_wakeup)
+    bool WaitForData(int timeout_ms, int spin_count);
+
+  private:
+    struct RecordHeader {
+        uint32_t size;
+        uint32_t flags;
+    };
+    static constexpr uint32_t kPaddingRecord = UINT32_MAX;
+
+    bool Map(int fd, size_t size);
+    bool AttachSender();
+    uint8_t *At(uint64_t pos) const { return data_ + (pos & (capacity_ - 1)); }
+    bool HasData();
+    void WakeConsumer();
+
+    SharedRingHeader *header_ = nullptr;
+    uint8_t *data_ = nullptr;
+    size_t mapping_size_ = 0;
+    uint64_t capacity_ = 0;
+    bool futex_wakeup_ = false;
+    bool producer_ = false;
+
+    // This side's position and its cached view of the other side's
+    uint64_t local_pos_ = 0;
+    uint64_t cached_remote_pos_ = 0;
+    size_t peeked_bytes_ = 0;
+};
+
+} // namespace IPC
@@ -0,0 +1,64 @@
+#include "SharedMemorySender.h"
+#include "Telemetry/Clock.h"
+#include <iostream>
+#include <thread>
+
+namespace IPC {
+
+bool SharedMemorySender::Connect(const std::string &ring_path) {
+    if (!ring_.Open(ring_path)) {
+        return false;
+    }
+    std::cout << "Connected to shared memory ring: " << ring_path << std::endl;
+    return true;
+}
+
+bool SharedMemorySender::SendData(const void *data, size_t size) { return Send(0, nullptr, 0, data, size); }
+
+bool SharedMemorySender::SendTimestampedData(const void *data, size_t size, uint64_t origin_ns) {
+    uint64_t timestamps[2] = {origin_ns, Telemetry::NowNanos()};
+    return Send(kTimestampedFrameFlag, timestamps, sizeof(timestamps), data, size);
+}
+
+bool SharedMemorySender::TrySendData(const void *data, size_t size) {
+    if (!ring_.IsOpen()) {
+        return false;
+    }
+    if (ring_.TryWrite(0, nullptr, 0, data, size)) {
+        return true;
+    }
+    DisconnectIfReceiverGone();
+    return false;
+}
+
+bool SharedMemorySender::Send(uint32_t flags, const void *prefix, size_t prefix_size, const void *data, size_t size) {
+    if (!ring_.IsOpen()) {
+        std::cerr << "Not connected to any shared memory ring" << std::endl;
+        return false;
+    }
+
+    if (size > GetMaxMessageSize()) {
+        std::cerr << "Message of " << size << " bytes exceeds the shared memory ring's limit of " << GetMaxMessageSize() << std::endl;
+        return false;
+    }
+
+    // Backpressure: the receiver is behind by a full ring
+    while (!ring_.TryWrite(flags, prefix, prefix_size, data, size)) {
+        if (DisconnectIfReceiverGone()) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+bool SharedMemorySender::DisconnectIfReceiverGone() {
+    if (!ring_.IsReceiverGone()) {
+        return false;
+    }
+    std::cerr << "Shared memory ring receiver is gone" << std::endl;
+    Disconnect();
+    return true;
+}
+
+} // namespace IPC
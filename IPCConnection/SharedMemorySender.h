@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "IPCFrame.h"
+#include "SharedMemoryRing.h"
+
+namespace IPC {
+
+// IPCSender over a SharedMemoryReceiver's ring: a send is a copy into shared
+// memory and a release store, with no system call unless the receiver
+// sleeps on its futex. One sender per ring at a time;
+// a sender that died attached is replaced by the next to connect.
+class SharedMemorySender {
+  public:
+    SharedMemorySender() = default;
+    ~SharedMemorySender() { Disconnect(); }
+
+    bool Connect(const std::string &ring_path);
+
+    // Waits while the ring is full. Like a socket's EPIPE, a send fails and
+    // disconnects once the receiver has closed or replaced the ring or died;
+    // IsConnected() then turns false and Connect() attaches to the new ring.
+    bool SendData(const void *data, size_t size);
+    bool SendTimestampedData(const void *data, size_t size, uint64_t origin_ns);
+
+    // Non-blocking SendData: false if the ring is full (or the receiver gone)
+    // and the message was not taken
+    bool TrySendData(const void *data, size_t size);
+
+    void Disconnect() { ring_.Close(); }
+
+    bool IsConnected() const { return ring_.IsOpen(); }
+
+    // Largest payload SendTimestampedData (and so every send) accepts
+    size_t GetMaxMessageSize() const { return ring_.IsOpen() ? ring_.GetMaxRecordSize() - sizeof(uint64_t) * 2 : 0; }
+
+  private:
+    bool Send(uint32_t flags, const void *prefix, size_t prefix_size, const void *data, size_t size);
+    bool DisconnectIfReceiverGone();
+
+    SharedMemoryRing ring_;
+};
+
+} // namespace IPC
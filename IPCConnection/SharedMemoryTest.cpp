@@ -0,0 +1,181 @@
+#include "SharedMemoryReceiver.h"
+#include "SharedMemorySender.h"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <optional>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace IPC {
+
+TEST(SharedMemoryTest, SendReceive) {
+    SharedMemoryReceiver receiver("/dev/shm/test_shm_basic");
+    ASSERT_TRUE(receiver.Initialize());
+
+    SharedMemorySender sender;
+    ASSERT_TRUE(sender.Connect(receiver.GetRingPath()));
+
+    std::string message = "Hello, shared memory!";
+    EXPECT_TRUE(sender.SendData(message.data(), message.size()));
+    EXPECT_TRUE(sender.SendTimestampedData(message.data(), 5, 42));
+
+    auto data = receiver.ReadData();
+    EXPECT_EQ(std::string(data.begin(), data.end()), message);
+    EXPECT_EQ(receiver.GetLastFrameTimestamps().origin_ns, 0u);
+
+    data = receiver.ReadData();
+    EXPECT_EQ(std::string(data.begin(), data.end()), "Hello");
+    const FrameTimestamps &stamps = receiver.GetLastFrameTimestamps();
+    EXPECT_EQ(stamps.origin_ns, 42u);
+    EXPECT_NE(stamps.send_ns, 0u);
+    EXPECT_GE(stamps.receive_ns, stamps.send_ns);
+
+    EXPECT_FALSE(receiver.TryReadData(data));
+    EXPECT_FALSE(receiver.WaitForData(10));
+}
+
+TEST(SharedMemoryTest, SingleSenderAndBoundedMessages) {
+    SharedMemoryReceiver receiver("/dev/shm/test_shm_single", SharedMemoryReceiver::Config{.capacity = 4096});
+    ASSERT_TRUE(receiver.Initialize());
+
+    SharedMemorySender sender;
+    ASSERT_TRUE(sender.Connect(receiver.GetRingPath()));
+
+    SharedMemorySender second;
+    EXPECT_FALSE(second.Connect(receiver.GetRingPath()));
+    sender.Disconnect();
+    EXPECT_TRUE(second.Connect(receiver.GetRingPath()));
+
+    // A sender that died attached does not lock the ring
+    second.Disconnect();
+    pid_t child = fork();
+    if (child == 0) {
+        SharedMemorySender orphan;
+        _exit(orphan.Connect(receiver.GetRingPath()) ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_TRUE(second.Connect(receiver.GetRingPath()));
+
+    std::string too_big(second.GetMaxMessageSize() + 1, 'x');
+    EXPECT_FALSE(second.SendData(too_big.data(), too_big.size()));
+
+    // A full ring refuses non-blocking sends until the receiver catches up
+    std::string message(1000, 'y');
+    size_t sent = 0;
+    while (second.TrySendData(message.data(), message.size())) {
+        sent++;
+    }
+    EXPECT_GT(sent, 0u);
+    EXPECT_LT(sent, 5u);
+
+    std::vector<uint8_t> data;
+    EXPECT_TRUE(receiver.TryReadData(data));
+    EXPECT_EQ(data.size(), message.size());
+    EXPECT_TRUE(second.TrySendData(message.data(), message.size()));
+}
+
+TEST(SharedMemoryTest, SenderSeesReplacedOrClosedRing) {
+    const std::string path = "/dev/shm/test_shm_reinit";
+    std::vector<uint8_t> data;
+    uint8_t byte = 1;
+    {
+        std::optional<SharedMemoryReceiver> receiver(std::in_place, path, SharedMemoryReceiver::Config{.capacity = 4096});
+        ASSERT_TRUE(receiver->Initialize());
+
+        SharedMemorySender stale;
+        ASSERT_TRUE(stale.Connect(path));
+        ASSERT_TRUE(receiver->Initialize());
+
+        // The old ring is marked closed before its file is replaced: the
+        // sender fails and disconnects instead of writing where nobody reads
+        EXPECT_FALSE(stale.TrySendData(&byte, 1));
+        EXPECT_FALSE(stale.IsConnected());
+        ASSERT_TRUE(stale.Connect(path));
+        ASSERT_TRUE(stale.SendData(&byte, 1));
+        ASSERT_TRUE(receiver->TryReadData(data));
+        EXPECT_EQ(data, std::vector<uint8_t>{1});
+
+        // A receiver that shuts down does the same, so a blocking send
+        // waiting on a full ring does not wait forever
+        std::string message(1000, 'x');
+        while (stale.TrySendData(message.data(), message.size())) {
+        }
+        std::thread closer([&receiver]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            receiver.reset();
+        });
+        EXPECT_FALSE(stale.SendData(message.data(), message.size()));
+        closer.join();
+        EXPECT_FALSE(stale.IsConnected());
+    }
+
+    // A receiver process that died without closing is noticed once the ring is full
+    pid_t child = fork();
+    if (child == 0) {
+        SharedMemoryReceiver receiver(path, SharedMemoryReceiver::Config{.capacity = 4096});
+        _exit(receiver.Initialize() ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    SharedMemorySender sender;
+    ASSERT_TRUE(sender.Connect(path));
+    std::string message(1000, 'y');
+    while (sender.TrySendData(message.data(), message.size())) {
+    }
+    EXPECT_FALSE(sender.IsConnected());
+    EXPECT_FALSE(sender.SendData(message.data(), message.size()));
+    unlink(path.c_str());
+}
+
+TEST(SharedMemoryTest, StreamsVariableSizedRecordsAcrossWraps) {
+    for (bool futex_wakeup : {true, false}) {
+        SharedMemoryReceiver receiver("/dev/shm/test_shm_stream", SharedMemoryReceiver::Config{.capacity = 4096, .futex_wakeup = futex_wakeup, .spin_count = 16});
+        ASSERT_TRUE(receiver.Initialize());
+
+        constexpr int kMessages = 20000;
+        std::thread producer([&receiver]() {
+            SharedMemorySender sender;
+            ASSERT_TRUE(sender.Connect(receiver.GetRingPath()));
+            std::vector<uint8_t> message;
+            for (int i = 0; i < kMessages; ++i) {
+                message.assign(1 + (i * 37) % 1500, static_cast<uint8_t>(i));
+                ASSERT_TRUE(sender.SendData(message.data(), message.size()));
+            }
+        });
+
+        for (int i = 0; i < kMessages; ++i) {
+            auto data = receiver.ReadData();
+            ASSERT_EQ(data.size(), 1 + (i * 37) % 1500u) << "message " << i;
+            EXPECT_EQ(data.front(), static_cast<uint8_t>(i));
+            EXPECT_EQ(data.back(), static_cast<uint8_t>(i));
+        }
+        producer.join();
+    }
+}
+
+TEST(SharedMemoryTest, SleepingReceiverIsWoken) {
+    SharedMemoryReceiver receiver("/dev/shm/test_shm_wakeup");
+    ASSERT_TRUE(receiver.Initialize());
+
+    SharedMemorySender sender;
+    ASSERT_TRUE(sender.Connect(receiver.GetRingPath()));
+
+    std::vector<uint8_t> received;
+    std::thread reader([&receiver, &received]() { received = receiver.ReadData(); });
+
+    // Long enough for the reader to be asleep on the futex
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    uint8_t byte = 7;
+    EXPECT_TRUE(sender.SendData(&byte, 1));
+
+    reader.join();
+    EXPECT_EQ(received, std::vector<uint8_t>{7});
+}
+
+} // namespace IPC
@@ -0,0 +1,255 @@
+#include "Logger.h"
+#include <charconv>
+#include <ctime>
+
+namespace Logging {
+
+namespace {
+
+constexpr size_t kMaxRecordsPerPass = 256; // per ring, so one busy thread cannot starve the others
+constexpr auto kIdleWait = std::chrono::milliseconds(1);
+
+const char *level_name(LogLevel level) {
+    switch (level) {
+    case LogLevel::DEBUG:
+        return "DEBUG";
+    case LogLevel::INFO:
+        return "INFO ";
+    case LogLevel::WARN:
+        return "WARN ";
+    case LogLevel::ERROR:
+    default:
+        return "ERROR";
+    }
+}
+
+template <typename T> void append_number(std::string &out, T value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Appends the next argument at offset, returning false once there is none
+bool append_arg(const LogRecord &record, size_t &offset, std::string &out) {
+    if (offset >= record.size) {
+        return false;
+    }
+
+    ArgType type = static_cast<ArgType>(record.args[offset++]);
+    const char *data = record.args.data() + offset;
+    switch (type) {
+    case ArgType::INT: {
+        int64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        append_number(out, value);
+        offset += sizeof(value);
+        break;
+    }
+    case ArgType::UINT: {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        append_number(out, value);
+        offset += sizeof(value);
+        break;
+    }
+    case ArgType::DOUBLE: {
+        double value;
+        std::memcpy(&value, data, sizeof(value));
+        append_number(out, value);
+        offset += sizeof(value);
+        break;
+    }
+    case ArgType::BOOL:
+        out += *data ? "true" : "false";
+        offset += sizeof(bool);
+        break;
+    case ArgType::CHAR:
+        out += *data;
+        offset += sizeof(char);
+        break;
+    case ArgType::STRING: {
+        uint16_t length;
+        std::memcpy(&length, data, sizeof(length));
+        out.append(data + sizeof(length), length);
+        offset += sizeof(length) + length;
+        break;
+    }
+    }
+    return true;
+}
+
+} // namespace
+
+void RecordWriter::Put(ArgType type, const void *data, size_t length) {
+    if (record_.truncated || record_.size + 1 + length > record_.args.size()) {
+        record_.truncated = true;
+        return;
+    }
+
+    record_.args[record_.size++] = static_cast<char>(type);
+    std::memcpy(record_.args.data() + record_.size, data, length);
+    record_.size += static_cast<uint16_t>(length);
+}
+
+void RecordWriter::AddString(std::string_view text) {
+    constexpr size_t kHeader = 1 + sizeof(uint16_t);
+    if (record_.truncated || record_.size + kHeader > record_.args.size()) {
+        record_.truncated = true;
+        return;
+    }
+
+    size_t room = record_.args.size() - record_.size - kHeader;
+    if (text.size() > room) {
+        text = text.substr(0, room);
+        record_.truncated = true;
+    }
+
+    uint16_t length = static_cast<uint16_t>(text.size());
+    record_.args[record_.size++] = static_cast<char>(ArgType::STRING);
+    std::memcpy(record_.args.data() + record_.size, &length, sizeof(length));
+    std::memcpy(record_.args.data() + record_.size + sizeof(length), text.data(), length);
+    record_.size += static_cast<uint16_t>(sizeof(length) + length);
+}
+
+Logger &Logger::Instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : output_(stdout) { writer_ = std::thread([this]() { Run(); }); }
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        running_.store(false);
+    }
+    flush_cv_.notify_all();
+    writer_.join();
+}
+
+void Logger::SetOutput(FILE *output) {
+    Flush();
+    output_.store(output);
+}
+
+void Logger::Flush() {
+    std::unique_lock<std::mutex> lock(flush_mutex_);
+    uint64_t target = ++flush_requested_;
+    flush_cv_.notify_all();
+    flush_cv_.wait(lock, [this, target]() { return flush_completed_ >= target; });
+}
+
+ThreadRing &Logger::LocalRing() {
+    // Marks the ring retired when the thread exits; the writer drains and
+    // then releases it
+    struct RingHandle {
+        std::shared_ptr<ThreadRing> ring;
+        ~RingHandle() {
+            if (ring) {
+                ring->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+    thread_local RingHandle handle;
+
+    if (!handle.ring) {
+        handle.ring = std::make_shared<ThreadRing>();
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.push_back(handle.ring);
+    }
+    return *handle.ring;
+}
+
+void Logger::Run() {
+    uint64_t reported_dropped = 0;
+
+    while (true) {
+        uint64_t requested;
+        {
+            std::lock_guard<std::mutex> lock(flush_mutex_);
+            requested = flush_requested_;
+        }
+
+        if (DrainOnce() > 0) {
+            continue;
+        }
+
+        uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != reported_dropped) {
+            std::fprintf(output_.load(), "Logger dropped %llu records (ring full)\n", static_cast<unsigned long long>(dropped - reported_dropped));
+            reported_dropped = dropped;
+        }
+        std::fflush(output_.load());
+
+        // Every ring was empty after requested was read, so everything logged
+        // before that flush request is out
+        std::unique_lock<std::mutex> lock(flush_mutex_);
+        flush_completed_ = requested;
+        flush_cv_.notify_all();
+        if (!running_.load()) {
+            return;
+        }
+        flush_cv_.wait_for(lock, kIdleWait, [this, requested]() { return flush_requested_ != requested || !running_.load(); });
+    }
+}
+
+size_t Logger::DrainOnce() {
+    size_t written = 0;
+    FILE *output = output_.load();
+
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (auto it = rings_.begin(); it != rings_.end();) {
+        ThreadRing &ring = **it;
+        // Read before draining: records committed before retirement are
+        // then seen by this pass
+        bool retired = ring.retired.load(std::memory_order_acquire);
+
+        size_t count = 0;
+        const LogRecord *record;
+        while (count < kMaxRecordsPerPass && (record = ring.Front())) {
+            line_buffer_.clear();
+            Format(*record, line_buffer_);
+            std::fwrite(line_buffer_.data(), 1, line_buffer_.size(), output);
+            ring.Pop();
+            count++;
+        }
+        written += count;
+
+        if (retired && !ring.Front()) {
+            it = rings_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return written;
+}
+
+void Logger::Format(const LogRecord &record, std::string &out) const {
+    time_t seconds = static_cast<time_t>(record.timestamp_ns / 1000000000);
+    uint64_t micros = record.timestamp_ns % 1000000000 / 1000;
+    std::tm local;
+    localtime_r(&seconds, &local);
+
+    char prefix[32];
+    int length = std::snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%06llu ", local.tm_hour, local.tm_min, local.tm_sec,
+                               static_cast<unsigned long long>(micros));
+    out.append(prefix, static_cast<size_t>(length));
+    out += level_name(record.format->level);
+    out += ' ';
+
+    size_t offset = 0;
+    for (const char *p = record.format->format; *p; ++p) {
+        if (p[0] == '{' && p[1] == '}' && append_arg(record, offset, out)) {
+            ++p;
+        } else {
+            out += *p;
+        }
+    }
+
+    if (record.truncated) {
+        out += " [truncated]";
+    }
+    out += '\n';
+}
+
+} // namespace Logging
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Statements below this level are compiled out; build with
+// --copt=-DLOGGING_MIN_LEVEL=0 to keep LOG_DEBUG
+#ifndef LOGGING_MIN_LEVEL
+#define LOGGING_MIN_LEVEL 1
+#endif
+
+#define LOG_AT(level, fmt, ...)                                                                                                                     \
+    do {                                                                                                                                               \
+        if constexpr (static_cast<int>(level) >= LOGGING_MIN_LEVEL) {                                                                                  \
+            static constexpr ::Logging::FormatInfo log_format_info{level, fmt, __FILE__, __LINE__};                                                    \
+            ::Logging::Logger::Instance().Log(log_format_info __VA_OPT__(, ) __VA_ARGS__);                                                             \
+        }                                                                                                                                              \
+    } while (0)
+
+#define LOG_DEBUG(fmt, ...) LOG_AT(::Logging::LogLevel::DEBUG, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_INFO(fmt, ...) LOG_AT(::Logging::LogLevel::INFO, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_WARN(fmt, ...) LOG_AT(::Logging::LogLevel::WARN, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_ERROR(fmt, ...) LOG_AT(::Logging::LogLevel::ERROR, fmt __VA_OPT__(, ) __VA_ARGS__)
+
+namespace Logging {
+
+enum class LogLevel : uint8_t { DEBUG = 0, INFO = 1, WARN = 2, ERROR = 3 };
+
+// One per log statement, with static storage; its address is the format id
+// stored in records, so nothing but the arguments is copied per call
+struct FormatInfo {
+    LogLevel level;
+    const char *format; // "{}" placeholders, filled in argument order
+    const char *file;
+    int line;
+};
+
+enum class ArgType : uint8_t { INT, UINT, DOUBLE, BOOL, CHAR, STRING };
+
+constexpr size_t kRecordSize = 256;
+constexpr size_t kRingRecords = 4096;
+
+// Fixed-size binary record: format id, timestamp and the tagged arguments.
+// Strings are copied inline and cut off once the record is full.
+struct LogRecord {
+    const FormatInfo *format;
+    uint64_t timestamp_ns;
+    uint16_t size;
+    bool truncated;
+    std::array<char, kRecordSize - 24> args;
+};
+
+static_assert(sizeof(LogRecord) == kRecordSize, "LogRecord must stay one fixed-size slot");
+
+// Single-producer/single-consumer ring of records owned by one logging thread
+// and drained by the writer thread
+class ThreadRing {
+  public:
+    ThreadRing() : records_(kRingRecords) {}
+
+    // Producer side; nullptr when full
+    LogRecord *BeginWrite() {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == records_.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == records_.size()) {
+                return nullptr;
+            }
+        }
+        return &records_[tail % records_.size()];
+    }
+
+    void CommitWrite() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer side
+    const LogRecord *Front() {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        return head == tail_.load(std::memory_order_acquire) ? nullptr : &records_[head % records_.size()];
+    }
+
+    void Pop() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    std::atomic<bool> retired{false}; // owning thread has exited
+
+  private:
+    std::vector<LogRecord> records_;
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    uint64_t cached_head_ = 0;
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+// Appends tagged arguments to a record
+class RecordWriter {
+  public:
+    explicit RecordWriter(LogRecord &record) : record_(record) {}
+
+    template <typename T> void Add(const T &value) {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            Put(ArgType::BOOL, &value, sizeof(value));
+        } else if constexpr (std::is_same_v<U, char>) {
+            Put(ArgType::CHAR, &value, sizeof(value));
+        } else if constexpr (std::is_enum_v<U>) {
+            Add(static_cast<std::underlying_type_t<U>>(value));
+        } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+            int64_t widened = value;
+            Put(ArgType::INT, &widened, sizeof(widened));
+        } else if constexpr (std::is_integral_v<U>) {
+            uint64_t widened = value;
+            Put(ArgType::UINT, &widened, sizeof(widened));
+        } else if constexpr (std::is_floating_point_v<U>) {
+            double widened = value;
+            Put(ArgType::DOUBLE, &widened, sizeof(widened));
+        } else {
+            static_assert(std::is_convertible_v<const T &, std::string_view>, "Unsupported log argument type");
+            AddString(std::string_view(value));
+        }
+    }
+
+  private:
+    void Put(ArgType type, const void *data, size_t length);
+    void AddString(std::string_view text);
+
+    LogRecord &record_;
+};
+
+// Process-wide logger. Log() only copies the arguments into the calling
+// thread's ring (no lock, no I/O, no allocation after the thread's first
+// call); a background thread formats the records and writes them out. When a
+// thread's ring is full the record is dropped and counted rather than
+// blocking the caller.
+class Logger {
+  public:
+    static Logger &Instance();
+
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    template <typename... Args> void Log(const FormatInfo &format, const Args &...args) {
+        ThreadRing &ring = LocalRing();
+        LogRecord *record = ring.BeginWrite();
+        if (!record) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        record->format = &format;
+        record->timestamp_ns =
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        record->size = 0;
+        record->truncated = false;
+
+        RecordWriter writer(*record);
+        (writer.Add(args), ...);
+        ring.CommitWrite();
+    }
+
+    // Redirects output (default stdout); the logger does not take ownership
+    void SetOutput(FILE *output);
+
+    // Blocks until every record logged before the call has been written
+    void Flush();
+
+    uint64_t GetDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+  private:
+    Logger();
+    ~Logger();
+
+    ThreadRing &LocalRing();
+
+    void Run();
+    size_t DrainOnce();
+    void Format(const LogRecord &record, std::string &out) const;
+
+    std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<ThreadRing>> rings_;
+
+    std::atomic<FILE *> output_;
+    std::atomic<uint64_t> dropped_{0};
+    std::string line_buffer_;
+
+    std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+    uint64_t flush_requested_ = 0;
+    uint64_t flush_completed_ = 0;
+
+    std::atomic<bool> running_{true};
+    std::thread writer_;
+};
+
+} // namespace Logging
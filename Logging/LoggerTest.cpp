@@ -0,0 +1,111 @@
+#include "Logger.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace {
+
+// Points the logger at a temp file for the test's lifetime
+class LoggerTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        output_ = std::tmpfile();
+        ASSERT_NE(output_, nullptr);
+        Logging::Logger::Instance().SetOutput(output_);
+    }
+
+    void TearDown() override {
+        Logging::Logger::Instance().SetOutput(stdout);
+        std::fclose(output_);
+    }
+
+    std::vector<std::string> ReadLines() {
+        Logging::Logger::Instance().Flush();
+
+        std::string contents;
+        std::rewind(output_);
+        char buffer[4096];
+        size_t n;
+        while ((n = std::fread(buffer, 1, sizeof(buffer), output_)) > 0) {
+            contents.append(buffer, n);
+        }
+
+        std::vector<std::string> lines;
+        std::istringstream stream(contents);
+        for (std::string line; std::getline(stream, line);) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    FILE *output_ = nullptr;
+};
+
+// Drops the "HH:MM:SS.uuuuuu " prefix
+std::string strip_time(const std::string &line) { return line.size() > 16 ? line.substr(16) : line; }
+
+} // namespace
+
+TEST_F(LoggerTest, FormatsArgumentsInOrder) {
+    std::string instrument = "BTCUSD-PERP";
+    LOG_INFO("{} bid {} x {} seq {} ok {} side {}", instrument, 65000.5, -3, uint64_t{42}, true, 'B');
+    LOG_ERROR("no arguments");
+    LOG_WARN("missing {} and {}", "one");
+
+    auto lines = ReadLines();
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_EQ(strip_time(lines[0]), "INFO  BTCUSD-PERP bid 65000.5 x -3 seq 42 ok true side B");
+    EXPECT_EQ(strip_time(lines[1]), "ERROR no arguments");
+    EXPECT_EQ(strip_time(lines[2]), "WARN  missing one and {}");
+}
+
+TEST_F(LoggerTest, DebugIsCompiledOutByDefault) {
+    int evaluated = 0;
+    LOG_DEBUG("side effect {}", ++evaluated);
+    LOG_INFO("kept");
+
+    auto lines = ReadLines();
+    EXPECT_EQ(evaluated, LOGGING_MIN_LEVEL == 0 ? 1 : 0);
+    ASSERT_EQ(lines.size(), LOGGING_MIN_LEVEL == 0 ? 2 : 1);
+    EXPECT_EQ(strip_time(lines.back()), "INFO  kept");
+}
+
+TEST_F(LoggerTest, LongStringsAreTruncated) {
+    std::string payload(1000, 'x');
+    LOG_INFO("payload {} after {}", payload, 7);
+
+    auto lines = ReadLines();
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_LT(lines[0].size(), 300);
+    EXPECT_NE(lines[0].find(" [truncated]"), std::string::npos);
+    EXPECT_EQ(lines[0].find("after 7"), std::string::npos);
+}
+
+TEST_F(LoggerTest, CollectsRecordsFromManyThreads) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 1000;
+    uint64_t dropped_before = Logging::Logger::Instance().GetDroppedCount();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < kPerThread; ++i) {
+                LOG_INFO("thread {} record {}", t, i);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto lines = ReadLines();
+    ASSERT_EQ(Logging::Logger::Instance().GetDroppedCount(), dropped_before);
+    ASSERT_EQ(lines.size(), kThreads * kPerThread);
+
+    // Each thread's records stay in order
+    std::vector<int> next(kThreads, 0);
+    for (const auto &line : lines) {
+        int t, i;
+        ASSERT_EQ(std::sscanf(strip_time(line).c_str(), "INFO  thread %d record %d", &t, &i), 2);
+        EXPECT_EQ(i, next[t]++);
+    }
+}
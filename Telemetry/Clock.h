@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+namespace Telemetry {
+
+// Wall-clock nanoseconds. Pipeline stamps use CLOCK_REALTIME rather than a
+// monotonic clock so stamps taken in different processes on the host, and the
+// exchange's millisecond t, can be compared directly.
+inline uint64_t NowNanos() {
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+} // namespace Telemetry
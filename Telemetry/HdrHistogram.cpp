@@ -0,0 +1,119 @@
+#include "HdrHistogram.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Telemetry {
+
+HdrHistogram::HdrHistogram(const Config &config) : max_value_(std::max<uint64_t>(config.max_value, 2)) {
+    int digits = std::clamp(config.significant_digits, 1, 5);
+
+    // Sub-buckets per bucket: enough that one unit is 10^-digits of the
+    // smallest value in the bucket's upper half
+    uint64_t largest_single_unit_resolution = 2 * static_cast<uint64_t>(std::pow(10, digits));
+    uint64_t sub_bucket_count = std::bit_ceil(largest_single_unit_resolution);
+    sub_bucket_half_count_magnitude_ = std::countr_zero(sub_bucket_count) - 1;
+    sub_bucket_half_count_ = sub_bucket_count / 2;
+    sub_bucket_mask_ = sub_bucket_count - 1;
+
+    size_t bucket_count = 1;
+    uint64_t smallest_untrackable = sub_bucket_count;
+    while (smallest_untrackable <= max_value_) {
+        if (smallest_untrackable > UINT64_MAX / 2) {
+            bucket_count++;
+            break;
+        }
+        smallest_untrackable <<= 1;
+        bucket_count++;
+    }
+
+    counts_length_ = (bucket_count + 1) * sub_bucket_half_count_;
+    counts_ = std::make_unique<std::atomic<uint64_t>[]>(counts_length_);
+    for (size_t i = 0; i < counts_length_; ++i) {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t HdrHistogram::GetCountsIndex(uint64_t value) const {
+    // Bucket 0 holds [0, sub_bucket_count); bucket b > 0 holds the upper half
+    // of its sub-buckets, each 2^b wide
+    int bucket = 64 - std::countl_zero(value | sub_bucket_mask_) - (sub_bucket_half_count_magnitude_ + 1);
+    uint64_t sub_bucket = value >> bucket;
+    return (static_cast<size_t>(bucket + 1) << sub_bucket_half_count_magnitude_) + (sub_bucket - sub_bucket_half_count_);
+}
+
+uint64_t HdrHistogram::GetHighestEquivalentValue(size_t index) const {
+    int bucket = static_cast<int>(index >> sub_bucket_half_count_magnitude_) - 1;
+    uint64_t sub_bucket = (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+    if (bucket < 0) {
+        sub_bucket -= sub_bucket_half_count_;
+        bucket = 0;
+    }
+    uint64_t lowest = sub_bucket << bucket;
+    return lowest + (uint64_t{1} << bucket) - 1;
+}
+
+void HdrHistogram::Record(uint64_t value) {
+    value = std::min(value, max_value_);
+
+    // Single writer: plain load/store instead of read-modify-write
+    std::atomic<uint64_t> &count = counts_[GetCountsIndex(value)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total_count_.store(total_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    if (value < min_.load(std::memory_order_relaxed)) {
+        min_.store(value, std::memory_order_relaxed);
+    }
+    if (value > max_.load(std::memory_order_relaxed)) {
+        max_.store(value, std::memory_order_relaxed);
+    }
+}
+
+uint64_t HdrHistogram::GetValueAtPercentile(double percentile) const {
+    uint64_t total = GetCount();
+    if (total == 0) {
+        return 0;
+    }
+
+    double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+    uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total))), 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_length_; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return std::min(GetHighestEquivalentValue(i), GetMax());
+        }
+    }
+    return GetMax();
+}
+
+HistogramSnapshot HdrHistogram::GetSnapshot() const {
+    HistogramSnapshot snapshot;
+    snapshot.count = GetCount();
+    if (snapshot.count == 0) {
+        return snapshot;
+    }
+
+    snapshot.min = min_.load(std::memory_order_relaxed);
+    snapshot.max = GetMax();
+    snapshot.mean = static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(snapshot.count);
+
+    // One pass over the counts for all percentiles
+    const double percentiles[] = {50.0, 90.0, 99.0, 99.9};
+    uint64_t *outputs[] = {&snapshot.p50, &snapshot.p90, &snapshot.p99, &snapshot.p999};
+    size_t next = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_length_ && next < 4; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        while (next < 4 && seen >= std::max<uint64_t>(static_cast<uint64_t>(std::ceil(percentiles[next] / 100.0 * snapshot.count)), 1)) {
+            *outputs[next++] = std::min(GetHighestEquivalentValue(i), snapshot.max);
+        }
+    }
+    for (; next < 4; ++next) {
+        *outputs[next] = snapshot.max;
+    }
+    return snapshot;
+}
+
+} // namespace Telemetry
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Telemetry {
+
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    double mean = 0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+};
+
+// High-dynamic-range histogram of non-negative integer values (nanoseconds
+// here). Buckets double in width while each keeps the same number of linear
+// sub-buckets, so any recorded value is reported within a relative error of
+// 10^-significant_digits using a fixed array sized at construction. Values
+// above max_value are recorded as max_value.
+//
+// Record() is allocation-free, lock-free and meant for a single writer
+// thread; any thread may read concurrently. Readers see each counter
+// atomically but not all counters at one instant, which is fine for
+// monitoring.
+class HdrHistogram {
+  public:
+    struct Config {
+        uint64_t max_value = 60'000'000'000; // 60 s in nanoseconds
+        int significant_digits = 2;          // 1 to 5
+    };
+
+    HdrHistogram() : HdrHistogram(Config{}) {}
+    explicit HdrHistogram(const Config &config);
+
+    HdrHistogram(const HdrHistogram &) = delete;
+    HdrHistogram &operator=(const HdrHistogram &) = delete;
+
+    void Record(uint64_t value);
+
+    uint64_t GetCount() const { return total_count_.load(std::memory_order_relaxed); }
+    uint64_t GetMax() const { return max_.load(std::memory_order_relaxed); }
+
+    // Highest value equivalent (within the precision) to the given percentile,
+    // 0 when empty
+    uint64_t GetValueAtPercentile(double percentile) const;
+
+    HistogramSnapshot GetSnapshot() const;
+
+  private:
+    size_t GetCountsIndex(uint64_t value) const;
+    uint64_t GetHighestEquivalentValue(size_t index) const;
+
+    uint64_t max_value_;
+    int sub_bucket_half_count_magnitude_;
+    uint64_t sub_bucket_half_count_;
+    uint64_t sub_bucket_mask_;
+    size_t counts_length_;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+
+    std::atomic<uint64_t> total_count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace Telemetry
@@ -0,0 +1,63 @@
+#include "HdrHistogram.h"
+#include <gtest/gtest.h>
+
+using Telemetry::HdrHistogram;
+
+TEST(HdrHistogramTest, EmptyHistogram) {
+    HdrHistogram histogram;
+    auto snapshot = histogram.GetSnapshot();
+    EXPECT_EQ(snapshot.count, 0);
+    EXPECT_EQ(snapshot.p99, 0);
+    EXPECT_EQ(histogram.GetValueAtPercentile(50), 0);
+}
+
+TEST(HdrHistogramTest, SmallValuesAreExact) {
+    HdrHistogram histogram;
+    for (uint64_t value = 1; value <= 100; ++value) {
+        histogram.Record(value);
+    }
+
+    auto snapshot = histogram.GetSnapshot();
+    EXPECT_EQ(snapshot.count, 100);
+    EXPECT_EQ(snapshot.min, 1);
+    EXPECT_EQ(snapshot.max, 100);
+    EXPECT_DOUBLE_EQ(snapshot.mean, 50.5);
+    EXPECT_EQ(snapshot.p50, 50);
+    EXPECT_EQ(snapshot.p90, 90);
+    EXPECT_EQ(snapshot.p99, 99);
+    EXPECT_EQ(snapshot.p999, 100);
+}
+
+TEST(HdrHistogramTest, LargeValuesStayWithinPrecision) {
+    HdrHistogram::Config config;
+    config.significant_digits = 3;
+    HdrHistogram histogram(config);
+
+    // 1 us .. 10 ms in 1 us steps
+    for (uint64_t value = 1000; value <= 10000000; value += 1000) {
+        histogram.Record(value);
+    }
+
+    auto expect_close = [](uint64_t actual, double expected) { EXPECT_NEAR(static_cast<double>(actual), expected, expected * 1e-3) << expected; };
+    expect_close(histogram.GetValueAtPercentile(50), 5000000);
+    expect_close(histogram.GetValueAtPercentile(99), 9900000);
+    expect_close(histogram.GetValueAtPercentile(99.9), 9990000);
+    EXPECT_EQ(histogram.GetValueAtPercentile(100), 10000000);
+
+    auto snapshot = histogram.GetSnapshot();
+    expect_close(snapshot.p90, 9000000);
+    EXPECT_EQ(snapshot.max, 10000000);
+}
+
+TEST(HdrHistogramTest, ValuesAboveMaxAreClamped) {
+    HdrHistogram::Config config;
+    config.max_value = 1000000;
+    HdrHistogram histogram(config);
+
+    histogram.Record(10);
+    histogram.Record(5000000000);
+
+    EXPECT_EQ(histogram.GetCount(), 2);
+    EXPECT_EQ(histogram.GetMax(), 1000000);
+    EXPECT_EQ(histogram.GetValueAtPercentile(100), 1000000);
+}
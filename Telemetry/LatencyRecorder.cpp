@@ -0,0 +1,156 @@
+#include "LatencyRecorder.h"
+#include "Logging/Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace Telemetry {
+
+namespace {
+
+void append_row(std::string &out, const char *label, const HdrHistogram &histogram) {
+    HistogramSnapshot snapshot = histogram.GetSnapshot();
+    if (snapshot.count == 0) {
+        return;
+    }
+
+    char row[160];
+    int length = std::snprintf(row, sizeof(row), "  %-20s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", label,
+                               static_cast<unsigned long long>(snapshot.count), snapshot.mean / 1000.0, snapshot.p50 / 1000.0,
+                               snapshot.p90 / 1000.0, snapshot.p99 / 1000.0, snapshot.p999 / 1000.0, snapshot.max / 1000.0);
+    out.append(row, static_cast<size_t>(std::min<int>(length, sizeof(row) - 1)));
+}
+
+void append_header(std::string &out, const std::string &title) {
+    char row[160];
+    int length = std::snprintf(row, sizeof(row), "%s (us)\n  %-20s %10s %10s %10s %10s %10s %10s %10s\n", title.c_str(), "span", "count", "mean",
+                               "p50", "p90", "p99", "p99.9", "max");
+    out.append(row, static_cast<size_t>(std::min<int>(length, sizeof(row) - 1)));
+}
+
+} // namespace
+
+const char *GetSpanName(LatencySpan span) {
+    switch (span) {
+    case LatencySpan::EXCHANGE_TO_RECEIVE:
+        return "exchange_to_receive";
+    case LatencySpan::RECEIVE_TO_SEND:
+        return "receive_to_send";
+    case LatencySpan::IPC_TRANSIT:
+        return "ipc_transit";
+    case LatencySpan::PARSE:
+        return "parse";
+    case LatencySpan::BOOK_APPLY:
+        return "book_apply";
+    case LatencySpan::PUBLISH:
+        return "publish";
+    case LatencySpan::END_TO_END:
+        return "end_to_end";
+    default:
+        return "unknown";
+    }
+}
+
+LatencyRecorder::LatencyRecorder(const Config &config)
+    : config_(config), instruments_(std::make_unique<std::atomic<InstrumentLatency *>[]>(config.max_instruments)) {
+    for (auto &histogram : totals_) {
+        histogram = std::make_unique<HdrHistogram>(config_.histogram);
+    }
+    for (size_t i = 0; i < config_.max_instruments; ++i) {
+        instruments_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+LatencyRecorder::~LatencyRecorder() {
+    for (size_t i = 0; i < config_.max_instruments; ++i) {
+        delete instruments_[i].load(std::memory_order_relaxed);
+    }
+}
+
+bool LatencyRecorder::HasInstrument(ExchangeTypes::InstrumentId id) const {
+    return id >= config_.max_instruments || instruments_[id].load(std::memory_order_relaxed) != nullptr;
+}
+
+void LatencyRecorder::AddInstrument(ExchangeTypes::InstrumentId id, const std::string &name) {
+    if (HasInstrument(id)) {
+        return;
+    }
+
+    auto *instrument = new InstrumentLatency{name, {}};
+    for (auto &histogram : instrument->histograms) {
+        histogram = std::make_unique<HdrHistogram>(config_.histogram);
+    }
+    instruments_[id].store(instrument, std::memory_order_release);
+}
+
+void LatencyRecorder::Record(ExchangeTypes::InstrumentId id, LatencySpan span, uint64_t nanos) {
+    size_t index = static_cast<size_t>(span);
+    totals_[index]->Record(nanos);
+
+    if (id < config_.max_instruments) {
+        if (InstrumentLatency *instrument = instruments_[id].load(std::memory_order_relaxed)) {
+            instrument->histograms[index]->Record(nanos);
+        }
+    }
+}
+
+const HdrHistogram *LatencyRecorder::GetHistogram(ExchangeTypes::InstrumentId id, LatencySpan span) const {
+    if (id >= config_.max_instruments) {
+        return nullptr;
+    }
+    InstrumentLatency *instrument = instruments_[id].load(std::memory_order_acquire);
+    return instrument ? instrument->histograms[static_cast<size_t>(span)].get() : nullptr;
+}
+
+std::string LatencyRecorder::Dump() const {
+    std::string out;
+    append_header(out, "all instruments");
+    for (size_t span = 0; span < kLatencySpanCount; ++span) {
+        append_row(out, GetSpanName(static_cast<LatencySpan>(span)), *totals_[span]);
+    }
+
+    for (size_t id = 0; id < config_.max_instruments; ++id) {
+        InstrumentLatency *instrument = instruments_[id].load(std::memory_order_acquire);
+        if (!instrument) {
+            continue;
+        }
+        append_header(out, instrument->name);
+        for (size_t span = 0; span < kLatencySpanCount; ++span) {
+            append_row(out, GetSpanName(static_cast<LatencySpan>(span)), *instrument->histograms[span]);
+        }
+    }
+    return out;
+}
+
+LatencyReporter::LatencyReporter(const LatencyRecorder &recorder, std::chrono::milliseconds interval, ReportCallback callback)
+    : recorder_(recorder), interval_(interval), callback_(std::move(callback)) {
+    if (!callback_) {
+        callback_ = [](const std::string &report) {
+            std::istringstream lines(report);
+            for (std::string line; std::getline(lines, line);) {
+                LOG_INFO("{}", line);
+            }
+        };
+    }
+    thread_ = std::thread([this]() { Run(); });
+}
+
+LatencyReporter::~LatencyReporter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void LatencyReporter::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, interval_, [this]() { return stopping_; })) {
+        lock.unlock();
+        callback_(recorder_.Dump());
+        lock.lock();
+    }
+}
+
+} // namespace Telemetry
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "HdrHistogram.h"
+#include "Types/InstrumentRegistry.h"
+
+namespace Telemetry {
+
+// Stage-to-stage spans of the market data pipeline, from exchange
+// timestamp to BBO publication
+enum class LatencySpan : uint8_t {
+    EXCHANGE_TO_RECEIVE = 0, // exchange t -> websocket receipt (or local IPC receipt without an origin stamp)
+    RECEIVE_TO_SEND,         // websocket receipt -> IPC send
+    IPC_TRANSIT,             // IPC send -> IPCReceiver::ReadData
+    PARSE,                   // ReadData -> frame parsed by DataNormalization
+    BOOK_APPLY,              // frame parsed -> message applied to the orderbook
+    PUBLISH,                 // message applied -> BBO sent (or queued for conflation)
+    END_TO_END,              // websocket receipt (or local receipt) -> BBO sent
+    COUNT
+};
+
+constexpr size_t kLatencySpanCount = static_cast<size_t>(LatencySpan::COUNT);
+
+const char *GetSpanName(LatencySpan span);
+
+// Per-instrument HDR histograms of every LatencySpan, plus totals across
+// instruments. One thread records (the feed processing thread); snapshots
+// and dumps may be taken from any thread while it runs.
+class LatencyRecorder {
+  public:
+    struct Config {
+        size_t max_instruments = 256; // ids beyond this only count towards the totals
+        HdrHistogram::Config histogram;
+    };
+
+    LatencyRecorder() : LatencyRecorder(Config{}) {}
+    explicit LatencyRecorder(const Config &config);
+    ~LatencyRecorder();
+
+    LatencyRecorder(const LatencyRecorder &) = delete;
+    LatencyRecorder &operator=(const LatencyRecorder &) = delete;
+
+    // Writer side. Instruments must be added (allocating their histograms)
+    // before their spans are recorded per instrument.
+    bool HasInstrument(ExchangeTypes::InstrumentId id) const;
+    void AddInstrument(ExchangeTypes::InstrumentId id, const std::string &name);
+    void Record(ExchangeTypes::InstrumentId id, LatencySpan span, uint64_t nanos);
+
+    // Reader side; nullptr for instruments that were never added
+    const HdrHistogram *GetHistogram(ExchangeTypes::InstrumentId id, LatencySpan span) const;
+    const HdrHistogram &GetTotalHistogram(LatencySpan span) const { return *totals_[static_cast<size_t>(span)]; }
+
+    // Table of count, mean, p50/p90/p99/p99.9 and max in microseconds per
+    // span: the totals, then every instrument
+    std::string Dump() const;
+
+  private:
+    struct InstrumentLatency {
+        std::string name;
+        std::array<std::unique_ptr<HdrHistogram>, kLatencySpanCount> histograms;
+    };
+
+    Config config_;
+    std::array<std::unique_ptr<HdrHistogram>, kLatencySpanCount> totals_;
+
+    // Slots are published once with release and never replaced
+    std::unique_ptr<std::atomic<InstrumentLatency *>[]> instruments_;
+};
+
+// Hands LatencyRecorder::Dump() to a callback every interval from a
+// background thread; by default each line goes to LOG_INFO
+class LatencyReporter {
+  public:
+    using ReportCallback = std::function<void(const std::string &report)>;
+
+    LatencyReporter(const LatencyRecorder &recorder, std::chrono::milliseconds interval, ReportCallback callback = {});
+    ~LatencyReporter();
+
+    LatencyReporter(const LatencyReporter &) = delete;
+    LatencyReporter &operator=(const LatencyReporter &) = delete;
+
+  private:
+    void Run();
+
+    const LatencyRecorder &recorder_;
+    std::chrono::milliseconds interval_;
+    ReportCallback callback_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace Telemetry
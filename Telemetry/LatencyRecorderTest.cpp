@@ -0,0 +1,68 @@
+#include "LatencyRecorder.h"
+#include <gtest/gtest.h>
+
+using Telemetry::LatencyRecorder;
+using Telemetry::LatencySpan;
+
+TEST(LatencyRecorderTest, RecordsPerInstrumentAndTotals) {
+    LatencyRecorder recorder;
+    recorder.AddInstrument(0, "BTCUSD-PERP");
+    recorder.AddInstrument(1, "ETHUSD-PERP");
+
+    recorder.Record(0, LatencySpan::PARSE, 1000);
+    recorder.Record(0, LatencySpan::PARSE, 3000);
+    recorder.Record(1, LatencySpan::PARSE, 2000);
+    recorder.Record(1, LatencySpan::END_TO_END, 50000);
+    recorder.Record(7, LatencySpan::PARSE, 4000); // never added: totals only
+
+    ASSERT_NE(recorder.GetHistogram(0, LatencySpan::PARSE), nullptr);
+    EXPECT_EQ(recorder.GetHistogram(0, LatencySpan::PARSE)->GetCount(), 2);
+    EXPECT_EQ(recorder.GetHistogram(0, LatencySpan::PARSE)->GetMax(), 3000);
+    EXPECT_EQ(recorder.GetHistogram(1, LatencySpan::PARSE)->GetCount(), 1);
+    EXPECT_EQ(recorder.GetHistogram(0, LatencySpan::END_TO_END)->GetCount(), 0);
+    EXPECT_EQ(recorder.GetHistogram(7, LatencySpan::PARSE), nullptr);
+
+    EXPECT_EQ(recorder.GetTotalHistogram(LatencySpan::PARSE).GetCount(), 4);
+    EXPECT_EQ(recorder.GetTotalHistogram(LatencySpan::END_TO_END).GetCount(), 1);
+
+    std::string dump = recorder.Dump();
+    EXPECT_NE(dump.find("all instruments (us)"), std::string::npos);
+    EXPECT_NE(dump.find("BTCUSD-PERP (us)"), std::string::npos);
+    EXPECT_NE(dump.find("ETHUSD-PERP (us)"), std::string::npos);
+    EXPECT_NE(dump.find("end_to_end"), std::string::npos);
+    // Spans with no samples are left out
+    EXPECT_EQ(dump.find("ipc_transit"), std::string::npos);
+}
+
+TEST(LatencyRecorderTest, IdsBeyondCapacityOnlyCountInTotals) {
+    LatencyRecorder::Config config;
+    config.max_instruments = 2;
+    LatencyRecorder recorder(config);
+
+    EXPECT_TRUE(recorder.HasInstrument(5));
+    recorder.AddInstrument(5, "SOLUSD-PERP");
+    recorder.Record(5, LatencySpan::BOOK_APPLY, 100);
+
+    EXPECT_EQ(recorder.GetHistogram(5, LatencySpan::BOOK_APPLY), nullptr);
+    EXPECT_EQ(recorder.GetTotalHistogram(LatencySpan::BOOK_APPLY).GetCount(), 1);
+}
+
+TEST(LatencyRecorderTest, ReporterDumpsPeriodically) {
+    LatencyRecorder recorder;
+    recorder.AddInstrument(0, "BTCUSD-PERP");
+    recorder.Record(0, LatencySpan::PUBLISH, 1500);
+
+    std::mutex mutex;
+    std::vector<std::string> reports;
+    {
+        Telemetry::LatencyReporter reporter(recorder, std::chrono::milliseconds(5), [&](const std::string &report) {
+            std::lock_guard<std::mutex> lock(mutex);
+            reports.push_back(report);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_GE(reports.size(), 2);
+    EXPECT_NE(reports.back().find("publish"), std::string::npos);
+}
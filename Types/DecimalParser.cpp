@@ -0,0 +1,97 @@
+#include "DecimalParser.h"
+#include <bit>
+#include <cstring>
+
+namespace ExchangeTypes {
+
+namespace {
+
+static_assert(std::endian::native == std::endian::little, "SWAR digit parsing assumes the first character is the lowest byte");
+
+// True if all eight bytes are ASCII digits
+inline bool all_digits(uint64_t word) {
+    return ((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+// Value of eight ASCII digits, most significant first: pairs, then quads,
+// then the full number, with three multiplies instead of eight
+inline uint64_t eight_digits(uint64_t word) {
+    word -= 0x3030303030303030ULL;
+    word = (word * 10) + (word >> 8);
+    return (((word & 0x000000FF000000FFULL) * 0x000F424000000064ULL) + (((word >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL)) >> 32;
+}
+
+} // namespace
+
+bool ParseDecimal(std::string_view text, uint8_t decimals, int64_t &out) {
+    if (decimals > kMaxDecimalDigits) {
+        return false;
+    }
+
+    bool negative = !text.empty() && text.front() == '-';
+    if (negative) {
+        text.remove_prefix(1);
+    }
+
+    std::string_view integer = text;
+    std::string_view fraction;
+    size_t dot = text.find('.');
+    if (dot != std::string_view::npos) {
+        integer = text.substr(0, dot);
+        fraction = text.substr(dot + 1);
+    }
+
+    if (integer.empty() && fraction.empty()) {
+        return false;
+    }
+
+    // Digits past the requested precision must be zeros ("50126.000000" at 2)
+    if (fraction.size() > decimals) {
+        for (char c : fraction.substr(decimals)) {
+            if (c != '0') {
+                return false;
+            }
+        }
+        fraction = fraction.substr(0, decimals);
+    }
+
+    while (!integer.empty() && integer.front() == '0') {
+        integer.remove_prefix(1);
+    }
+
+    size_t num_digits = integer.size() + decimals;
+    if (num_digits > kMaxDecimalDigits) {
+        return false;
+    }
+
+    // Right-align integer digits, fraction digits and zero padding in three
+    // '0'-filled words, then validate and convert a word at a time
+    char digits[24];
+    std::memset(digits, '0', sizeof(digits));
+    char *start = digits + sizeof(digits) - num_digits;
+    std::memcpy(start, integer.data(), integer.size());
+    std::memcpy(start + integer.size(), fraction.data(), fraction.size());
+
+    uint64_t value = 0;
+    for (size_t offset = 0; offset < sizeof(digits); offset += 8) {
+        uint64_t word;
+        std::memcpy(&word, digits + offset, sizeof(word));
+        if (!all_digits(word)) {
+            return false;
+        }
+        value = value * 100000000 + eight_digits(word);
+    }
+
+    out = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    return true;
+}
+
+bool ParseDecimals(std::span<const std::string_view> texts, uint8_t decimals, std::span<int64_t> out) {
+    bool success = true;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        success &= ParseDecimal(texts[i], decimals, out[i]);
+    }
+    return success;
+}
+
+} // namespace ExchangeTypes
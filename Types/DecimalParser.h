@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace ExchangeTypes {
+
+// Fixed-point values carry at most this many significant digits, which keeps
+// every representable value inside int64_t without overflow checks
+constexpr size_t kMaxDecimalDigits = 18;
+
+// Exchange prices and sizes never use more than 8 decimals
+constexpr uint8_t kDefaultDecimals = 8;
+
+constexpr std::array<double, kMaxDecimalDigits + 1> kPowersOf10 = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+                                                                   1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+
+// Parses a plain decimal string ("50126.5", "-0.000100", "12") into
+// value * 10^decimals. Digits are validated and combined eight at a time
+// inside a 64-bit word (SWAR). The conversion is exact: it fails instead of
+// rounding when a non-zero digit lies beyond `decimals`, and on empty input,
+// exponents, stray characters or more than kMaxDecimalDigits digits.
+bool ParseDecimal(std::string_view text, uint8_t decimals, int64_t &out);
+
+// Converts texts[i] into out[i] for every i (out must be at least as long).
+// Returns false if any element fails; the other elements are still converted.
+bool ParseDecimals(std::span<const std::string_view> texts, uint8_t decimals, std::span<int64_t> out);
+
+// Fixed-point back to double; correctly rounded while |value| < 2^53
+inline double DecimalToDouble(int64_t value, uint8_t decimals) { return static_cast<double>(value) / kPowersOf10[decimals]; }
+
+// Double to the nearest fixed-point value; exact for values DecimalToDouble produced
+inline int64_t DoubleToDecimal(double value, uint8_t decimals) { return std::llround(value * kPowersOf10[decimals]); }
+
+} // namespace ExchangeTypes
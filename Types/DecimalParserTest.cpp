@@ -0,0 +1,81 @@
+#include "DecimalParser.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using ExchangeTypes::ParseDecimal;
+
+TEST(DecimalParserTest, ScalesToRequestedDecimals) {
+    int64_t value = 0;
+
+    ASSERT_TRUE(ParseDecimal("50126.500000", 2, value));
+    EXPECT_EQ(value, 5012650);
+
+    ASSERT_TRUE(ParseDecimal("0.000100", 6, value));
+    EXPECT_EQ(value, 100);
+
+    ASSERT_TRUE(ParseDecimal("3.279", 8, value));
+    EXPECT_EQ(value, 327900000);
+
+    ASSERT_TRUE(ParseDecimal("12", 0, value));
+    EXPECT_EQ(value, 12);
+
+    ASSERT_TRUE(ParseDecimal(".5", 1, value));
+    EXPECT_EQ(value, 5);
+
+    ASSERT_TRUE(ParseDecimal("7.", 3, value));
+    EXPECT_EQ(value, 7000);
+
+    ASSERT_TRUE(ParseDecimal("-1.25", 2, value));
+    EXPECT_EQ(value, -125);
+
+    ASSERT_TRUE(ParseDecimal("0", 8, value));
+    EXPECT_EQ(value, 0);
+}
+
+TEST(DecimalParserTest, LongInputsUseEveryWord) {
+    int64_t value = 0;
+
+    ASSERT_TRUE(ParseDecimal("1234567890.12345678", 8, value));
+    EXPECT_EQ(value, 123456789012345678);
+
+    ASSERT_TRUE(ParseDecimal("000000000000000000000042.1", 1, value));
+    EXPECT_EQ(value, 421);
+
+    ASSERT_TRUE(ParseDecimal("999999999999999999", 0, value));
+    EXPECT_EQ(value, 999999999999999999);
+
+    EXPECT_FALSE(ParseDecimal("9999999999999999999", 0, value));
+    EXPECT_FALSE(ParseDecimal("12345678901.1", 8, value));
+}
+
+TEST(DecimalParserTest, RejectsInexactAndMalformedInput) {
+    int64_t value = 0;
+
+    EXPECT_FALSE(ParseDecimal("100.25", 1, value));
+    EXPECT_TRUE(ParseDecimal("100.20", 1, value));
+
+    EXPECT_FALSE(ParseDecimal("", 2, value));
+    EXPECT_FALSE(ParseDecimal("-", 2, value));
+    EXPECT_FALSE(ParseDecimal(".", 2, value));
+    EXPECT_FALSE(ParseDecimal("1e5", 2, value));
+    EXPECT_FALSE(ParseDecimal("1.2.3", 4, value));
+    EXPECT_FALSE(ParseDecimal(" 1", 2, value));
+    EXPECT_FALSE(ParseDecimal("+1", 2, value));
+    EXPECT_FALSE(ParseDecimal("12a4", 2, value));
+    EXPECT_FALSE(ParseDecimal("1", 19, value));
+}
+
+TEST(DecimalParserTest, BatchConvertsEveryElement) {
+    std::vector<std::string_view> texts = {"50126.000000", "0.252000", "bad", "3.279000"};
+    std::vector<int64_t> values(texts.size());
+
+    EXPECT_FALSE(ExchangeTypes::ParseDecimals(texts, 6, values));
+    EXPECT_EQ(values[0], 50126000000);
+    EXPECT_EQ(values[1], 252000);
+    EXPECT_EQ(values[3], 3279000);
+
+    texts[2] = "1";
+    EXPECT_TRUE(ExchangeTypes::ParseDecimals(texts, 6, values));
+    EXPECT_EQ(values[2], 1000000);
+    EXPECT_EQ(ExchangeTypes::DecimalToDouble(values[1], 6), 0.252);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "InstrumentRegistry.h"
 #include "SharedTypes.h"
 #include <optional>
 #include <string>
@@ -39,6 +40,7 @@ struct BookDeltaData {
 
 struct BookSnapshotResult {
     std::string instrument_name;
+    InstrumentId instrument_id = kInvalidInstrumentId;
     std::string subscription;
     std::string channel;
     int depth;
@@ -47,6 +49,7 @@ struct BookSnapshotResult {
 
 struct BookDeltaResult {
     std::string instrument_name;
+    InstrumentId instrument_id = kInvalidInstrumentId;
     std::string subscription;
     std::string channel;
     int depth;
@@ -0,0 +1,23 @@
+#include "InstrumentRegistry.h"
+
+namespace ExchangeTypes {
+
+InstrumentId InstrumentRegistry::Intern(std::string_view name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    InstrumentId id = static_cast<InstrumentId>(names_.size());
+    names_.emplace_back(name);
+    decimals_.emplace_back();
+    ids_.emplace(names_.back(), id);
+    return id;
+}
+
+InstrumentId InstrumentRegistry::Find(std::string_view name) const {
+    auto it = ids_.find(name);
+    return it == ids_.end() ? kInvalidInstrumentId : it->second;
+}
+
+} // namespace ExchangeTypes
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "DecimalParser.h"
+
+namespace ExchangeTypes {
+
+using InstrumentId = uint32_t;
+
+constexpr InstrumentId kInvalidInstrumentId = std::numeric_limits<InstrumentId>::max();
+
+// Interns instrument names into dense ids (0, 1, 2, ...) so per-instrument
+// state can live in plain arrays indexed by id instead of string-keyed maps.
+// Ids are never reused and names returned by GetName stay valid for the
+// lifetime of the registry.
+class InstrumentRegistry {
+  public:
+    InstrumentId Intern(std::string_view name);
+    InstrumentId Find(std::string_view name) const;
+
+    const std::string &GetName(InstrumentId id) const { return names_[id]; }
+    size_t Size() const { return names_.size(); }
+
+    // Fixed-point precision of the instrument's prices and sizes, default
+    // kDefaultDecimals for both. false (and unchanged) above kMaxDecimalDigits.
+    // A value fits in kMaxDecimalDigits digits in all, so the integer part is
+    // limited to kMaxDecimalDigits - decimals digits (10 at the default 8).
+    bool SetDecimals(InstrumentId id, uint8_t price_decimals, uint8_t quantity_decimals) {
+        if (price_decimals > kMaxDecimalDigits || quantity_decimals > kMaxDecimalDigits) {
+            return false;
+        }
+        decimals_[id] = {price_decimals, quantity_decimals};
+        return true;
+    }
+    uint8_t GetPriceDecimals(InstrumentId id) const { return decimals_[id].price; }
+    uint8_t GetQuantityDecimals(InstrumentId id) const { return decimals_[id].quantity; }
+
+  private:
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    struct Decimals {
+        uint8_t price = kDefaultDecimals;
+        uint8_t quantity = kDefaultDecimals;
+    };
+
+    std::unordered_map<std::string, InstrumentId, NameHash, std::equal_to<>> ids_;
+    std::deque<std::string> names_;
+    std::vector<Decimals> decimals_;
+};
+
+} // namespace ExchangeTypes
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "DecimalParser.h"
+#include "InstrumentRegistry.h"
+#include "SharedTypes.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace ExchangeTypes {
+
+// Largest book subscription depth offered by the exchange (book.<ticker>.50)
+constexpr size_t kMaxNormalizedLevels = 50;
+constexpr size_t kMaxNormalizedTrades = 64;
+
+enum class TradeSide : uint8_t { UNKNOWN = 0, BUY = 1, SELL = 2 };
+
+// Prices and sizes are fixed-point: value * 10^price_decimals and
+// value * 10^quantity_decimals of the owning message
+struct NormalizedLevel {
+    int64_t price;
+    int64_t size;
+    uint32_t num_orders;
+};
+
+struct NormalizedTrade {
+    uint64_t trade_id;
+    uint64_t t; // Trade timestamp in milliseconds
+    int64_t price;
+    int64_t quantity;
+    TradeSide side;
+};
+
+// Flat, fixed-size form of a book snapshot, book delta or trade message with
+// prices and sizes already converted to fixed-point integers using the
+// instrument's decimals from the InstrumentRegistry. It holds no pointers into
+// the input and no heap memory, so it can be reused across messages, copied
+// with memcpy or placed in shared memory. Levels or trades beyond the fixed
+// capacity (the deepest book subscription crypto.com offers is 50 levels) are
+// dropped and flagged with truncated; such a message is incomplete and
+// FeedProcessing discards it.
+struct NormalizedMessage {
+    MessageHeader header;
+    InstrumentId instrument_id;
+    int64_t id;
+    int32_t code;
+    uint32_t depth;
+    uint8_t price_decimals;
+    uint8_t quantity_decimals;
+
+    // Book fields; pu is only set for deltas
+    uint64_t tt;
+    uint64_t t;
+    uint64_t u;
+    uint64_t pu;
+
+    uint32_t num_data; // elements in result.data
+    uint32_t num_bids;
+    uint32_t num_asks;
+    uint32_t num_trades;
+    bool truncated;
+
+    std::array<NormalizedLevel, kMaxNormalizedLevels> bids;
+    std::array<NormalizedLevel, kMaxNormalizedLevels> asks;
+    std::array<NormalizedTrade, kMaxNormalizedTrades> trades;
+
+    std::span<const NormalizedLevel> Bids() const { return std::span(bids).first(num_bids); }
+    std::span<const NormalizedLevel> Asks() const { return std::span(asks).first(num_asks); }
+    std::span<const NormalizedTrade> Trades() const { return std::span(trades).first(num_trades); }
+
+    double ToPrice(int64_t price) const { return DecimalToDouble(price, price_decimals); }
+    double ToQuantity(int64_t quantity) const { return DecimalToDouble(quantity, quantity_decimals); }
+
+    // Resets everything except the level/trade arrays, which are only read up
+    // to their counts
+    void Clear() {
+        header.type = MessageType::UNKNOWN;
+        instrument_id = kInvalidInstrumentId;
+        id = 0;
+        code = 0;
+        depth = 0;
+        price_decimals = quantity_decimals = kDefaultDecimals;
+        tt = t = u = pu = 0;
+        num_data = num_bids = num_asks = num_trades = 0;
+        truncated = false;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<NormalizedMessage>, "NormalizedMessage must stay flat");
+
+// Reusable list of NormalizedMessages parsed from one multi-message frame.
+// Records are kept across Clear(), so once the largest batch has been seen
+// parsing further batches does not allocate.
+class NormalizedBatch {
+  public:
+    NormalizedMessage &Append() {
+        if (size_ == messages_.size()) {
+            messages_.emplace_back();
+        }
+        return messages_[size_++];
+    }
+
+    void PopBack() { size_--; }
+    void AddFailed() { failed_++; }
+
+    void Clear() {
+        size_ = 0;
+        failed_ = 0;
+    }
+
+    size_t Size() const { return size_; }
+    bool Empty() const { return size_ == 0; }
+    size_t GetFailedCount() const { return failed_; }
+
+    const NormalizedMessage &operator[](size_t index) const { return messages_[index]; }
+    std::span<const NormalizedMessage> Messages() const { return std::span(messages_).first(size_); }
+
+  private:
+    std::vector<NormalizedMessage> messages_;
+    size_t size_ = 0;
+    size_t failed_ = 0;
+};
+
+} // namespace ExchangeTypes
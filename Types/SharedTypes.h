@@ -38,29 +38,4 @@ struct BaseResponse {
     int code;
 };
 
-// Helper functions to cast buffer to message types
-template <typename T> const T *CastToMessage(const MessageBuffer &buffer) {
-    if (buffer.size() < sizeof(MessageHeader)) {
-        return nullptr;
-    }
-
-    return reinterpret_cast<const T *>(buffer.data());
-}
-
-template <typename T> T *CastToMessage(MessageBuffer &buffer) {
-    if (buffer.size() < sizeof(MessageHeader)) {
-        return nullptr;
-    }
-
-    return reinterpret_cast<T *>(buffer.data());
-}
-
-inline MessageType GetMessageType(const MessageBuffer &buffer) {
-    if (buffer.size() < sizeof(MessageHeader)) {
-        return MessageType::UNKNOWN;
-    }
-    const MessageHeader *header = reinterpret_cast<const MessageHeader *>(buffer.data());
-    return header->type;
-}
-
 } // namespace ExchangeTypes
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace ExchangeTypes {
+
+// Snapshot of one instrument's trade-flow aggregates, published with its
+// BBO. Variances are sums of squared log returns over the window (not
+// annualized); scale by the window length as needed.
+struct TradeFlowStats {
+    uint64_t timestamp = 0;   // Last trade time in milliseconds
+    uint64_t trade_count = 0; // All trades seen, 0 if none yet
+    double last_price = 0;
+
+    // Rolling time window (TradeFlowAggregator::Config::window_ms)
+    uint32_t window_trades = 0;
+    double window_volume = 0;
+    double vwap = 0;
+    double signed_volume = 0;     // buy volume - sell volume
+    double imbalance = 0;         // signed_volume / window_volume, in [-1, 1]
+    double realized_variance = 0; // trade-to-trade returns
+
+    // Completed trade-count bars (Config::bar_trades trades each)
+    uint32_t num_bars = 0;
+    double bar_realized_variance = 0; // close-to-close returns between bars
+    double parkinson_variance = 0;    // high/low range estimator over bars
+};
+
+static_assert(std::is_trivially_copyable_v<TradeFlowStats>, "TradeFlowStats is sent as raw bytes");
+
+} // namespace ExchangeTypes
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "InstrumentRegistry.h"
 #include "SharedTypes.h"
 #include <string>
 #include <vector>
@@ -17,6 +18,7 @@ struct TradeData {
 
 struct TradeResult {
     std::string instrument_name;
+    InstrumentId instrument_id = kInvalidInstrumentId;
     std::string subscription;
     std::string channel;
     std::vector<TradeData> data;
@@ -0,0 +1,97 @@
+#include "WireFormat.h"
+#include <cstring>
+
+namespace ExchangeTypes {
+
+bool WireInstrument::SetName(std::string_view instrument) {
+    if (instrument.size() > kMaxWireInstrumentName) {
+        return false;
+    }
+    std::memset(name, 0, sizeof(name));
+    std::memcpy(name, instrument.data(), instrument.size());
+    name_length = static_cast<uint8_t>(instrument.size());
+    return true;
+}
+
+WireTradeFlow ToWire(const TradeFlowStats &stats) {
+    WireTradeFlow trade_flow;
+    trade_flow.timestamp = stats.timestamp;
+    trade_flow.trade_count = stats.trade_count;
+    trade_flow.last_price = stats.last_price;
+    trade_flow.window_trades = stats.window_trades;
+    trade_flow.num_bars = stats.num_bars;
+    trade_flow.window_volume = stats.window_volume;
+    trade_flow.vwap = stats.vwap;
+    trade_flow.signed_volume = stats.signed_volume;
+    trade_flow.imbalance = stats.imbalance;
+    trade_flow.realized_variance = stats.realized_variance;
+    trade_flow.bar_realized_variance = stats.bar_realized_variance;
+    trade_flow.parkinson_variance = stats.parkinson_variance;
+    return trade_flow;
+}
+
+TradeFlowStats FromWire(const WireTradeFlow &trade_flow) {
+    TradeFlowStats stats;
+    stats.timestamp = trade_flow.timestamp;
+    stats.trade_count = trade_flow.trade_count;
+    stats.last_price = trade_flow.last_price;
+    stats.window_trades = trade_flow.window_trades;
+    stats.num_bars = trade_flow.num_bars;
+    stats.window_volume = trade_flow.window_volume;
+    stats.vwap = trade_flow.vwap;
+    stats.signed_volume = trade_flow.signed_volume;
+    stats.imbalance = trade_flow.imbalance;
+    stats.realized_variance = trade_flow.realized_variance;
+    stats.bar_realized_variance = trade_flow.bar_realized_variance;
+    stats.parkinson_variance = trade_flow.parkinson_variance;
+    return stats;
+}
+
+size_t AppendWireMessage(const NormalizedMessage &msg, MessageBuffer &out) {
+    WireMarketMessage record{};
+    record.header.type = static_cast<WireType>(msg.header.type);
+    record.instrument_id = msg.instrument_id;
+    record.code = msg.code;
+    record.id = msg.id;
+    record.depth = msg.depth;
+    record.price_decimals = msg.price_decimals;
+    record.quantity_decimals = msg.quantity_decimals;
+    record.truncated = msg.truncated;
+    record.tt = msg.tt;
+    record.t = msg.t;
+    record.u = msg.u;
+    record.pu = msg.pu;
+    record.num_data = msg.num_data;
+    record.num_bids = static_cast<uint16_t>(msg.num_bids);
+    record.num_asks = static_cast<uint16_t>(msg.num_asks);
+    record.num_trades = static_cast<uint16_t>(msg.num_trades);
+    record.header.size = static_cast<uint32_t>(record.GetSize());
+
+    size_t offset = out.size();
+    out.resize(offset + record.header.size);
+    uint8_t *data = out.data() + offset;
+
+    std::memcpy(data, &record, sizeof(record));
+    data += sizeof(record);
+
+    // Field by field, so the records carry no struct padding
+    auto append_levels = [&data](std::span<const NormalizedLevel> levels) {
+        for (const auto &level : levels) {
+            WireLevel wire{level.price, level.size, level.num_orders};
+            std::memcpy(data, &wire, sizeof(wire));
+            data += sizeof(wire);
+        }
+    };
+    append_levels(msg.Bids());
+    append_levels(msg.Asks());
+
+    for (const auto &trade : msg.Trades()) {
+        WireTrade wire{trade.trade_id, trade.t, trade.price, trade.quantity, trade.side};
+        std::memcpy(data, &wire, sizeof(wire));
+        data += sizeof(wire);
+    }
+
+    return record.header.size;
+}
+
+} // namespace ExchangeTypes
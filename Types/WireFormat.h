@@ -0,0 +1,195 @@
+#pragma once
+
+#include "DecimalParser.h"
+#include "InstrumentRegistry.h"
+#include "NormalizedMessage.h"
+#include "SharedTypes.h"
+#include "TradeFlowTypes.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace ExchangeTypes {
+
+// Binary records sent between processes and written to journals. Every
+// record starts with a WireHeader and is packed (alignment 1, no implicit
+// padding), so it can be viewed in place at any offset of a receive buffer
+// or mapped file and is the same byte for byte on every build. Integers are
+// little-endian; prices and sizes are fixed-point with the decimals carried
+// in the record. Any layout change must bump kWireVersion: readers reject
+// records of other versions rather than misread them.
+constexpr uint16_t kWireMagic = 0x4346; // "FC"
+constexpr uint8_t kWireVersion = 1;
+
+static_assert(std::endian::native == std::endian::little, "Wire records are little-endian");
+
+// Market data types share MessageType's values
+enum class WireType : uint8_t { UNKNOWN = 0, BOOK_SNAPSHOT = 1, BOOK_DELTA_UPDATE = 2, TRADE = 3, BBO_UPDATE = 4, INSTRUMENT = 5 };
+
+constexpr size_t kMaxWireInstrumentName = 48;
+
+#pragma pack(push, 1)
+
+struct WireHeader {
+    uint16_t magic = kWireMagic;
+    uint8_t version = kWireVersion;
+    WireType type = WireType::UNKNOWN;
+    uint32_t size = 0; // whole record, header included
+};
+
+// Maps an InstrumentId to its name and decimals. Ids are local to the
+// publishing process, so a publisher sends this before the first record of
+// an instrument on every connection.
+struct WireInstrument {
+    static constexpr bool IsType(WireType type) { return type == WireType::INSTRUMENT; }
+
+    WireHeader header{kWireMagic, kWireVersion, WireType::INSTRUMENT, sizeof(WireInstrument)};
+    InstrumentId instrument_id = kInvalidInstrumentId;
+    uint8_t price_decimals = kDefaultDecimals;
+    uint8_t quantity_decimals = kDefaultDecimals;
+    uint8_t name_length = 0;
+    uint8_t reserved = 0;
+    char name[kMaxWireInstrumentName] = {};
+
+    size_t GetSize() const { return sizeof(WireInstrument); }
+    std::string_view GetName() const { return std::string_view(name, name_length); }
+
+    // Fails for names longer than kMaxWireInstrumentName
+    bool SetName(std::string_view instrument);
+};
+
+// TradeFlowStats without its alignment padding
+struct WireTradeFlow {
+    uint64_t timestamp = 0;
+    uint64_t trade_count = 0;
+    double last_price = 0;
+    uint32_t window_trades = 0;
+    uint32_t num_bars = 0;
+    double window_volume = 0;
+    double vwap = 0;
+    double signed_volume = 0;
+    double imbalance = 0;
+    double realized_variance = 0;
+    double bar_realized_variance = 0;
+    double parkinson_variance = 0;
+};
+
+struct WireBboUpdate {
+    static constexpr bool IsType(WireType type) { return type == WireType::BBO_UPDATE; }
+
+    WireHeader header{kWireMagic, kWireVersion, WireType::BBO_UPDATE, sizeof(WireBboUpdate)};
+    InstrumentId instrument_id = kInvalidInstrumentId;
+    uint8_t price_decimals = kDefaultDecimals;
+    uint8_t reserved[3] = {};
+    int64_t best_bid = 0; // fixed-point, 0 while the side is empty
+    int64_t best_ask = 0;
+    uint64_t sequence_number = 0;
+    uint64_t timestamp = 0;   // publish time, microseconds since the epoch
+    WireTradeFlow trade_flow; // trade_count == 0 unless trade flow is enabled
+
+    size_t GetSize() const { return sizeof(WireBboUpdate); }
+    double GetBestBid() const { return DecimalToDouble(best_bid, price_decimals); }
+    double GetBestAsk() const { return DecimalToDouble(best_ask, price_decimals); }
+};
+
+struct WireLevel {
+    int64_t price;
+    int64_t size;
+    uint32_t num_orders;
+};
+
+struct WireTrade {
+    uint64_t trade_id;
+    uint64_t t;
+    int64_t price;
+    int64_t quantity;
+    TradeSide side;
+};
+
+// A NormalizedMessage trimmed to its counts: the fixed part below is followed
+// by num_bids bids, num_asks asks (WireLevel) and num_trades trades (WireTrade)
+struct WireMarketMessage {
+    static constexpr bool IsType(WireType type) {
+        return type == WireType::BOOK_SNAPSHOT || type == WireType::BOOK_DELTA_UPDATE || type == WireType::TRADE;
+    }
+
+    WireHeader header;
+    InstrumentId instrument_id;
+    int32_t code;
+    int64_t id;
+    uint32_t depth;
+    uint8_t price_decimals;
+    uint8_t quantity_decimals;
+    uint8_t truncated;
+    uint8_t reserved;
+    uint64_t tt;
+    uint64_t t;
+    uint64_t u;
+    uint64_t pu;
+    uint32_t num_data;
+    uint16_t num_bids;
+    uint16_t num_asks;
+    uint16_t num_trades;
+    uint16_t reserved2;
+
+    size_t GetSize() const { return sizeof(WireMarketMessage) + (size_t{num_bids} + num_asks) * sizeof(WireLevel) + num_trades * sizeof(WireTrade); }
+
+    std::span<const WireLevel> Bids() const { return {reinterpret_cast<const WireLevel *>(this + 1), num_bids}; }
+    std::span<const WireLevel> Asks() const { return {Bids().data() + num_bids, num_asks}; }
+    std::span<const WireTrade> Trades() const { return {reinterpret_cast<const WireTrade *>(Asks().data() + num_asks), num_trades}; }
+
+    double ToPrice(int64_t price) const { return DecimalToDouble(price, price_decimals); }
+    double ToQuantity(int64_t quantity) const { return DecimalToDouble(quantity, quantity_decimals); }
+};
+
+#pragma pack(pop)
+
+// The layout is the protocol: these only change together with kWireVersion
+static_assert(sizeof(WireHeader) == 8 && sizeof(WireInstrument) == 64 && sizeof(WireTradeFlow) == 88 && sizeof(WireBboUpdate) == 136);
+static_assert(sizeof(WireLevel) == 20 && sizeof(WireTrade) == 33 && sizeof(WireMarketMessage) == 76);
+static_assert(offsetof(WireBboUpdate, best_bid) == 16 && offsetof(WireBboUpdate, trade_flow) == 48);
+static_assert(offsetof(WireMarketMessage, tt) == 32 && offsetof(WireMarketMessage, num_data) == 64);
+static_assert(alignof(WireBboUpdate) == 1 && alignof(WireMarketMessage) == 1 && alignof(WireLevel) == 1 && alignof(WireTrade) == 1);
+static_assert(std::is_trivially_copyable_v<WireInstrument> && std::is_trivially_copyable_v<WireBboUpdate> &&
+              std::is_trivially_copyable_v<WireMarketMessage> && std::is_trivially_copyable_v<WireLevel> && std::is_trivially_copyable_v<WireTrade>);
+static_assert(static_cast<uint8_t>(WireType::BOOK_SNAPSHOT) == static_cast<uint32_t>(MessageType::BOOK_SNAPSHOT) &&
+              static_cast<uint8_t>(WireType::BOOK_DELTA_UPDATE) == static_cast<uint32_t>(MessageType::BOOK_DELTA_UPDATE) &&
+              static_cast<uint8_t>(WireType::TRADE) == static_cast<uint32_t>(MessageType::TRADE));
+
+// Type of the record at the front of bytes, UNKNOWN if it has no valid
+// header (short, wrong magic or another version)
+inline WireType GetWireType(std::span<const uint8_t> bytes) {
+    if (bytes.size() < sizeof(WireHeader)) {
+        return WireType::UNKNOWN;
+    }
+    const auto *header = reinterpret_cast<const WireHeader *>(bytes.data());
+    if (header->magic != kWireMagic || header->version != kWireVersion) {
+        return WireType::UNKNOWN;
+    }
+    return header->type;
+}
+
+// Views the record at the front of bytes in place, or nullptr unless it is a
+// complete T of this version whose size agrees with its contents. bytes may
+// hold further records after it (header.size tells where the next starts).
+template <typename T> const T *ViewWire(std::span<const uint8_t> bytes) {
+    if (!T::IsType(GetWireType(bytes)) || bytes.size() < sizeof(T)) {
+        return nullptr;
+    }
+    const auto *record = reinterpret_cast<const T *>(bytes.data());
+    if (record->header.size > bytes.size() || record->header.size != record->GetSize()) {
+        return nullptr;
+    }
+    return record;
+}
+
+WireTradeFlow ToWire(const TradeFlowStats &stats);
+TradeFlowStats FromWire(const WireTradeFlow &trade_flow);
+
+// Appends msg as one WireMarketMessage record to out; returns its size
+size_t AppendWireMessage(const NormalizedMessage &msg, MessageBuffer &out);
+
+} // namespace ExchangeTypes
@@ -0,0 +1,140 @@
+#include "WireFormat.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace ExchangeTypes;
+
+namespace {
+
+NormalizedMessage make_delta() {
+    NormalizedMessage msg;
+    msg.Clear();
+    msg.header.type = MessageType::BOOK_DELTA_UPDATE;
+    msg.instrument_id = 7;
+    msg.depth = 10;
+    msg.price_decimals = 2;
+    msg.quantity_decimals = 4;
+    msg.u = 101;
+    msg.pu = 100;
+    msg.num_data = 1;
+    msg.bids[0] = {249950, 30000, 1};
+    msg.bids[1] = {249900, 0, 0};
+    msg.asks[0] = {250100, 20000, 2};
+    msg.num_bids = 2;
+    msg.num_asks = 1;
+    return msg;
+}
+
+} // namespace
+
+TEST(WireFormatTest, MarketMessageRoundTripsInPlace) {
+    NormalizedMessage msg = make_delta();
+    msg.trades[0] = {42, 1000, 250000, 5000, TradeSide::BUY};
+    msg.num_trades = 1;
+
+    MessageBuffer buffer;
+    size_t size = AppendWireMessage(msg, buffer);
+    EXPECT_EQ(size, sizeof(WireMarketMessage) + 3 * sizeof(WireLevel) + sizeof(WireTrade));
+    ASSERT_EQ(buffer.size(), size);
+
+    const auto *record = ViewWire<WireMarketMessage>(buffer);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->header.type, WireType::BOOK_DELTA_UPDATE);
+    EXPECT_EQ(record->instrument_id, 7);
+    EXPECT_EQ(record->u, 101);
+    EXPECT_EQ(record->pu, 100);
+
+    ASSERT_EQ(record->Bids().size(), 2);
+    ASSERT_EQ(record->Asks().size(), 1);
+    ASSERT_EQ(record->Trades().size(), 1);
+    EXPECT_EQ(record->Bids()[1].price, 249900);
+    EXPECT_DOUBLE_EQ(record->ToPrice(record->Asks()[0].price), 2501.0);
+    EXPECT_DOUBLE_EQ(record->ToQuantity(record->Asks()[0].size), 2.0);
+    EXPECT_EQ(record->Trades()[0].trade_id, 42);
+    EXPECT_EQ(record->Trades()[0].side, TradeSide::BUY);
+
+    // Serializing the same message again gives the same bytes
+    MessageBuffer again;
+    AppendWireMessage(msg, again);
+    EXPECT_EQ(again, buffer);
+}
+
+TEST(WireFormatTest, RecordsAreViewedAtAnyOffset) {
+    // Journal-style: records back to back after an odd-sized prefix
+    MessageBuffer journal(3, 0xff);
+    AppendWireMessage(make_delta(), journal);
+
+    WireBboUpdate bbo;
+    bbo.instrument_id = 7;
+    bbo.price_decimals = 2;
+    bbo.best_bid = 249950;
+    bbo.best_ask = 250100;
+    bbo.sequence_number = 101;
+    size_t offset = journal.size();
+    journal.resize(offset + sizeof(bbo));
+    std::memcpy(journal.data() + offset, &bbo, sizeof(bbo));
+
+    std::span<const uint8_t> bytes(journal);
+    bytes = bytes.subspan(3);
+
+    const auto *delta = ViewWire<WireMarketMessage>(bytes);
+    ASSERT_NE(delta, nullptr);
+    EXPECT_EQ(delta->Bids()[0].size, 30000);
+    EXPECT_EQ(ViewWire<WireBboUpdate>(bytes), nullptr);
+
+    bytes = bytes.subspan(delta->header.size);
+    const auto *view = ViewWire<WireBboUpdate>(bytes);
+    ASSERT_NE(view, nullptr);
+    EXPECT_EQ(view->sequence_number, 101);
+    EXPECT_DOUBLE_EQ(view->GetBestBid(), 2499.5);
+    EXPECT_DOUBLE_EQ(view->GetBestAsk(), 2501.0);
+}
+
+TEST(WireFormatTest, RejectsForeignAndIncompleteRecords) {
+    MessageBuffer buffer;
+    AppendWireMessage(make_delta(), buffer);
+
+    // Truncated
+    EXPECT_EQ(ViewWire<WireMarketMessage>(std::span<const uint8_t>(buffer).first(buffer.size() - 1)), nullptr);
+    EXPECT_EQ(GetWireType(std::span<const uint8_t>(buffer).first(4)), WireType::UNKNOWN);
+
+    // Another version
+    MessageBuffer other = buffer;
+    reinterpret_cast<WireHeader *>(other.data())->version = kWireVersion + 1;
+    EXPECT_EQ(GetWireType(other), WireType::UNKNOWN);
+    EXPECT_EQ(ViewWire<WireMarketMessage>(other), nullptr);
+
+    // Counts that disagree with the header size
+    other = buffer;
+    reinterpret_cast<WireMarketMessage *>(other.data())->num_asks = 2;
+    EXPECT_EQ(ViewWire<WireMarketMessage>(other), nullptr);
+}
+
+TEST(WireFormatTest, InstrumentAndTradeFlow) {
+    WireInstrument instrument;
+    instrument.instrument_id = 3;
+    ASSERT_TRUE(instrument.SetName("BTCUSD-PERP"));
+    EXPECT_FALSE(instrument.SetName(std::string(kMaxWireInstrumentName + 1, 'X')));
+
+    std::span<const uint8_t> bytes(reinterpret_cast<const uint8_t *>(&instrument), sizeof(instrument));
+    const auto *view = ViewWire<WireInstrument>(bytes);
+    ASSERT_NE(view, nullptr);
+    EXPECT_EQ(view->GetName(), "BTCUSD-PERP");
+    EXPECT_EQ(view->instrument_id, 3);
+
+    TradeFlowStats stats;
+    stats.trade_count = 3;
+    stats.window_trades = 2;
+    stats.vwap = 2500.5;
+    stats.num_bars = 1;
+    stats.parkinson_variance = 1e-6;
+
+    TradeFlowStats back = FromWire(ToWire(stats));
+    EXPECT_EQ(back.trade_count, 3);
+    EXPECT_EQ(back.window_trades, 2);
+    EXPECT_EQ(back.vwap, 2500.5);
+    EXPECT_EQ(back.num_bars, 1);
+    EXPECT_EQ(back.parkinson_variance, 1e-6);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <variant>
+
+#include "Data.h"
+#include "Orderbook.h"
+#include "SmallOrderbook.h"
+#include "TickLadderOrderbook.h"
+
+// Depth of the exchange book subscription (book.<ticker>.10)
+constexpr size_t kSubscriptionDepth = 10;
+
+enum class OrderbookKind : uint8_t {
+    VECTOR = 0,      // Orderbook: unbounded depth, depth analytics
+    TICK_LADDER = 1, // TickLadderOrderbook: O(1) level updates, needs tick_size > 0
+    SMALL = 2,       // SmallOrderbook<kSubscriptionDepth>: inline, no heap
+};
+
+struct OrderbookConfig {
+    OrderbookKind kind = OrderbookKind::VECTOR;
+    Price tick_size = 0;
+
+    // A tick ladder divides every price by tick_size
+    bool IsValid() const { return kind != OrderbookKind::TICK_LADDER || (tick_size > 0 && std::isfinite(tick_size)); }
+};
+
+// Holds one of the book engines inline and forwards the common update/BBO
+// interface, so the engine can be chosen per instrument at runtime.
+class AnyOrderbook {
+  public:
+    using Variant = std::variant<Orderbook, TickLadderOrderbook, SmallOrderbook<kSubscriptionDepth>>;
+
+    // An invalid config (see OrderbookConfig::IsValid) gets the VECTOR engine
+    explicit AnyOrderbook(const OrderbookConfig &config = {}) : book_(make_book(config)) {}
+
+    void UpdateBid(Price price, Volume new_volume) {
+        std::visit([&](auto &book) { book.UpdateBid(price, new_volume); }, book_);
+    }
+
+    void UpdateAsk(Price price, Volume new_volume) {
+        std::visit([&](auto &book) { book.UpdateAsk(price, new_volume); }, book_);
+    }
+
+    void LoadSnapshot(std::span<const BookUpdate> bids, std::span<const BookUpdate> asks) {
+        std::visit([&](auto &book) { book.LoadSnapshot(bids, asks); }, book_);
+    }
+
+    void PrintBbo() {
+        std::visit([](auto &book) { book.PrintBbo(); }, book_);
+    }
+
+    std::pair<Price, Price> ReturnBbo() {
+        return std::visit([](auto &book) { return book.ReturnBbo(); }, book_);
+    }
+
+    size_t GetTopLevels(Side side, std::span<BookUpdate> out) const {
+        return std::visit([&](const auto &book) { return book.GetTopLevels(side, out); }, book_);
+    }
+
+    OrderbookKind GetKind() const { return static_cast<OrderbookKind>(book_.index()); }
+
+    template <typename T> T *GetIf() { return std::get_if<T>(&book_); }
+    template <typename T> const T *GetIf() const { return std::get_if<T>(&book_); }
+
+  private:
+    static Variant make_book(const OrderbookConfig &config) {
+        switch (config.IsValid() ? config.kind : OrderbookKind::VECTOR) {
+        case OrderbookKind::TICK_LADDER:
+            return Variant(std::in_place_type<TickLadderOrderbook>, config.tick_size);
+        case OrderbookKind::SMALL:
+            return Variant(std::in_place_type<SmallOrderbook<kSubscriptionDepth>>);
+        case OrderbookKind::VECTOR:
+        default:
+            return Variant(std::in_place_type<Orderbook>);
+        }
+    }
+
+    Variant book_;
+};
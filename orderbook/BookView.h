@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Data.h"
+#include "Seqlock.h"
+
+// Fixed-size copy of the top of a book, cheap enough to publish on every update
+template <size_t Depth> struct DepthSnapshot {
+    uint64_t sequence_number = 0;
+    uint64_t timestamp = 0;
+    uint32_t num_bids = 0;
+    uint32_t num_asks = 0;
+    std::array<BookUpdate, Depth> bids{};
+    std::array<BookUpdate, Depth> asks{};
+
+    Price BestBid() const { return num_bids == 0 ? 0 : bids[0].price; }
+    Price BestAsk() const { return num_asks == 0 ? 0 : asks[0].price; }
+};
+
+constexpr size_t kBookViewDepth = 10;
+
+using BookViewSnapshot = DepthSnapshot<kBookViewDepth>;
+
+// Versioned top-of-book and top-N view of one instrument. The feed thread
+// publishes into it after every applied update; any number of other threads
+// can Load() a consistent snapshot without locks or stalling the writer.
+using BookView = Seqlock<BookViewSnapshot>;
+
+// Works with any book exposing GetTopLevels(Side, std::span<BookUpdate>)
+template <typename Book, size_t Depth> void FillDepthSnapshot(const Book &book, uint64_t sequence_number, uint64_t timestamp, DepthSnapshot<Depth> &out) {
+    out.sequence_number = sequence_number;
+    out.timestamp = timestamp;
+    out.num_bids = static_cast<uint32_t>(book.GetTopLevels(Side::BID, std::span<BookUpdate>(out.bids)));
+    out.num_asks = static_cast<uint32_t>(book.GetTopLevels(Side::ASK, std::span<BookUpdate>(out.asks)));
+}
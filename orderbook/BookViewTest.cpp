@@ -0,0 +1,77 @@
+#include "AnyOrderbook.h"
+#include "BookView.h"
+#include "Seqlock.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+
+TEST(BookViewTest, SeqlockStoreAndLoad) {
+    Seqlock<BookViewSnapshot> lock;
+    EXPECT_EQ(lock.GetVersion(), 0);
+
+    BookViewSnapshot snapshot;
+    snapshot.sequence_number = 42;
+    snapshot.num_bids = 1;
+    snapshot.bids[0] = {100.0, 2.0};
+    lock.Store(snapshot);
+
+    auto loaded = lock.Load();
+    EXPECT_EQ(lock.GetVersion(), 1);
+    EXPECT_EQ(loaded.sequence_number, 42);
+    EXPECT_EQ(loaded.BestBid(), 100.0);
+    EXPECT_EQ(loaded.BestAsk(), 0);
+}
+
+TEST(BookViewTest, FillDepthSnapshotFromEachEngine) {
+    for (auto kind : {OrderbookKind::VECTOR, OrderbookKind::TICK_LADDER, OrderbookKind::SMALL}) {
+        AnyOrderbook ob(OrderbookConfig{kind, 0.5});
+        ob.UpdateBid(100.0, 1);
+        ob.UpdateBid(99.5, 2);
+        ob.UpdateAsk(101.0, 3);
+
+        DepthSnapshot<4> snapshot;
+        FillDepthSnapshot(ob, 7, 1000, snapshot);
+
+        EXPECT_EQ(snapshot.sequence_number, 7);
+        EXPECT_EQ(snapshot.num_bids, 2);
+        EXPECT_EQ(snapshot.num_asks, 1);
+        EXPECT_EQ(snapshot.bids[1].price, 99.5);
+        EXPECT_EQ(snapshot.bids[1].volume, 2);
+        EXPECT_EQ(snapshot.asks[0].price, 101.0);
+    }
+}
+
+TEST(BookViewTest, ReadersNeverSeeTornSnapshots) {
+    BookView view;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+
+    std::thread reader([&]() {
+        while (!done.load()) {
+            BookViewSnapshot snapshot;
+            if (!view.TryLoad(snapshot)) {
+                continue;
+            }
+            for (const auto &level : snapshot.bids) {
+                if (level.price != static_cast<Price>(snapshot.sequence_number)) {
+                    torn++;
+                }
+            }
+        }
+    });
+
+    BookViewSnapshot snapshot;
+    for (uint64_t i = 1; i <= 200000; ++i) {
+        snapshot.sequence_number = i;
+        for (auto &level : snapshot.bids) {
+            level.price = static_cast<Price>(i);
+        }
+        view.Store(snapshot);
+    }
+
+    done.store(true);
+    reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(view.Load().sequence_number, 200000);
+}
@@ -0,0 +1,126 @@
+#include "DepthHistory.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "SmallOrderbook.h"
+
+DepthHistory::DepthHistory(const Config &config)
+    : changes_(config.change_capacity), keyframes_(config.keyframe_capacity), bbos_(config.bbo_capacity),
+      keyframe_interval_(std::max<size_t>(config.keyframe_interval, 1)) {}
+
+bool DepthHistory::NeedsKeyframe(uint64_t sequence_number, uint64_t timestamp) const {
+    constexpr uint64_t kMaxDelta = std::numeric_limits<uint32_t>::max();
+
+    return !has_keyframe_ || changes_since_keyframe_ >= keyframe_interval_ || sequence_number - keyframe_sequence_ > kMaxDelta ||
+           (timestamp > keyframe_timestamp_ && timestamp - keyframe_timestamp_ > kMaxDelta);
+}
+
+void DepthHistory::push_keyframe(const Keyframe &keyframe) {
+    keyframes_.Push(keyframe);
+    has_keyframe_ = true;
+    keyframe_sequence_ = keyframe.book.sequence_number;
+    keyframe_timestamp_ = keyframe.book.timestamp;
+    changes_since_keyframe_ = 0;
+}
+
+void DepthHistory::RecordChange(Side side, Price price, Volume volume, uint64_t sequence_number, uint64_t timestamp) {
+    if (!has_keyframe_ || sequence_number < keyframe_sequence_) {
+        return;
+    }
+
+    ChangeRecord record;
+    record.sequence_delta = static_cast<uint32_t>(sequence_number - keyframe_sequence_);
+    record.timestamp_delta = timestamp > keyframe_timestamp_ ? static_cast<uint32_t>(timestamp - keyframe_timestamp_) : 0;
+    record.price = side == Side::BID ? price : -1 * price;
+    record.volume = volume;
+
+    changes_.Push(record);
+    changes_since_keyframe_++;
+}
+
+void DepthHistory::RecordBbo(Price best_bid, Price best_ask, uint64_t sequence_number, uint64_t timestamp) {
+    bbos_.Push({sequence_number, timestamp, best_bid, best_ask});
+}
+
+bool DepthHistory::GetBookAt(uint64_t sequence_number, HistorySnapshot &out) const {
+    // Newest keyframe at or before the requested sequence
+    uint64_t keyframe_head = keyframes_.GetHead();
+    uint64_t keyframe_tail = keyframes_.GetTail();
+
+    Keyframe keyframe;
+    uint64_t keyframe_index = keyframe_head;
+    for (uint64_t i = keyframe_head; i > keyframe_tail; --i) {
+        if (!keyframes_.TryRead(i - 1, keyframe)) {
+            return false;
+        }
+        if (keyframe.book.sequence_number <= sequence_number) {
+            keyframe_index = i - 1;
+            break;
+        }
+    }
+
+    if (keyframe_index == keyframe_head) {
+        return false;
+    }
+
+    // Changes up to the next keyframe are encoded against this one
+    uint64_t change_end = changes_.GetHead();
+    Keyframe next_keyframe;
+    if (keyframes_.TryRead(keyframe_index + 1, next_keyframe)) {
+        change_end = next_keyframe.first_change;
+    }
+
+    SmallOrderbook<kHistoryDepth> book;
+    book.LoadSnapshot(std::span(keyframe.book.bids).first(keyframe.book.num_bids), std::span(keyframe.book.asks).first(keyframe.book.num_asks));
+
+    uint64_t applied_sequence = keyframe.book.sequence_number;
+    uint64_t applied_timestamp = keyframe.book.timestamp;
+
+    for (uint64_t i = keyframe.first_change; i < change_end; ++i) {
+        ChangeRecord record;
+        if (!changes_.TryRead(i, record)) {
+            return false;
+        }
+
+        uint64_t change_sequence = keyframe.book.sequence_number + record.sequence_delta;
+        if (change_sequence > sequence_number) {
+            break;
+        }
+
+        if (record.price < 0) {
+            book.UpdateAsk(-1 * record.price, record.volume);
+        } else {
+            book.UpdateBid(record.price, record.volume);
+        }
+        applied_sequence = change_sequence;
+        applied_timestamp = keyframe.book.timestamp + record.timestamp_delta;
+    }
+
+    FillDepthSnapshot(book, applied_sequence, applied_timestamp, out);
+    return true;
+}
+
+size_t DepthHistory::GetBboSeries(uint64_t window_ms, std::vector<BboPoint> &out) const {
+    out.clear();
+
+    uint64_t head = bbos_.GetHead();
+    uint64_t tail = bbos_.GetTail();
+
+    BboPoint point;
+    uint64_t newest_timestamp = 0;
+    for (uint64_t i = head; i > tail; --i) {
+        if (!bbos_.TryRead(i - 1, point)) {
+            break;
+        }
+        if (i == head) {
+            newest_timestamp = point.timestamp;
+        } else if (point.timestamp + window_ms < newest_timestamp) {
+            break;
+        }
+        out.push_back(point);
+    }
+
+    std::reverse(out.begin(), out.end());
+    return out.size();
+}
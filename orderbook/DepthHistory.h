@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BookView.h"
+#include "Data.h"
+#include "SharedRing.h"
+
+constexpr size_t kHistoryDepth = 20;
+
+using HistorySnapshot = DepthSnapshot<kHistoryDepth>;
+
+struct BboPoint {
+    uint64_t sequence_number;
+    uint64_t timestamp;
+    Price best_bid;
+    Price best_ask;
+};
+
+// Bounded history of one instrument's book. Level changes are stored as
+// 24-byte records delta-encoded against the most recent keyframe (a top-N
+// copy of the book), so "book as of sequence u" is the nearest keyframe plus
+// a short replay. A separate ring keeps the BBO after every update.
+//
+// Written by the feed thread only; the query methods may run on any thread
+// concurrently with the writer and fail (return false / stop early) once the
+// requested range has been overwritten.
+class DepthHistory {
+  public:
+    struct Config {
+        size_t change_capacity = 4096;
+        size_t keyframe_capacity = 64;
+        size_t keyframe_interval = 256; // level changes between keyframes
+        size_t bbo_capacity = 4096;
+    };
+
+    DepthHistory() : DepthHistory(Config{}) {}
+    explicit DepthHistory(const Config &config);
+
+    // Whether the writer must record a keyframe (of the book as it stands,
+    // before applying update u) so that changes for u stay delta-encodable.
+    bool NeedsKeyframe(uint64_t sequence_number, uint64_t timestamp) const;
+
+    template <typename Book> void RecordKeyframe(const Book &book, uint64_t sequence_number, uint64_t timestamp) {
+        Keyframe keyframe;
+        keyframe.first_change = changes_.GetHead();
+        FillDepthSnapshot(book, sequence_number, timestamp, keyframe.book);
+        push_keyframe(keyframe);
+    }
+
+    void RecordChange(Side side, Price price, Volume volume, uint64_t sequence_number, uint64_t timestamp);
+    void RecordBbo(Price best_bid, Price best_ask, uint64_t sequence_number, uint64_t timestamp);
+
+    // Reconstructs the top kHistoryDepth levels as of the last update with
+    // sequence <= sequence_number. Levels that were deeper than kHistoryDepth
+    // at the keyframe are not recovered if the levels above them are removed.
+    bool GetBookAt(uint64_t sequence_number, HistorySnapshot &out) const;
+
+    // BBO points from the last window_ms (exchange time) ending at the newest
+    // point, oldest first
+    size_t GetBboSeries(uint64_t window_ms, std::vector<BboPoint> &out) const;
+
+  private:
+    struct Keyframe {
+        uint64_t first_change; // index of the first change recorded after it
+        HistorySnapshot book;
+    };
+
+    struct ChangeRecord {
+        uint32_t sequence_delta;  // relative to the owning keyframe
+        uint32_t timestamp_delta; // relative to the owning keyframe
+        Price price;              // asks stored negated
+        Volume volume;
+    };
+
+    static_assert(sizeof(ChangeRecord) == 24, "ChangeRecord should stay compact");
+
+    void push_keyframe(const Keyframe &keyframe);
+
+    SharedRing<ChangeRecord> changes_;
+    SharedRing<Keyframe> keyframes_;
+    SharedRing<BboPoint> bbos_;
+    size_t keyframe_interval_;
+
+    // Writer-only state
+    bool has_keyframe_ = false;
+    uint64_t keyframe_sequence_ = 0;
+    uint64_t keyframe_timestamp_ = 0;
+    uint64_t changes_since_keyframe_ = 0;
+};
@@ -0,0 +1,113 @@
+#include "DepthHistory.h"
+#include "Orderbook.h"
+#include "SharedRing.h"
+#include <gtest/gtest.h>
+
+TEST(DepthHistoryTest, SharedRingDetectsOverwrittenRecords) {
+    SharedRing<uint64_t> ring(4);
+    for (uint64_t i = 0; i < 6; ++i) {
+        ring.Push(i * 10);
+    }
+
+    uint64_t value = 0;
+    EXPECT_EQ(ring.GetHead(), 6);
+    EXPECT_FALSE(ring.TryRead(1, value));
+    EXPECT_FALSE(ring.TryRead(6, value));
+    EXPECT_TRUE(ring.TryRead(5, value));
+    EXPECT_EQ(value, 50);
+}
+
+TEST(DepthHistoryTest, BookAsOfSequence) {
+    DepthHistory history;
+    Orderbook book;
+
+    std::vector<BookUpdate> bids = {{100.0, 1}, {99.0, 2}};
+    std::vector<BookUpdate> asks = {{101.0, 3}};
+    book.LoadSnapshot(bids, asks);
+    history.RecordKeyframe(book, 10, 1000);
+
+    // u=11: new best bid
+    ASSERT_FALSE(history.NeedsKeyframe(11, 1001));
+    book.UpdateBid(100.5, 4);
+    history.RecordChange(Side::BID, 100.5, 4, 11, 1001);
+
+    // u=12: best ask removed, deeper ask added
+    book.UpdateAsk(101.0, 0);
+    history.RecordChange(Side::ASK, 101.0, 0, 12, 1002);
+    book.UpdateAsk(102.0, 5);
+    history.RecordChange(Side::ASK, 102.0, 5, 12, 1002);
+
+    HistorySnapshot snapshot;
+    ASSERT_TRUE(history.GetBookAt(10, snapshot));
+    EXPECT_EQ(snapshot.sequence_number, 10);
+    EXPECT_EQ(snapshot.BestBid(), 100.0);
+    EXPECT_EQ(snapshot.BestAsk(), 101.0);
+
+    ASSERT_TRUE(history.GetBookAt(11, snapshot));
+    EXPECT_EQ(snapshot.BestBid(), 100.5);
+    EXPECT_EQ(snapshot.num_bids, 3);
+    EXPECT_EQ(snapshot.BestAsk(), 101.0);
+
+    ASSERT_TRUE(history.GetBookAt(50, snapshot));
+    EXPECT_EQ(snapshot.sequence_number, 12);
+    EXPECT_EQ(snapshot.timestamp, 1002);
+    EXPECT_EQ(snapshot.BestAsk(), 102.0);
+    EXPECT_EQ(snapshot.num_asks, 1);
+
+    EXPECT_FALSE(history.GetBookAt(9, snapshot));
+}
+
+TEST(DepthHistoryTest, ReplayStopsAtNextKeyframe) {
+    DepthHistory::Config config;
+    config.keyframe_interval = 1;
+    DepthHistory history(config);
+    Orderbook book;
+
+    history.RecordKeyframe(book, 1, 0);
+    for (uint64_t u = 2; u <= 5; ++u) {
+        if (history.NeedsKeyframe(u, u)) {
+            history.RecordKeyframe(book, u - 1, u - 1);
+        }
+        book.UpdateBid(100.0 + u, 1);
+        history.RecordChange(Side::BID, 100.0 + u, 1, u, u);
+    }
+
+    HistorySnapshot snapshot;
+    for (uint64_t u = 2; u <= 5; ++u) {
+        ASSERT_TRUE(history.GetBookAt(u, snapshot));
+        EXPECT_EQ(snapshot.BestBid(), 100.0 + u);
+        EXPECT_EQ(snapshot.num_bids, u - 1);
+    }
+}
+
+TEST(DepthHistoryTest, OverwrittenHistoryIsReportedMissing) {
+    DepthHistory::Config config;
+    config.change_capacity = 4;
+    config.keyframe_interval = 1000;
+    DepthHistory history(config);
+    Orderbook book;
+
+    history.RecordKeyframe(book, 1, 0);
+    for (uint64_t u = 2; u < 10; ++u) {
+        history.RecordChange(Side::BID, 100.0 + u, 1, u, u);
+    }
+
+    HistorySnapshot snapshot;
+    EXPECT_FALSE(history.GetBookAt(9, snapshot));
+}
+
+TEST(DepthHistoryTest, BboSeriesWindow) {
+    DepthHistory history;
+    history.RecordBbo(100.0, 101.0, 1, 1000);
+    history.RecordBbo(100.5, 101.0, 2, 1400);
+    history.RecordBbo(100.5, 100.75, 3, 1900);
+    history.RecordBbo(100.25, 100.75, 4, 2000);
+
+    std::vector<BboPoint> series;
+    EXPECT_EQ(history.GetBboSeries(600, series), 3);
+    EXPECT_EQ(series.front().sequence_number, 2);
+    EXPECT_EQ(series.back().best_bid, 100.25);
+
+    EXPECT_EQ(history.GetBboSeries(0, series), 1);
+    EXPECT_EQ(series[0].sequence_number, 4);
+}
@@ -0,0 +1,289 @@
+#include "AnyOrderbook.h"
+#include "Orderbook.h"
+#include "SmallOrderbook.h"
+#include "TickLadderOrderbook.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Book engine comparison under synthetic but exchange-shaped update streams.
+// Every benchmark is instantiated per engine; to compare a new engine, add a
+// make_book overload and one BENCHMARK_TEMPLATE line per pattern.
+//
+//   bazel run -c opt //Orderbook:OrderbookBenchmark
+//
+// Besides ns/op, each benchmark reports p50_ns/p99_ns (individually timed
+// operations after the main loop, timer overhead subtracted) and
+// cache_misses/op when perf events are available (Linux, perf_event_paranoid
+// permitting).
+
+namespace {
+
+using SmallBook = SmallOrderbook<kSubscriptionDepth>;
+
+constexpr Price kTickSize = 0.5;
+constexpr int64_t kMidTicks = 100000;
+constexpr size_t kStreamSize = 1 << 16;
+constexpr size_t kLatencySamples = 1 << 14;
+constexpr uint64_t kSeed = 42;
+
+struct Op {
+    uint32_t book;
+    Side side;
+    Price price;
+    Volume volume;
+};
+
+template <typename Book> Book make_book() { return Book(); }
+template <> TickLadderOrderbook make_book<TickLadderOrderbook>() { return TickLadderOrderbook(kTickSize); }
+
+// Level 0 is the touch; bids and asks never cross
+Price level_price(Side side, size_t level) {
+    int64_t ticks = side == Side::BID ? kMidTicks - 1 - static_cast<int64_t>(level) : kMidTicks + static_cast<int64_t>(level);
+    return static_cast<Price>(ticks) * kTickSize;
+}
+
+Volume random_volume(std::mt19937_64 &rng) { return std::uniform_int_distribution<int>(1, 400)(rng) / 100.0; }
+
+template <typename Book> void apply(Book &book, const Op &op) {
+    if (op.side == Side::BID) {
+        book.UpdateBid(op.price, op.volume);
+    } else {
+        book.UpdateAsk(op.price, op.volume);
+    }
+    benchmark::DoNotOptimize(book.ReturnBbo());
+}
+
+template <typename Book> void preload(Book &book, size_t levels, std::mt19937_64 &rng) {
+    for (size_t level = 0; level < levels; ++level) {
+        book.UpdateBid(level_price(Side::BID, level), random_volume(rng));
+        book.UpdateAsk(level_price(Side::ASK, level), random_volume(rng));
+    }
+}
+
+// Most traffic at the top three levels; the touch itself is emptied and
+// refilled so the best price moves, with occasional deeper updates.
+std::vector<Op> touch_heavy_stream(size_t num_books, std::mt19937_64 &rng) {
+    std::vector<Op> ops(kStreamSize);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::uniform_int_distribution<uint32_t> book(0, num_books - 1);
+
+    for (auto &op : ops) {
+        op.book = book(rng);
+        op.side = unit(rng) < 0.5 ? Side::BID : Side::ASK;
+        size_t level = unit(rng) < 0.9 ? std::uniform_int_distribution<size_t>(0, 2)(rng) : std::uniform_int_distribution<size_t>(3, 49)(rng);
+        op.price = level_price(op.side, level);
+        op.volume = unit(rng) < 0.15 ? 0 : random_volume(rng);
+    }
+    return ops;
+}
+
+// Uniform updates across a deep book, a third of them deletes
+std::vector<Op> deep_churn_stream(size_t depth, std::mt19937_64 &rng) {
+    std::vector<Op> ops(kStreamSize);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::uniform_int_distribution<size_t> level(0, depth - 1);
+
+    for (auto &op : ops) {
+        op.book = 0;
+        op.side = unit(rng) < 0.5 ? Side::BID : Side::ASK;
+        op.price = level_price(op.side, level(rng));
+        op.volume = unit(rng) < 0.33 ? 0 : random_volume(rng);
+    }
+    return ops;
+}
+
+class CacheMissCounter {
+  public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    CacheMissCounter(const CacheMissCounter &) = delete;
+    CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+    bool Available() const { return fd_ >= 0; }
+
+    void Start() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    uint64_t Stop() {
+        uint64_t count = 0;
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+                count = 0;
+            }
+        }
+#endif
+        return count;
+    }
+
+  private:
+    int fd_ = -1;
+};
+
+using Clock = std::chrono::steady_clock;
+
+int64_t elapsed_ns(Clock::time_point start, Clock::time_point end) { return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); }
+
+int64_t timer_overhead_ns() {
+    static const int64_t overhead = [] {
+        std::vector<int64_t> samples(kLatencySamples);
+        for (auto &sample : samples) {
+            auto start = Clock::now();
+            auto end = Clock::now();
+            sample = elapsed_ns(start, end);
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }();
+    return overhead;
+}
+
+// Runs the timed loop (one op per iteration) under the cache miss counter,
+// then times kLatencySamples ops individually for the percentiles.
+template <typename Fn> void run_ops(benchmark::State &state, Fn &&op) {
+    CacheMissCounter cache_misses;
+    size_t index = 0;
+
+    cache_misses.Start();
+    for (auto _ : state) {
+        op(index++);
+    }
+    uint64_t misses = cache_misses.Stop();
+
+    std::vector<int64_t> latencies(kLatencySamples);
+    int64_t overhead = timer_overhead_ns();
+    for (auto &latency : latencies) {
+        auto start = Clock::now();
+        op(index++);
+        auto end = Clock::now();
+        latency = std::max<int64_t>(elapsed_ns(start, end) - overhead, 0);
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    state.counters["p50_ns"] = static_cast<double>(latencies[latencies.size() / 2]);
+    state.counters["p99_ns"] = static_cast<double>(latencies[latencies.size() * 99 / 100]);
+    if (cache_misses.Available()) {
+        state.counters["cache_misses"] = benchmark::Counter(static_cast<double>(misses), benchmark::Counter::kAvgIterations);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Book> void BM_TouchHeavy(benchmark::State &state) {
+    std::mt19937_64 rng(kSeed);
+    Book book = make_book<Book>();
+    preload(book, 50, rng);
+    std::vector<Op> ops = touch_heavy_stream(1, rng);
+
+    run_ops(state, [&](size_t i) { apply(book, ops[i & (kStreamSize - 1)]); });
+}
+
+template <typename Book> void BM_DeepChurn(benchmark::State &state) {
+    size_t depth = static_cast<size_t>(state.range(0));
+    std::mt19937_64 rng(kSeed);
+    Book book = make_book<Book>();
+    preload(book, depth, rng);
+    std::vector<Op> ops = deep_churn_stream(depth, rng);
+
+    run_ops(state, [&](size_t i) { apply(book, ops[i & (kStreamSize - 1)]); });
+}
+
+// Full rebuild from exchange-ordered snapshots of range(0) levels per side
+template <typename Book> void BM_SnapshotRebuild(benchmark::State &state) {
+    constexpr size_t kSnapshots = 64;
+    size_t depth = static_cast<size_t>(state.range(0));
+    std::mt19937_64 rng(kSeed);
+    Book book = make_book<Book>();
+
+    std::vector<std::vector<BookUpdate>> bids(kSnapshots);
+    std::vector<std::vector<BookUpdate>> asks(kSnapshots);
+    for (size_t s = 0; s < kSnapshots; ++s) {
+        size_t shift = s % 4; // touch wanders a few ticks between snapshots
+        for (size_t level = 0; level < depth; ++level) {
+            bids[s].push_back({level_price(Side::BID, level + shift), random_volume(rng)});
+            asks[s].push_back({level_price(Side::ASK, level + shift), random_volume(rng)});
+        }
+    }
+
+    run_ops(state, [&](size_t i) {
+        size_t s = i % kSnapshots;
+        book.LoadSnapshot(bids[s], asks[s]);
+        benchmark::DoNotOptimize(book.ReturnBbo());
+    });
+}
+
+// Touch-heavy updates spread over range(0) books, as with a wide option chain
+template <typename Book> void BM_ManySmallBooks(benchmark::State &state) {
+    size_t num_books = static_cast<size_t>(state.range(0));
+    std::mt19937_64 rng(kSeed);
+    std::vector<Book> books;
+    books.reserve(num_books);
+    for (size_t b = 0; b < num_books; ++b) {
+        books.push_back(make_book<Book>());
+        preload(books.back(), kSubscriptionDepth, rng);
+    }
+    std::vector<Op> ops = touch_heavy_stream(num_books, rng);
+
+    run_ops(state, [&](size_t i) {
+        const Op &op = ops[i & (kStreamSize - 1)];
+        apply(books[op.book], op);
+    });
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_TouchHeavy, Orderbook);
+BENCHMARK_TEMPLATE(BM_TouchHeavy, TickLadderOrderbook);
+BENCHMARK_TEMPLATE(BM_TouchHeavy, SmallBook);
+
+BENCHMARK_TEMPLATE(BM_DeepChurn, Orderbook)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_DeepChurn, TickLadderOrderbook)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_DeepChurn, SmallBook)->Arg(100)->Arg(1000);
+
+BENCHMARK_TEMPLATE(BM_SnapshotRebuild, Orderbook)->Arg(10)->Arg(50)->Arg(400);
+BENCHMARK_TEMPLATE(BM_SnapshotRebuild, TickLadderOrderbook)->Arg(10)->Arg(50)->Arg(400);
+BENCHMARK_TEMPLATE(BM_SnapshotRebuild, SmallBook)->Arg(10)->Arg(50)->Arg(400);
+
+BENCHMARK_TEMPLATE(BM_ManySmallBooks, Orderbook)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_ManySmallBooks, TickLadderOrderbook)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_ManySmallBooks, SmallBook)->Arg(64)->Arg(1024);
+
+BENCHMARK_MAIN();
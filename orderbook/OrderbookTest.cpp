@@ -65,4 +65,102 @@ TEST(OrderbookTest, RemoveAsk) {
     auto bbo = ob.ReturnBbo();
 
     EXPECT_EQ(bbo.second, 101.0);
-}
\ No newline at end of file
+}
+
+TEST(OrderbookTest, RemoveMissingBidKeepsBook) {
+    Orderbook ob;
+    ob.UpdateBid(100.0, 5);
+    ob.UpdateBid(99.0, 5);
+    ob.UpdateBid(99.5, 0);
+
+    EXPECT_EQ(ob.GetDepth(Side::BID), 2);
+    EXPECT_EQ(ob.ReturnBbo().first, 100.0);
+}
+
+TEST(OrderbookTest, TopLevelsReturnPositiveAskPrices) {
+    Orderbook ob;
+    ob.UpdateAsk(101.0, 1);
+    ob.UpdateAsk(100.0, 2);
+    ob.UpdateAsk(102.0, 3);
+
+    std::vector<BookUpdate> levels;
+    EXPECT_EQ(ob.GetTopLevels(Side::ASK, 2, levels), 2);
+    EXPECT_EQ(levels[0].price, 100.0);
+    EXPECT_EQ(levels[0].volume, 2);
+    EXPECT_EQ(levels[1].price, 101.0);
+}
+
+TEST(OrderbookTest, CumulativeVolumeTracksUpdates) {
+    Orderbook ob;
+    ob.UpdateBid(100.0, 1);
+    ob.UpdateBid(99.0, 2);
+    ob.UpdateBid(98.0, 3);
+
+    EXPECT_EQ(ob.GetCumulativeVolume(Side::BID, 2), 6);
+    EXPECT_EQ(ob.GetTotalVolume(Side::BID), 6);
+
+    ob.UpdateBid(99.0, 5);
+    ob.UpdateBid(100.0, 0);
+
+    EXPECT_EQ(ob.GetCumulativeVolume(Side::BID, 0), 5);
+    EXPECT_EQ(ob.GetCumulativeVolume(Side::BID, 1), 8);
+    EXPECT_EQ(ob.GetTotalVolume(Side::BID), 8);
+}
+
+TEST(OrderbookTest, MicropriceAndImbalance) {
+    Orderbook ob;
+    ob.UpdateBid(100.0, 3);
+    ob.UpdateAsk(101.0, 1);
+
+    EXPECT_DOUBLE_EQ(ob.GetMicroprice(), (100.0 * 1 + 101.0 * 3) / 4);
+    EXPECT_DOUBLE_EQ(ob.GetImbalance(), 0.5);
+}
+
+TEST(OrderbookTest, VwapToNotional) {
+    Orderbook ob;
+    ob.UpdateAsk(100.0, 1);
+    ob.UpdateAsk(110.0, 1);
+
+    auto vwap = ob.GetVwapToNotional(Side::ASK, 155.0);
+    ASSERT_TRUE(vwap.has_value());
+    EXPECT_DOUBLE_EQ(*vwap, 155.0 / 1.5);
+
+    EXPECT_FALSE(ob.GetVwapToNotional(Side::ASK, 1000.0).has_value());
+
+    ob.UpdateAsk(105.0, 1);
+    vwap = ob.GetVwapToNotional(Side::ASK, 205.0);
+    ASSERT_TRUE(vwap.has_value());
+    EXPECT_DOUBLE_EQ(*vwap, 102.5);
+}
+
+TEST(OrderbookTest, LoadSnapshotReplacesBook) {
+    Orderbook ob;
+    ob.UpdateBid(105.0, 1);
+    ob.UpdateAsk(95.0, 1);
+
+    std::vector<BookUpdate> bids = {{100.0, 1}, {99.0, 2}, {98.0, 0}};
+    std::vector<BookUpdate> asks = {{101.0, 3}, {102.0, 4}};
+    ob.LoadSnapshot(bids, asks);
+
+    auto bbo = ob.ReturnBbo();
+    EXPECT_EQ(bbo.first, 100.0);
+    EXPECT_EQ(bbo.second, 101.0);
+    EXPECT_EQ(ob.GetDepth(Side::BID), 2);
+    EXPECT_EQ(ob.GetTotalVolume(Side::ASK), 7);
+    EXPECT_EQ(ob.GetCumulativeVolume(Side::ASK, 1), 7);
+}
+
+TEST(OrderbookTest, LoadSnapshotSortsUnorderedLevels) {
+    Orderbook ob;
+    std::vector<BookUpdate> bids = {{99.0, 2}, {100.0, 1}, {99.0, 5}};
+    std::vector<BookUpdate> asks = {{102.0, 4}, {101.0, 3}};
+    ob.LoadSnapshot(bids, asks);
+
+    std::vector<BookUpdate> levels;
+    ob.GetTopLevels(Side::BID, 10, levels);
+    ASSERT_EQ(levels.size(), 2);
+    EXPECT_EQ(levels[0].price, 100.0);
+    EXPECT_EQ(levels[1].volume, 5);
+    EXPECT_EQ(ob.GetTotalVolume(Side::BID), 6);
+    EXPECT_EQ(ob.ReturnBbo().second, 101.0);
+}
@@ -1,20 +1,11 @@
 #pragma once
 
-#include "Data.h"
-#include <string>
+#include "Types/WireFormat.h"
 
 namespace OrderbookTypes {
 
-struct BboUpdate {
-    std::string instrument_name;
-    Price best_bid;
-    Price best_ask;
-    uint64_t sequence_number;
-    uint64_t timestamp;
-
-    BboUpdate() = default;
-    BboUpdate(const std::string &instrument, Price bid, Price ask, uint64_t seq, uint64_t ts)
-        : instrument_name(instrument), best_bid(bid), best_ask(ask), sequence_number(seq), timestamp(ts) {}
-};
+// The BBO record FeedProcessing publishes: fixed-point prices keyed by
+// instrument id, sent as is over IPC (see Types/WireFormat.h)
+using BboUpdate = ExchangeTypes::WireBboUpdate;
 
 } // namespace OrderbookTypes
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer, multi-reader sequence lock around a trivially copyable value.
+// The writer never waits; readers copy the value and retry if the sequence
+// changed underneath them. The payload is copied as 64-bit words through
+// std::atomic_ref so concurrent reads and writes are not data races.
+template <typename T> class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock payload must be trivially copyable");
+
+  public:
+    Seqlock() { words_.fill(0); }
+
+    // Writer side; must only be called from one thread
+    void Store(const T &value) {
+        std::array<uint64_t, kWords> staged{};
+        std::memcpy(staged.data(), &value, sizeof(T));
+
+        uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < kWords; ++i) {
+            std::atomic_ref<uint64_t>(words_[i]).store(staged[i], std::memory_order_relaxed);
+        }
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Single attempt; returns false if a write was in progress or raced the copy
+    bool TryLoad(T &out) const {
+        uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+
+        std::array<uint64_t, kWords> staged;
+        for (size_t i = 0; i < kWords; ++i) {
+            staged[i] = std::atomic_ref<uint64_t>(words_[i]).load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+
+        std::memcpy(static_cast<void *>(&out), staged.data(), sizeof(T));
+        return true;
+    }
+
+    T Load() const {
+        T out;
+        while (!TryLoad(out)) {
+        }
+        return out;
+    }
+
+    // Number of completed stores
+    uint64_t GetVersion() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+  private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence_{0};
+    alignas(64) mutable std::array<uint64_t, kWords> words_;
+};
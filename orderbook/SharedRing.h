@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Bounded single-writer ring of trivially copyable records that readers on
+// other threads can scan while the writer keeps appending. Records are
+// addressed by their absolute index (0, 1, 2, ...); once the writer laps a
+// record, TryRead reports it as gone instead of returning a torn copy.
+template <typename T> class SharedRing {
+    static_assert(std::is_trivially_copyable_v<T>, "SharedRing records must be trivially copyable");
+
+  public:
+    explicit SharedRing(size_t capacity) : slots_(std::bit_ceil(std::max<size_t>(capacity, 1))), mask_(slots_.size() - 1) {}
+
+    // Writer side; must only be called from one thread
+    void Push(const T &value) {
+        uint64_t index = head_.load(std::memory_order_relaxed);
+        Words staged{};
+        std::memcpy(staged.data(), &value, sizeof(T));
+
+        // Pairs with the reader's acquire fence: a reader that sees any of the
+        // new words also sees a head that marks the old record as overwritten.
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Words &slot = slots_[index & mask_];
+        for (size_t i = 0; i < kWords; ++i) {
+            std::atomic_ref<uint64_t>(slot[i]).store(staged[i], std::memory_order_relaxed);
+        }
+
+        head_.store(index + 1, std::memory_order_release);
+    }
+
+    // Index one past the newest record
+    uint64_t GetHead() const { return head_.load(std::memory_order_acquire); }
+
+    // Oldest index that may still be readable
+    uint64_t GetTail() const {
+        uint64_t head = GetHead();
+        return head > slots_.size() ? head - slots_.size() : 0;
+    }
+
+    size_t GetCapacity() const { return slots_.size(); }
+
+    bool TryRead(uint64_t index, T &out) const {
+        if (index >= GetHead()) {
+            return false;
+        }
+
+        Words staged;
+        const Words &slot = slots_[index & mask_];
+        for (size_t i = 0; i < kWords; ++i) {
+            staged[i] = std::atomic_ref<uint64_t>(const_cast<uint64_t &>(slot[i])).load(std::memory_order_relaxed);
+        }
+
+        // The writer may be filling slot (head & mask) right now, which holds
+        // record head - capacity; anything at or below that may be torn.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (index + slots_.size() <= head_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        std::memcpy(static_cast<void *>(&out), staged.data(), sizeof(T));
+        return true;
+    }
+
+  private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    using Words = std::array<uint64_t, kWords>;
+
+    std::vector<Words> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
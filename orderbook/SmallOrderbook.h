@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <utility>
+
+#include "Data.h"
+
+// Fixed-capacity orderbook holding at most MaxDepth levels per side inline,
+// with no heap allocation. Meant for depth-limited subscriptions (e.g.
+// book.<ticker>.10) where thousands of instruments should fit in cache.
+//
+// Levels that would fall below MaxDepth are dropped. Once a side has been
+// truncated, deleting a level exposes nothing until the exchange resends the
+// deeper levels, which depth-limited feeds do.
+template <size_t MaxDepth> class alignas(64) SmallOrderbook {
+    static_assert(MaxDepth > 0, "SmallOrderbook needs at least one level");
+
+  public:
+    static constexpr size_t kMaxDepth = MaxDepth;
+
+    void UpdateBid(Price price, Volume new_volume) { update_level(price, new_volume, bids_); }
+    void UpdateAsk(Price price, Volume new_volume) { update_level(-1 * price, new_volume, asks_); }
+
+    void LoadSnapshot(std::span<const BookUpdate> bids, std::span<const BookUpdate> asks) {
+        bids_.count = 0;
+        asks_.count = 0;
+        for (const auto &level : bids) {
+            update_level(level.price, level.volume, bids_);
+        }
+        for (const auto &level : asks) {
+            update_level(-1 * level.price, level.volume, asks_);
+        }
+    }
+
+    void PrintBbo() {
+        if (bids_.count > 0) {
+            std::cout << "Bid: " << std::fixed << std::setprecision(4) << bids_.prices[0] << " ";
+        }
+        if (asks_.count > 0) {
+            std::cout << "Ask: " << std::fixed << std::setprecision(4) << (-1 * asks_.prices[0]);
+        }
+
+        std::cout << "\n";
+    }
+
+    std::pair<Price, Price> ReturnBbo() {
+        Price best_bid = bids_.count == 0 ? 0 : bids_.prices[0];
+        Price best_ask = asks_.count == 0 ? 0 : -1 * asks_.prices[0];
+
+        return {best_bid, best_ask};
+    }
+
+    size_t GetDepth(Side side) const { return side == Side::BID ? bids_.count : asks_.count; }
+
+    size_t GetTopLevels(Side side, std::span<BookUpdate> out) const {
+        size_t n = std::min(out.size(), GetDepth(side));
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = GetLevel(side, i);
+        }
+        return n;
+    }
+
+    BookUpdate GetLevel(Side side, size_t level) const {
+        const Levels &levels = side == Side::BID ? bids_ : asks_;
+        Price price = side == Side::BID ? levels.prices[level] : -1 * levels.prices[level];
+        return {price, levels.volumes[level]};
+    }
+
+  private:
+    // Best-first, asks negated so both sides sort descending (as in Orderbook)
+    struct Levels {
+        std::array<Price, MaxDepth> prices;
+        std::array<Volume, MaxDepth> volumes;
+        uint32_t count = 0;
+    };
+
+    static void update_level(Price price, Volume new_volume, Levels &levels) {
+        // Linear scan: for a handful of levels this beats a binary search
+        size_t i = 0;
+        while (i < levels.count && levels.prices[i] > price) {
+            ++i;
+        }
+
+        bool found = i < levels.count && levels.prices[i] == price;
+
+        if (new_volume == 0) {
+            if (found) {
+                for (size_t j = i + 1; j < levels.count; ++j) {
+                    levels.prices[j - 1] = levels.prices[j];
+                    levels.volumes[j - 1] = levels.volumes[j];
+                }
+                --levels.count;
+            }
+            return;
+        }
+
+        if (found) {
+            levels.volumes[i] = new_volume;
+            return;
+        }
+
+        if (i == MaxDepth) {
+            return;
+        }
+
+        size_t last = levels.count < MaxDepth ? levels.count : MaxDepth - 1;
+        for (size_t j = last; j > i; --j) {
+            levels.prices[j] = levels.prices[j - 1];
+            levels.volumes[j] = levels.volumes[j - 1];
+        }
+        levels.prices[i] = price;
+        levels.volumes[i] = new_volume;
+        if (levels.count < MaxDepth) {
+            ++levels.count;
+        }
+    }
+
+    Levels bids_;
+    Levels asks_;
+};
@@ -0,0 +1,87 @@
+#include "AnyOrderbook.h"
+#include "SmallOrderbook.h"
+#include <gtest/gtest.h>
+
+TEST(SmallOrderbookTest, AddOneBidAndAsk) {
+    SmallOrderbook<4> ob;
+    ob.UpdateBid(100.0, 5);
+    ob.UpdateAsk(101.0, 3);
+    auto bbo = ob.ReturnBbo();
+
+    EXPECT_EQ(bbo.first, 100.0);
+    EXPECT_EQ(bbo.second, 101.0);
+}
+
+TEST(SmallOrderbookTest, RemoveBestLevels) {
+    SmallOrderbook<4> ob;
+    ob.UpdateBid(100.0, 5);
+    ob.UpdateBid(99.0, 5);
+    ob.UpdateAsk(101.0, 5);
+    ob.UpdateAsk(102.0, 5);
+    ob.UpdateBid(100.0, 0);
+    ob.UpdateAsk(101.0, 0);
+    auto bbo = ob.ReturnBbo();
+
+    EXPECT_EQ(bbo.first, 99.0);
+    EXPECT_EQ(bbo.second, 102.0);
+    EXPECT_EQ(ob.GetDepth(Side::BID), 1);
+}
+
+TEST(SmallOrderbookTest, DropsLevelsBeyondCapacity) {
+    SmallOrderbook<2> ob;
+    ob.UpdateAsk(101.0, 1);
+    ob.UpdateAsk(102.0, 2);
+    ob.UpdateAsk(103.0, 3);
+    EXPECT_EQ(ob.GetDepth(Side::ASK), 2);
+    EXPECT_EQ(ob.GetLevel(Side::ASK, 1).price, 102.0);
+
+    // A better level pushes the worst one out
+    ob.UpdateAsk(100.0, 4);
+    EXPECT_EQ(ob.GetDepth(Side::ASK), 2);
+    EXPECT_EQ(ob.GetLevel(Side::ASK, 0).price, 100.0);
+    EXPECT_EQ(ob.GetLevel(Side::ASK, 1).price, 101.0);
+}
+
+TEST(SmallOrderbookTest, LoadSnapshotReplacesBook) {
+    SmallOrderbook<10> ob;
+    ob.UpdateBid(105.0, 1);
+
+    std::vector<BookUpdate> bids = {{100.0, 1}, {99.0, 2}};
+    std::vector<BookUpdate> asks = {{101.0, 3}};
+    ob.LoadSnapshot(bids, asks);
+
+    auto bbo = ob.ReturnBbo();
+    EXPECT_EQ(bbo.first, 100.0);
+    EXPECT_EQ(bbo.second, 101.0);
+    EXPECT_EQ(ob.GetDepth(Side::BID), 2);
+}
+
+TEST(SmallOrderbookTest, FitsInCacheLines) {
+    EXPECT_EQ(alignof(SmallOrderbook<kSubscriptionDepth>), 64);
+    EXPECT_EQ(sizeof(SmallOrderbook<kSubscriptionDepth>) % 64, 0);
+}
+
+TEST(SmallOrderbookTest, AnyOrderbookForwardsToSelectedEngine) {
+    for (auto kind : {OrderbookKind::VECTOR, OrderbookKind::TICK_LADDER, OrderbookKind::SMALL}) {
+        AnyOrderbook ob(OrderbookConfig{kind, 0.5});
+        EXPECT_EQ(ob.GetKind(), kind);
+
+        ob.UpdateBid(100.0, 5);
+        ob.UpdateBid(100.5, 5);
+        ob.UpdateAsk(101.0, 3);
+        ob.UpdateBid(100.5, 0);
+        auto bbo = ob.ReturnBbo();
+
+        EXPECT_EQ(bbo.first, 100.0);
+        EXPECT_EQ(bbo.second, 101.0);
+    }
+
+    // A tick ladder needs a tick size to divide by
+    EXPECT_FALSE((OrderbookConfig{OrderbookKind::TICK_LADDER, 0}).IsValid());
+    EXPECT_FALSE((OrderbookConfig{OrderbookKind::TICK_LADDER, -0.5}).IsValid());
+    EXPECT_TRUE((OrderbookConfig{OrderbookKind::SMALL, 0}).IsValid());
+    AnyOrderbook fallback(OrderbookConfig{OrderbookKind::TICK_LADDER, 0});
+    EXPECT_EQ(fallback.GetKind(), OrderbookKind::VECTOR);
+    fallback.UpdateBid(100.0, 5);
+    EXPECT_EQ(fallback.ReturnBbo().first, 100.0);
+}
@@ -0,0 +1,188 @@
+#include "TickLadderOrderbook.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+TickLadderOrderbook::Ladder::Ladder(size_t ladder_size)
+    : slots_(std::bit_ceil(std::max<size_t>(ladder_size, 2)), 0), size_(static_cast<Tick>(slots_.size())), mask_(size_ - 1) {}
+
+Volume TickLadderOrderbook::Ladder::VolumeAt(Tick key) const {
+    if (in_window(key)) {
+        return slot(key);
+    }
+
+    auto it = overflow_.find(key);
+    return it == overflow_.end() ? 0 : it->second;
+}
+
+size_t TickLadderOrderbook::Ladder::CopyTop(std::span<std::pair<Tick, Volume>> keys) const {
+    size_t n = 0;
+    if (Empty()) {
+        return n;
+    }
+
+    for (Tick k = best_; k >= base_ && n < keys.size(); --k) {
+        if (slot(k) != 0) {
+            keys[n++] = {k, slot(k)};
+        }
+    }
+
+    for (auto it = overflow_.rbegin(); it != overflow_.rend() && n < keys.size(); ++it) {
+        keys[n++] = *it;
+    }
+
+    return n;
+}
+
+void TickLadderOrderbook::Ladder::Update(Tick key, Volume new_volume) {
+    if (new_volume == 0) {
+        if (in_window(key)) {
+            slot(key) = 0;
+        } else {
+            overflow_.erase(key);
+        }
+
+        if (key == best_) {
+            best_ = find_best_from(key - 1);
+        }
+        return;
+    }
+
+    if (Empty()) {
+        // Nothing is resting anywhere, so the window can move without evicting.
+        if (!in_window(key)) {
+            base_ = key - size_ / 2;
+        }
+    } else if (key >= base_ + size_) {
+        recenter(key);
+    }
+
+    if (in_window(key)) {
+        slot(key) = new_volume;
+    } else {
+        overflow_[key] = new_volume;
+    }
+
+    if (key > best_) {
+        best_ = key;
+    }
+}
+
+void TickLadderOrderbook::Ladder::Clear() {
+    std::fill(slots_.begin(), slots_.end(), 0);
+    overflow_.clear();
+    best_ = kNoLevel;
+}
+
+Tick TickLadderOrderbook::Ladder::find_best_from(Tick key) {
+    for (Tick k = std::min(key, base_ + size_ - 1); k >= base_; --k) {
+        if (slot(k) != 0) {
+            return k;
+        }
+    }
+
+    // Overflow only ever holds levels below the window, so its largest key is
+    // the next best once the window has been exhausted.
+    if (overflow_.empty()) {
+        return kNoLevel;
+    }
+
+    Tick next_best = overflow_.rbegin()->first;
+    recenter(next_best);
+    return next_best;
+}
+
+void TickLadderOrderbook::Ladder::recenter(Tick center) {
+    Tick new_base = center - size_ / 2;
+    if (new_base == base_) {
+        return;
+    }
+
+    // Evict keys that leave the window before their slots are reused.
+    Tick evict_begin = base_;
+    Tick evict_end = base_ + size_;
+    if (new_base > base_) {
+        evict_end = std::min(evict_end, new_base);
+    } else {
+        evict_begin = std::max(evict_begin, new_base + size_);
+    }
+
+    for (Tick k = evict_begin; k < evict_end; ++k) {
+        Volume &v = slot(k);
+        if (v != 0) {
+            overflow_[k] = v;
+            v = 0;
+        }
+    }
+
+    base_ = new_base;
+
+    auto it = overflow_.lower_bound(base_);
+    while (it != overflow_.end() && it->first < base_ + size_) {
+        slot(it->first) = it->second;
+        it = overflow_.erase(it);
+    }
+}
+
+TickLadderOrderbook::TickLadderOrderbook(Price tick_size, size_t ladder_size) : tick_size_(tick_size), bids_(ladder_size), asks_(ladder_size) {}
+
+Tick TickLadderOrderbook::PriceToTicks(Price price) const { return static_cast<Tick>(std::llround(price / tick_size_)); }
+
+void TickLadderOrderbook::UpdateBid(Price price, Volume new_volume) { bids_.Update(PriceToTicks(price), new_volume); }
+
+void TickLadderOrderbook::UpdateAsk(Price price, Volume new_volume) { asks_.Update(-PriceToTicks(price), new_volume); }
+
+void TickLadderOrderbook::UpdateBidTicks(Tick price_ticks, Volume new_volume) { bids_.Update(price_ticks, new_volume); }
+
+void TickLadderOrderbook::UpdateAskTicks(Tick price_ticks, Volume new_volume) { asks_.Update(-price_ticks, new_volume); }
+
+void TickLadderOrderbook::LoadSnapshot(std::span<const BookUpdate> bids, std::span<const BookUpdate> asks) {
+    bids_.Clear();
+    asks_.Clear();
+
+    for (const auto &level : bids) {
+        bids_.Update(PriceToTicks(level.price), level.volume);
+    }
+    for (const auto &level : asks) {
+        asks_.Update(-PriceToTicks(level.price), level.volume);
+    }
+}
+
+size_t TickLadderOrderbook::GetTopLevels(Side side, std::span<BookUpdate> out) const {
+    // Keys are staged on the stack, so at most kMaxTopLevels are returned
+    constexpr size_t kMaxTopLevels = 64;
+    std::array<std::pair<Tick, Volume>, kMaxTopLevels> keys;
+
+    const Ladder &ladder = side == Side::BID ? bids_ : asks_;
+    size_t n = ladder.CopyTop(std::span(keys).first(std::min(kMaxTopLevels, out.size())));
+
+    for (size_t i = 0; i < n; ++i) {
+        Tick price_ticks = side == Side::BID ? keys[i].first : -keys[i].first;
+        out[i] = {TicksToPrice(price_ticks), keys[i].second};
+    }
+
+    return n;
+}
+
+void TickLadderOrderbook::PrintBbo() {
+
+    if (!bids_.Empty()) {
+        std::cout << "Bid: " << std::fixed << std::setprecision(4) << TicksToPrice(bids_.Best()) << " ";
+    }
+    if (!asks_.Empty()) {
+        std::cout << "Ask: " << std::fixed << std::setprecision(4) << TicksToPrice(-asks_.Best());
+    }
+
+    std::cout << "\n";
+}
+
+std::pair<Price, Price> TickLadderOrderbook::ReturnBbo() {
+    Price best_bid = bids_.Empty() ? 0 : TicksToPrice(bids_.Best());
+    Price best_ask = asks_.Empty() ? 0 : TicksToPrice(-asks_.Best());
+
+    return {best_bid, best_ask};
+}
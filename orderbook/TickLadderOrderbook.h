@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Data.h"
+
+// Orderbook keyed by integer ticks instead of double prices. Each side keeps a
+// power-of-two ring of volumes indexed by tick, centered on the touch, so a
+// level update or delete is a single slot write. Levels that fall outside the
+// ring are parked in a sorted overflow map and pulled back in when the touch
+// moves towards them.
+class TickLadderOrderbook {
+  public:
+    static constexpr size_t kDefaultLadderSize = 4096;
+
+    explicit TickLadderOrderbook(Price tick_size, size_t ladder_size = kDefaultLadderSize);
+
+    void UpdateBid(Price price, Volume new_volume);
+    void UpdateAsk(Price price, Volume new_volume);
+
+    void UpdateBidTicks(Tick price_ticks, Volume new_volume);
+    void UpdateAskTicks(Tick price_ticks, Volume new_volume);
+
+    void LoadSnapshot(std::span<const BookUpdate> bids, std::span<const BookUpdate> asks);
+
+    void PrintBbo();
+    std::pair<Price, Price> ReturnBbo();
+
+    Tick PriceToTicks(Price price) const;
+    Price TicksToPrice(Tick price_ticks) const { return static_cast<Price>(price_ticks) * tick_size_; }
+    Price GetTickSize() const { return tick_size_; }
+
+    size_t GetTopLevels(Side side, std::span<BookUpdate> out) const;
+
+    Volume BidVolumeAt(Price price) const { return bids_.VolumeAt(PriceToTicks(price)); }
+    Volume AskVolumeAt(Price price) const { return asks_.VolumeAt(-PriceToTicks(price)); }
+
+  private:
+    // One side of the book. Keys are stored so that a larger key is always the
+    // better price: bids use +tick, asks use -tick (same trick as Orderbook).
+    class Ladder {
+      public:
+        static constexpr Tick kNoLevel = std::numeric_limits<Tick>::min();
+
+        explicit Ladder(size_t ladder_size);
+
+        void Update(Tick key, Volume new_volume);
+        void Clear();
+
+        bool Empty() const { return best_ == kNoLevel; }
+        Tick Best() const { return best_; }
+        Volume VolumeAt(Tick key) const;
+
+        // Copies up to keys.size() best levels as (key, volume), best first
+        size_t CopyTop(std::span<std::pair<Tick, Volume>> keys) const;
+
+      private:
+        bool in_window(Tick key) const { return key >= base_ && key < base_ + size_; }
+        Volume &slot(Tick key) { return slots_[static_cast<size_t>(key & mask_)]; }
+        const Volume &slot(Tick key) const { return slots_[static_cast<size_t>(key & mask_)]; }
+
+        void recenter(Tick center);
+        Tick find_best_from(Tick key);
+
+        std::vector<Volume> slots_;
+        Tick size_;
+        Tick mask_;
+        Tick base_ = 0;
+        Tick best_ = kNoLevel;
+        std::map<Tick, Volume> overflow_;
+    };
+
+    Price tick_size_;
+    Ladder bids_;
+    Ladder asks_;
+};
@@ -0,0 +1,92 @@
+#include "TickLadderOrderbook.h"
+#include <gtest/gtest.h>
+
+TEST(TickLadderOrderbookTest, AddOneBidAndAsk) {
+    TickLadderOrderbook ob(0.5);
+    ob.UpdateBid(100.0, 5);
+    ob.UpdateAsk(101.0, 3);
+    auto bbo = ob.ReturnBbo();
+
+    EXPECT_EQ(bbo.first, 100.0);
+    EXPECT_EQ(bbo.second, 101.0);
+}
+
+TEST(TickLadderOrderbookTest, RemoveBestBidFallsBackToNextLevel) {
+    TickLadderOrderbook ob(0.5);
+    ob.UpdateBid(100.0, 5);
+    ob.UpdateBid(99.0, 5);
+    ob.UpdateBid(100.0, 0);
+    auto bbo = ob.ReturnBbo();
+
+    EXPECT_EQ(bbo.first, 99.0);
+}
+
+TEST(TickLadderOrderbookTest, RemoveBestAskFallsBackToNextLevel) {
+    TickLadderOrderbook ob(0.5);
+    ob.UpdateAsk(100.0, 5);
+    ob.UpdateAsk(101.0, 5);
+    ob.UpdateAsk(100.0, 0);
+    auto bbo = ob.ReturnBbo();
+
+    EXPECT_EQ(bbo.second, 101.0);
+}
+
+TEST(TickLadderOrderbookTest, RemoveLastLevelEmptiesSide) {
+    TickLadderOrderbook ob(0.5);
+    ob.UpdateBid(100.0, 5);
+    ob.UpdateBid(100.0, 0);
+    auto bbo = ob.ReturnBbo();
+
+    EXPECT_EQ(bbo.first, 0);
+}
+
+TEST(TickLadderOrderbookTest, NoPhantomLevelsFromFloatRounding) {
+    TickLadderOrderbook ob(0.1);
+    ob.UpdateBid(0.1 + 0.2, 5);
+    ob.UpdateBid(0.3, 7);
+
+    EXPECT_EQ(ob.BidVolumeAt(0.3), 7);
+
+    ob.UpdateBid(0.3, 0);
+    EXPECT_EQ(ob.ReturnBbo().first, 0);
+}
+
+TEST(TickLadderOrderbookTest, LevelsOutsideLadderAreKept) {
+    TickLadderOrderbook ob(1.0, 16);
+    ob.UpdateBid(1000.0, 1);
+    ob.UpdateBid(900.0, 2);
+
+    // Touch moves far above the ladder, pushing 1000 and 900 into overflow.
+    ob.UpdateBid(5000.0, 3);
+    EXPECT_EQ(ob.ReturnBbo().first, 5000.0);
+    EXPECT_EQ(ob.BidVolumeAt(1000.0), 1);
+
+    ob.UpdateBid(5000.0, 0);
+    EXPECT_EQ(ob.ReturnBbo().first, 1000.0);
+
+    ob.UpdateBid(1000.0, 0);
+    EXPECT_EQ(ob.ReturnBbo().first, 900.0);
+    EXPECT_EQ(ob.BidVolumeAt(900.0), 2);
+}
+
+TEST(TickLadderOrderbookTest, AskTouchMovesDownThroughLadder) {
+    TickLadderOrderbook ob(1.0, 16);
+    ob.UpdateAsk(1000.0, 1);
+    ob.UpdateAsk(1010.0, 2);
+    ob.UpdateAsk(100.0, 3);
+    EXPECT_EQ(ob.ReturnBbo().second, 100.0);
+
+    ob.UpdateAsk(100.0, 0);
+    EXPECT_EQ(ob.ReturnBbo().second, 1000.0);
+    EXPECT_EQ(ob.AskVolumeAt(1010.0), 2);
+}
+
+TEST(TickLadderOrderbookTest, TickUpdatesMatchPriceUpdates) {
+    TickLadderOrderbook ob(0.5);
+    ob.UpdateBidTicks(ob.PriceToTicks(50113.5), 0.4);
+    ob.UpdateAskTicks(ob.PriceToTicks(50126.0), 0.4);
+    auto bbo = ob.ReturnBbo();
+
+    EXPECT_EQ(bbo.first, 50113.5);
+    EXPECT_EQ(bbo.second, 50126.0);
+}
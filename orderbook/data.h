@@ -1,10 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <tuple>
 #include <vector>
 
 using Price = double;
 using Volume = double;
+using Tick = int64_t;
+
+enum class Side : uint8_t { BID = 0, ASK = 1 };
 
 struct ReceivedData {
     uint32_t message_type;
@@ -3,40 +3,86 @@
 #include <libkern/OSByteOrder.h>
 #include <sys/socket.h>
 
-template <typename T> void Orderbook::update_level(Price price, Volume new_volume, T &orders_list) {
+template <typename T> void Orderbook::update_level(Price price, Volume new_volume, T &orders_list, DepthCache &depth_cache) {
     auto it = std::lower_bound(orders_list.begin(), orders_list.end(), price, [](const auto &a, double b) { return a.first > b; });
+    size_t index = it - orders_list.begin();
 
     if (it != orders_list.end() && it->first == price) {
+        depth_cache.total_volume += new_volume - it->second;
         it->second = new_volume;
     } else {
+        depth_cache.total_volume += new_volume;
         orders_list.insert(it, {price, new_volume});
     }
+
+    depth_cache.valid_levels = std::min(depth_cache.valid_levels, index);
 }
 
-template <typename T> void Orderbook::delete_level(Price price, T &orders_list) {
+template <typename T> void Orderbook::delete_level(Price price, T &orders_list, DepthCache &depth_cache) {
     auto it = std::lower_bound(orders_list.begin(), orders_list.end(), price, [](const auto &a, double b) { return a.first > b; });
 
-    if (it == orders_list.end()) {
+    if (it == orders_list.end() || it->first != price) {
         return;
     }
 
+    depth_cache.total_volume = orders_list.size() == 1 ? 0 : depth_cache.total_volume - it->second;
+    depth_cache.valid_levels = std::min(depth_cache.valid_levels, static_cast<size_t>(it - orders_list.begin()));
     orders_list.erase(it);
 }
 
+template <typename T> void Orderbook::load_levels(std::span<const BookUpdate> levels, Price sign, T &orders_list, DepthCache &depth_cache) {
+    orders_list.clear();
+    orders_list.reserve(levels.size());
+    depth_cache.total_volume = 0;
+    depth_cache.valid_levels = 0;
+
+    for (const auto &level : levels) {
+        if (level.volume == 0) {
+            continue;
+        }
+        orders_list.push_back({sign * level.price, level.volume});
+        depth_cache.total_volume += level.volume;
+    }
+
+    auto better = [](const auto &a, const auto &b) { return a.first > b.first; };
+    auto not_better = [](const auto &a, const auto &b) { return a.first <= b.first; };
+
+    // Exchange snapshots are already best-first; only pay for a sort (and
+    // duplicate removal, keeping the last occurrence) when they are not.
+    if (std::adjacent_find(orders_list.begin(), orders_list.end(), not_better) != orders_list.end()) {
+        std::stable_sort(orders_list.begin(), orders_list.end(), better);
+        auto last = orders_list.begin();
+        for (auto it = orders_list.begin() + 1; it != orders_list.end(); ++it) {
+            if (it->first == last->first) {
+                depth_cache.total_volume -= last->second;
+                *last = *it;
+            } else {
+                *++last = *it;
+            }
+        }
+        orders_list.erase(last + 1, orders_list.end());
+    }
+}
+
+void Orderbook::LoadSnapshot(std::span<const BookUpdate> bids, std::span<const BookUpdate> asks) {
+    load_levels(bids, 1, bids_, bid_cache_);
+    load_levels(asks, -1, asks_, ask_cache_);
+}
+
 void Orderbook::UpdateBid(Price price, Volume new_volume) {
     if (new_volume == 0) {
-        delete_level(price, bids_);
+        delete_level(price, bids_, bid_cache_);
     } else {
-        update_level(price, new_volume, bids_);
+        update_level(price, new_volume, bids_, bid_cache_);
     }
 }
 
 void Orderbook::UpdateAsk(Price price, Volume new_volume) {
 
     if (new_volume == 0) {
-        delete_level(-1 * price, asks_);
+        delete_level(-1 * price, asks_, ask_cache_);
     } else {
-        update_level(-1 * price, new_volume, asks_);
+        update_level(-1 * price, new_volume, asks_, ask_cache_);
     }
 }
 
@@ -57,4 +103,126 @@ std::pair<Price, Price> Orderbook::ReturnBbo() {
     Price best_ask = asks_.empty() ? 0 : -1 * asks_.begin()->first;
 
     return {best_bid, best_ask};
+}
+
+void Orderbook::refresh_cache(Side side, size_t levels_needed) const {
+    const auto &orders_list = levels(side);
+    DepthCache &depth_cache = cache(side);
+
+    levels_needed = std::min(levels_needed, orders_list.size());
+    if (depth_cache.valid_levels >= levels_needed) {
+        return;
+    }
+
+    if (depth_cache.cumulative_volume.size() < orders_list.size()) {
+        depth_cache.cumulative_volume.resize(orders_list.size());
+        depth_cache.cumulative_notional.resize(orders_list.size());
+    }
+
+    size_t i = depth_cache.valid_levels;
+    Volume volume = i == 0 ? 0 : depth_cache.cumulative_volume[i - 1];
+    double notional = i == 0 ? 0 : depth_cache.cumulative_notional[i - 1];
+
+    for (; i < levels_needed; ++i) {
+        volume += orders_list[i].second;
+        notional += orders_list[i].second * level_price(side, orders_list[i]);
+        depth_cache.cumulative_volume[i] = volume;
+        depth_cache.cumulative_notional[i] = notional;
+    }
+
+    depth_cache.valid_levels = levels_needed;
+}
+
+size_t Orderbook::GetTopLevels(Side side, size_t n, std::vector<BookUpdate> &out) const {
+    const auto &orders_list = levels(side);
+    n = std::min(n, orders_list.size());
+
+    out.clear();
+    for (size_t i = 0; i < n; ++i) {
+        out.push_back({level_price(side, orders_list[i]), orders_list[i].second});
+    }
+
+    return n;
+}
+
+size_t Orderbook::GetTopLevels(Side side, std::span<BookUpdate> out) const {
+    const auto &orders_list = levels(side);
+    size_t n = std::min(out.size(), orders_list.size());
+
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = {level_price(side, orders_list[i]), orders_list[i].second};
+    }
+
+    return n;
+}
+
+Volume Orderbook::GetCumulativeVolume(Side side, size_t level) const {
+    const auto &orders_list = levels(side);
+    if (orders_list.empty()) {
+        return 0;
+    }
+
+    level = std::min(level, orders_list.size() - 1);
+    refresh_cache(side, level + 1);
+    return cache(side).cumulative_volume[level];
+}
+
+Price Orderbook::GetMicroprice() const {
+    if (bids_.empty() || asks_.empty()) {
+        return 0;
+    }
+
+    Price best_bid = bids_.front().first;
+    Price best_ask = -1 * asks_.front().first;
+    Volume bid_volume = bids_.front().second;
+    Volume ask_volume = asks_.front().second;
+
+    return (best_bid * ask_volume + best_ask * bid_volume) / (bid_volume + ask_volume);
+}
+
+double Orderbook::GetImbalance(size_t depth) const {
+    if (depth == 0) {
+        return 0;
+    }
+
+    Volume bid_volume = GetCumulativeVolume(Side::BID, depth - 1);
+    Volume ask_volume = GetCumulativeVolume(Side::ASK, depth - 1);
+    Volume total = bid_volume + ask_volume;
+
+    return total == 0 ? 0 : (bid_volume - ask_volume) / total;
+}
+
+std::optional<Price> Orderbook::GetVwapToNotional(Side side, double notional) const {
+    const auto &orders_list = levels(side);
+    if (notional <= 0 || orders_list.empty()) {
+        return std::nullopt;
+    }
+
+    DepthCache &depth_cache = cache(side);
+
+    // Extend the prefix sums only as far as needed to cover the notional.
+    size_t level;
+    if (depth_cache.valid_levels > 0 && depth_cache.cumulative_notional[depth_cache.valid_levels - 1] >= notional) {
+        auto begin = depth_cache.cumulative_notional.begin();
+        level = std::lower_bound(begin, begin + depth_cache.valid_levels, notional) - begin;
+    } else {
+        level = depth_cache.valid_levels;
+        while (level < orders_list.size()) {
+            refresh_cache(side, level + 1);
+            if (depth_cache.cumulative_notional[level] >= notional) {
+                break;
+            }
+            ++level;
+        }
+
+        if (level == orders_list.size()) {
+            return std::nullopt;
+        }
+    }
+
+    Volume volume_before = level == 0 ? 0 : depth_cache.cumulative_volume[level - 1];
+    double notional_before = level == 0 ? 0 : depth_cache.cumulative_notional[level - 1];
+    Volume filled_volume = volume_before + (notional - notional_before) / level_price(side, orders_list[level]);
+
+    return notional / filled_volume;
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <optional>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -15,14 +17,50 @@ class Orderbook {
     void UpdateBid(Price price, Volume new_volume);
     void UpdateAsk(Price price, Volume new_volume);
 
+    // Replaces both sides with the given levels. Levels are expected best-first
+    // (as the exchange sends them) and fall back to a sort otherwise; zero
+    // volume levels are skipped and existing capacity is reused.
+    void LoadSnapshot(std::span<const BookUpdate> bids, std::span<const BookUpdate> asks);
+
     void PrintBbo();
     std::pair<Price, Price> ReturnBbo();
 
+    // Depth analytics. Running totals are kept up to date by UpdateBid/UpdateAsk;
+    // per-level cumulative sums are only recomputed from the first level that
+    // changed, so queries cost O(levels touched) rather than a full rescan.
+    size_t GetDepth(Side side) const { return side == Side::BID ? bids_.size() : asks_.size(); }
+    size_t GetTopLevels(Side side, size_t n, std::vector<BookUpdate> &out) const;
+    size_t GetTopLevels(Side side, std::span<BookUpdate> out) const;
+    Volume GetTotalVolume(Side side) const { return cache(side).total_volume; }
+    Volume GetCumulativeVolume(Side side, size_t level) const;
+    Price GetMicroprice() const;
+    double GetImbalance(size_t depth = 1) const;
+    std::optional<Price> GetVwapToNotional(Side side, double notional) const;
+
   private:
+    // Prefix sums over a side, valid for the first valid_levels entries.
+    struct DepthCache {
+        std::vector<Volume> cumulative_volume;
+        std::vector<double> cumulative_notional;
+        size_t valid_levels = 0;
+        Volume total_volume = 0;
+    };
+
     std::vector<std::pair<Price, Volume>> bids_;
     std::vector<std::pair<Price, Volume>> asks_;
 
-    template <typename T> void update_level(Price price, Volume new_volume, T &orders_list);
+    mutable DepthCache bid_cache_;
+    mutable DepthCache ask_cache_;
+
+    template <typename T> void update_level(Price price, Volume new_volume, T &orders_list, DepthCache &depth_cache);
+
+    template <typename T> void delete_level(Price price, T &orders_list, DepthCache &depth_cache);
+
+    template <typename T> void load_levels(std::span<const BookUpdate> levels, Price sign, T &orders_list, DepthCache &depth_cache);
+
+    const std::vector<std::pair<Price, Volume>> &levels(Side side) const { return side == Side::BID ? bids_ : asks_; }
+    DepthCache &cache(Side side) const { return side == Side::BID ? bid_cache_ : ask_cache_; }
+    static Price level_price(Side side, const std::pair<Price, Volume> &level) { return side == Side::BID ? level.first : -1 * level.first; }
 
-    template <typename T> void delete_level(Price price, T &orders_list);
-};
\ No newline at end of file
+    void refresh_cache(Side side, size_t levels_needed) const;
+};